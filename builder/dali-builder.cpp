@@ -24,22 +24,45 @@
 //
 //       and edit layout.json in a text editor saving to trigger the reload
 //
+//  - with --incremental only the actors whose description changed are
+//    updated, added or removed on a reload instead of recreating them all
+//
+//  - with --compile output.dlb the layout is precompiled to the binary form
+//    loaded by shared/compiled-layout.h, and --benchmark compares building
+//    the demo layouts from JSON and from their compiled form
+//
 //------------------------------------------------------------------------------
 
 #include <dali/dali.h>
 #include <dali-toolkit/dali-toolkit.h>
 #include <dali-toolkit/devel-api/builder/builder.h>
 #include <dali-toolkit/devel-api/builder/tree-node.h>
+#include <dali-toolkit/devel-api/builder/json-parser.h>
+#include <dali/devel-api/adaptor-framework/event-thread-callback.h>
+#include <dali/devel-api/threading/mutex.h>
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <streambuf>
 
 #include "sys/stat.h"
+#include <sys/inotify.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
 #include <ctime>
+#include <set>
+#include <vector>
 
 #include <dali/integration-api/debug.h>
+#include <dirent.h>
+
+#include "shared/compiled-layout.h"
+#include "shared/utility.h"
 
 #define TOKEN_STRING(x) #x
 
@@ -73,12 +96,313 @@ std::string ReplaceQuotes(const std::string &single_quoted)
   return s;
 }
 
+// Images and includes referenced from a layout; they trigger a reload too
+const char* REFERENCED_FILE_EXTENSIONS[] = { ".json", ".png", ".jpg", ".jpeg", ".gif", ".bmp", ".svg", ".ktx", ".astc", ".obj", ".mtl" };
+const unsigned int NUMBER_OF_REFERENCED_FILE_EXTENSIONS( sizeof( REFERENCED_FILE_EXTENSIONS ) / sizeof( REFERENCED_FILE_EXTENSIONS[0] ) );
+
+// Wait for the rest of a multi-file save before reloading
+const unsigned int RELOAD_DEBOUNCE_MILLISECONDS( 10 );
+
+// Poll interval when inotify is not available
+const unsigned int POLL_INTERVAL_MILLISECONDS( 500 );
+
+// Number of times each layout is built by --benchmark
+const unsigned int BENCHMARK_ITERATIONS( 20 );
+
+std::string GetFileContents(const std::string &fn)
+{
+  std::ifstream t(fn.c_str());
+  return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+}
+
+std::vector<std::string> GetLayoutFiles(const std::string &directory)
+{
+  std::vector<std::string> files;
+  if(DIR* dir = opendir(directory.c_str()))
+  {
+    while(struct dirent* entry = readdir(dir))
+    {
+      std::string name(entry->d_name);
+      if(name.size() > 5 && 0 == name.compare(name.size() - 5, 5, ".json"))
+      {
+        files.push_back(directory + name);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+void RemoveChildren(Actor actor)
+{
+  while(actor.GetChildCount())
+  {
+    actor.Remove(actor.GetChildAt(0));
+  }
+}
+
+std::string DirectoryOf(const std::string &path)
+{
+  std::string::size_type slash = path.find_last_of('/');
+  if(slash == std::string::npos)
+  {
+    return ".";
+  }
+  return slash == 0 ? std::string("/") : path.substr(0, slash);
+}
+
+std::string BaseNameOf(const std::string &path)
+{
+  std::string::size_type slash = path.find_last_of('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+void ReplaceAll(std::string &s, const std::string &from, const std::string &to)
+{
+  for(std::string::size_type pos = s.find(from); pos != std::string::npos; pos = s.find(from, pos + to.size()))
+  {
+    s.replace(pos, from.size(), to);
+  }
+}
+
+/**
+ * Finds the quoted strings in a layout which look like file names, substituting the demo directory constants.
+ */
+std::vector<std::string> FindReferencedFiles(const std::string &json, const std::string &jsonPath)
+{
+  std::vector<std::string> files;
+
+  std::string::size_type begin = json.find('"');
+  while(begin != std::string::npos)
+  {
+    std::string::size_type end = json.find('"', begin + 1);
+    if(end == std::string::npos)
+    {
+      break;
+    }
+
+    std::string value(json, begin + 1, end - begin - 1);
+    for(unsigned int i = 0; i < NUMBER_OF_REFERENCED_FILE_EXTENSIONS; ++i)
+    {
+      std::string extension(REFERENCED_FILE_EXTENSIONS[i]);
+      if(value.size() > extension.size() && 0 == value.compare(value.size() - extension.size(), extension.size(), extension))
+      {
+        ReplaceAll(value, "{" TOKEN_STRING(DEMO_IMAGE_DIR) "}", DEMO_IMAGE_DIR);
+        ReplaceAll(value, "{" TOKEN_STRING(DEMO_MODEL_DIR) "}", DEMO_MODEL_DIR);
+        ReplaceAll(value, "{" TOKEN_STRING(DEMO_SCRIPT_DIR) "}", DEMO_SCRIPT_DIR);
+        if(value.find('{') == std::string::npos && value != jsonPath)
+        {
+          files.push_back(value);
+        }
+        break;
+      }
+    }
+
+    begin = json.find('"', end + 1);
+  }
+
+  return files;
+}
+
+/**
+ * Writes a string as a quoted json string.
+ */
+void WriteJsonString(const char* value, std::ostream &output)
+{
+  output << '"';
+  for(const char* c = value; c && *c; ++c)
+  {
+    switch(*c)
+    {
+      case '"':  output << "\\\""; break;
+      case '\\': output << "\\\\"; break;
+      case '\n': output << "\\n";  break;
+      case '\t': output << "\\t";  break;
+      default:   output << *c;     break;
+    }
+  }
+  output << '"';
+}
+
+/**
+ * Writes a parsed json node back out in compact form, so nodes can be compared and handed back to the builder.
+ */
+void WriteJson(const TreeNode &node, std::ostream &output)
+{
+  switch(node.GetType())
+  {
+    case TreeNode::OBJECT:
+    case TreeNode::ARRAY:
+    {
+      const bool isObject = node.GetType() == TreeNode::OBJECT;
+      output << (isObject ? '{' : '[');
+      bool first = true;
+      for(TreeNode::ConstIterator iter = node.CBegin(); iter != node.CEnd(); ++iter)
+      {
+        if(!first)
+        {
+          output << ',';
+        }
+        first = false;
+
+        if(isObject)
+        {
+          WriteJsonString((*iter).first, output);
+          output << ':';
+        }
+        WriteJson((*iter).second, output);
+      }
+      output << (isObject ? '}' : ']');
+      break;
+    }
+    case TreeNode::STRING:
+    {
+      WriteJsonString(node.GetString(), output);
+      break;
+    }
+    case TreeNode::INTEGER:
+    {
+      output << node.GetInteger();
+      break;
+    }
+    case TreeNode::FLOAT:
+    {
+      output << node.GetFloat();
+      break;
+    }
+    case TreeNode::BOOLEAN:
+    {
+      output << (node.GetBoolean() ? "true" : "false");
+      break;
+    }
+    case TreeNode::IS_NULL:
+    default:
+    {
+      output << "null";
+      break;
+    }
+  }
+}
+
+std::string ToJson(const TreeNode &node)
+{
+  std::ostringstream output;
+  output.precision(9);
+  WriteJson(node, output);
+  return output.str();
+}
+
+std::string GetActorName(const TreeNode &node)
+{
+  const TreeNode* name = node.GetChild("name");
+  return (name && name->GetType() == TreeNode::STRING) ? std::string(name->GetString()) : std::string();
+}
+
+typedef std::map<std::string, const TreeNode*> KeyedNodes;
+
+/**
+ * Keys the elements of an actor array by name, or by position for unnamed actors.
+ * @return false if two elements have the same key, so they cannot be told apart
+ */
+bool GetKeyedActors(const TreeNode* actors, KeyedNodes &keyed, std::vector<std::string> &order)
+{
+  if(!actors)
+  {
+    return true;
+  }
+
+  unsigned int index = 0;
+  for(TreeNode::ConstIterator iter = actors->CBegin(); iter != actors->CEnd(); ++iter, ++index)
+  {
+    const TreeNode &node = (*iter).second;
+    std::string key = GetActorName(node);
+    if(key.empty())
+    {
+      std::ostringstream position;
+      position << '#' << index;
+      key = position.str();
+    }
+
+    if(!keyed.insert(std::make_pair(key, &node)).second)
+    {
+      return false;
+    }
+    order.push_back(key);
+  }
+
+  return true;
+}
+
+/**
+ * Whether the keys in both the previous and the current actor arrays are in the same order in each.
+ * Only added actors are moved into place, so a reordered array has to be built again.
+ */
+bool SameRelativeOrder(const std::vector<std::string> &previousOrder, const KeyedNodes &previous,
+                       const std::vector<std::string> &currentOrder, const KeyedNodes &current)
+{
+  std::vector<std::string> kept;
+  for(std::vector<std::string>::const_iterator iter = previousOrder.begin(); iter != previousOrder.end(); ++iter)
+  {
+    if(current.find(*iter) != current.end())
+    {
+      kept.push_back(*iter);
+    }
+  }
+
+  std::vector<std::string>::const_iterator next = kept.begin();
+  for(std::vector<std::string>::const_iterator iter = currentOrder.begin(); iter != currentOrder.end(); ++iter)
+  {
+    if(previous.find(*iter) != previous.end() && *next++ != *iter)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Whether everything apart from the stage section (constants, styles, templates, animations...) is unchanged.
+ */
+bool SameSectionsExceptStage(const TreeNode &previous, const TreeNode &current)
+{
+  if(previous.Size() != current.Size())
+  {
+    return false;
+  }
+
+  for(TreeNode::ConstIterator iter = current.CBegin(); iter != current.CEnd(); ++iter)
+  {
+    const char* name = (*iter).first;
+    if(name && std::string(name) == "stage")
+    {
+      continue;
+    }
+
+    const TreeNode* section = name ? previous.GetChild(name) : NULL;
+    if(!section || ToJson(*section) != ToJson((*iter).second))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 } // anon namespace
 
 
 //------------------------------------------------------------------------------
 //
+// Watches the layout file and the files it references with inotify.
 //
+// A thread blocks on the inotify descriptor and wakes the main loop through an
+// EventThreadCallback as soon as a watched file is written, so a save is picked
+// up within a frame instead of on the next poll. Directories are watched rather
+// than files so that editors which save by renaming a temporary file are seen.
+// A watched directory which is itself deleted or moved away is watched again by
+// path, retried every POLL_INTERVAL_MILLISECONDS until it reappears.
 //
 //------------------------------------------------------------------------------
 class FileWatcher
@@ -86,21 +410,83 @@ class FileWatcher
 public:
   FileWatcher(void);
   ~FileWatcher(void);
-  explicit FileWatcher(const std::string &fn): mLastTime(0) { SetFilename(fn) ; };
 
   void SetFilename(const std::string &fn);
   std::string GetFilename();
 
+  /**
+   * Sets the files referenced by the layout (images, includes) which also trigger a reload when changed.
+   */
+  void SetReferencedFiles(const std::vector<std::string> &files);
+
+  /**
+   * Starts watching. The callback is called on the event thread whenever a watched file may have changed.
+   * @return false if inotify is not available, in which case FileHasChanged() has to be polled
+   */
+  bool Start(CallbackBase* callback);
+
   bool FileHasChanged(void);
   std::string GetFileContents(void) { return GetFileContents(mstringPath) ; };
 
 private:
-  // compiler does
-  // FileWatcher(const FileWatcher&);
-  // FileWatcher &operator=(const FileWatcher &);
+  FileWatcher(const FileWatcher&);
+  FileWatcher &operator=(const FileWatcher &);
+
+  /**
+   * The state of a file when last checked; nanosecond modification times catch quick successive saves.
+   */
+  struct FileState
+  {
+    FileState() : mSeconds(0), mNanoSeconds(0), mSize(0), mExists(false) {}
+
+    bool operator!=(const FileState& rhs) const
+    {
+      return mSeconds != rhs.mSeconds || mNanoSeconds != rhs.mNanoSeconds || mSize != rhs.mSize || mExists != rhs.mExists;
+    }
+
+    time_t mSeconds;
+    long mNanoSeconds;
+    off_t mSize;
+    bool mExists;
+  };
+
+  typedef std::map<std::string, FileState> FileStates;
+
+  static FileState GetFileState(const std::string &fn)
+  {
+    FileState state;
+    struct stat buf;
+    if(0 == stat(fn.c_str(), &buf))
+    {
+      state.mSeconds = buf.st_mtim.tv_sec;
+      state.mNanoSeconds = buf.st_mtim.tv_nsec;
+      state.mSize = buf.st_size;
+      state.mExists = true;
+    }
+    return state;
+  }
+
+  void UpdateWatches();
+  void AddWatch(const std::string &directory);
+  void RemoveWatch(int wd);
+  bool RetryMissingWatches();
+  static void* WatchThread(void* data);
+  void WatchLoop();
 
-  std::time_t mLastTime;
   std::string mstringPath;
+  std::vector<std::string> mReferencedFiles;
+  FileStates mFileStates;
+
+  Mutex mMutex;                                ///< Guards the members below, which the watch thread reads
+  std::map<int, std::string> mWatchedDirectories; ///< inotify watch descriptor to directory
+  std::set<std::string> mMissingDirectories;      ///< Directories to watch which do not exist at the moment
+  std::set<std::string> mWatchedFiles;
+
+  EventThreadCallback* mTrigger;
+  pthread_t mThread;
+  int mInotifyFd;
+  int mStopPipe[2];
+  bool mThreadStarted;
 
   std::string GetFileContents(const std::string &fn)
   {
@@ -109,43 +495,74 @@ private:
   };
 };
 
-FileWatcher::FileWatcher(void) : mLastTime(0)
+FileWatcher::FileWatcher(void)
+: mTrigger(NULL),
+  mInotifyFd(-1),
+  mThreadStarted(false)
 {
+  mStopPipe[0] = mStopPipe[1] = -1;
 }
 
 bool FileWatcher::FileHasChanged(void)
 {
-  struct stat buf;
-
-  if(0 != stat(mstringPath.c_str(), &buf))
+  FileState mainState = GetFileState(mstringPath);
+  if(!mainState.mExists)
   {
     DALI_LOG_WARNING("File does not exist '%s'\n", mstringPath.c_str());
     return false;
   }
-  else
+
+  FileStates states;
+  states[mstringPath] = mainState;
+  for(std::vector<std::string>::const_iterator iter = mReferencedFiles.begin(); iter != mReferencedFiles.end(); ++iter)
   {
-    if(buf.st_mtime > mLastTime)
-    {
-      mLastTime = buf.st_mtime;
-      return true;
-    }
-    else
-    {
-      mLastTime = buf.st_mtime;
-      return false;
-    }
+    states[*iter] = GetFileState(*iter);
+  }
+
+  bool changed = states.size() != mFileStates.size();
+  for(FileStates::const_iterator iter = states.begin(); !changed && iter != states.end(); ++iter)
+  {
+    FileStates::const_iterator previous = mFileStates.find(iter->first);
+    changed = previous == mFileStates.end() || previous->second != iter->second;
   }
 
-  return false;
+  mFileStates.swap(states);
+  return changed;
 }
 
 FileWatcher::~FileWatcher()
 {
+  if(mThreadStarted)
+  {
+    // Wake the watch thread up so it can exit
+    char stop = 0;
+    if(write(mStopPipe[1], &stop, 1) != 1)
+    {
+      DALI_LOG_WARNING("Could not stop the file watch thread\n");
+    }
+    pthread_join(mThread, NULL);
+  }
+
+  if(mInotifyFd >= 0)
+  {
+    while(!mWatchedDirectories.empty())
+    {
+      RemoveWatch(mWatchedDirectories.begin()->first);
+    }
+    close(mInotifyFd);
+  }
+  if(mStopPipe[0] >= 0)
+  {
+    close(mStopPipe[0]);
+    close(mStopPipe[1]);
+  }
+  delete mTrigger;
 }
 
 void FileWatcher::SetFilename(const std::string &fn)
 {
   mstringPath = fn;
+  UpdateWatches();
 }
 
 std::string FileWatcher::GetFilename(void)
@@ -153,6 +570,191 @@ std::string FileWatcher::GetFilename(void)
   return mstringPath;
 }
 
+void FileWatcher::SetReferencedFiles(const std::vector<std::string> &files)
+{
+  mReferencedFiles = files;
+  UpdateWatches();
+}
+
+bool FileWatcher::Start(CallbackBase* callback)
+{
+  mTrigger = new EventThreadCallback(callback);
+
+  mInotifyFd = inotify_init();
+  if(mInotifyFd < 0 || 0 != pipe(mStopPipe))
+  {
+    DALI_LOG_WARNING("inotify is not available, polling '%s'\n", mstringPath.c_str());
+    return false;
+  }
+
+  UpdateWatches();
+
+  mThreadStarted = (0 == pthread_create(&mThread, NULL, &FileWatcher::WatchThread, this));
+  return mThreadStarted;
+}
+
+void FileWatcher::UpdateWatches()
+{
+  if(mInotifyFd < 0)
+  {
+    return;
+  }
+
+  std::vector<std::string> files(mReferencedFiles);
+  files.push_back(mstringPath);
+
+  Mutex::ScopedLock lock(mMutex);
+  mWatchedFiles.clear();
+  std::set<std::string> directories;
+  for(std::vector<std::string>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
+  {
+    std::string directory = DirectoryOf(*iter);
+    mWatchedFiles.insert(directory + "/" + BaseNameOf(*iter));
+    directories.insert(directory);
+  }
+
+  // Stop watching the directories which no longer hold any watched file
+  for(std::map<int, std::string>::iterator iter = mWatchedDirectories.begin(); iter != mWatchedDirectories.end(); )
+  {
+    const int wd = (iter++)->first;
+    if(directories.find(mWatchedDirectories[wd]) == directories.end())
+    {
+      RemoveWatch(wd);
+    }
+  }
+  mMissingDirectories.clear();
+
+  for(std::set<std::string>::const_iterator iter = directories.begin(); iter != directories.end(); ++iter)
+  {
+    AddWatch(*iter);
+  }
+}
+
+// Called with mMutex locked. Adding a watch for an already watched directory returns the same descriptor.
+void FileWatcher::AddWatch(const std::string &directory)
+{
+  int wd = inotify_add_watch(mInotifyFd, directory.c_str(),
+                             IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF);
+  if(wd >= 0)
+  {
+    mWatchedDirectories[wd] = directory;
+    mMissingDirectories.erase(directory);
+  }
+  else
+  {
+    mMissingDirectories.insert(directory);
+  }
+}
+
+// Called with mMutex locked, or once the watch thread has stopped
+void FileWatcher::RemoveWatch(int wd)
+{
+  // Fails harmlessly if the kernel has already dropped the watch, e.g. after IN_DELETE_SELF
+  inotify_rm_watch(mInotifyFd, wd);
+  mWatchedDirectories.erase(wd);
+}
+
+// Called with mMutex locked. Returns whether any directory has reappeared.
+bool FileWatcher::RetryMissingWatches()
+{
+  const std::set<std::string> missing(mMissingDirectories);
+  for(std::set<std::string>::const_iterator iter = missing.begin(); iter != missing.end(); ++iter)
+  {
+    AddWatch(*iter);
+  }
+  return mMissingDirectories.size() < missing.size();
+}
+
+void* FileWatcher::WatchThread(void* data)
+{
+  static_cast<FileWatcher*>(data)->WatchLoop();
+  return NULL;
+}
+
+void FileWatcher::WatchLoop()
+{
+  char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+  struct pollfd fds[2];
+  fds[0].fd = mInotifyFd;
+  fds[0].events = POLLIN;
+  fds[1].fd = mStopPipe[0];
+  fds[1].events = POLLIN;
+
+  for(;;)
+  {
+    int timeout = -1;
+    {
+      Mutex::ScopedLock lock(mMutex);
+      timeout = mMissingDirectories.empty() ? -1 : static_cast<int>(POLL_INTERVAL_MILLISECONDS);
+    }
+
+    fds[0].revents = fds[1].revents = 0;
+    if(poll(fds, 2, timeout) < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+
+    if(fds[1].revents)
+    {
+      break;
+    }
+
+    bool relevant = false;
+    if(!fds[0].revents)
+    {
+      // Timed out waiting for a missing directory; its files changed if it has come back
+      Mutex::ScopedLock lock(mMutex);
+      relevant = RetryMissingWatches();
+    }
+    else
+    {
+      ssize_t length = read(mInotifyFd, buffer, sizeof(buffer));
+      if(length <= 0)
+      {
+        continue;
+      }
+
+      Mutex::ScopedLock lock(mMutex);
+      std::set<std::string> replacedDirectories;
+      for(char* ptr = buffer; ptr < buffer + length; )
+      {
+        const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+        std::map<int, std::string>::const_iterator directory = mWatchedDirectories.find(event->wd);
+        if(directory != mWatchedDirectories.end())
+        {
+          if(event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+          {
+            // The watch follows the directory's inode; watch whatever is at its path now instead
+            replacedDirectories.insert(directory->second);
+            RemoveWatch(event->wd);
+            relevant = true;
+          }
+          else if(event->len && mWatchedFiles.find(directory->second + "/" + event->name) != mWatchedFiles.end())
+          {
+            relevant = true;
+          }
+        }
+        ptr += sizeof(struct inotify_event) + event->len;
+      }
+
+      for(std::set<std::string>::const_iterator iter = replacedDirectories.begin(); iter != replacedDirectories.end(); ++iter)
+      {
+        AddWatch(*iter);
+      }
+    }
+
+    if(relevant)
+    {
+      mTrigger->Trigger();
+    }
+  }
+}
+
 
 //------------------------------------------------------------------------------
 //
@@ -162,7 +764,14 @@ std::string FileWatcher::GetFilename(void)
 class ExampleApp : public ConnectionTracker
 {
 public:
-  ExampleApp(Application &app) : mApp(app)
+  ExampleApp(Application &app)
+  : mApp(app),
+    mIncremental(false),
+    mBenchmark(false),
+    mPropertyUpdates(0),
+    mAdditions(0),
+    mRemovals(0),
+    mReplacements(0)
   {
     app.InitSignal().Connect(this, &ExampleApp::Create);
 
@@ -173,9 +782,36 @@ public:
 public:
   void SetJSONFilename(std::string const &fn) { fw.SetFilename(fn) ; };
 
+  /**
+   * In incremental mode a save only updates, adds or removes the actors which changed,
+   * falling back to a full reload when anything outside the stage section is edited.
+   */
+  void SetIncremental(bool incremental) { mIncremental = incremental; };
+
+  /**
+   * In benchmark mode every layout of the demo script directory is built from JSON and,
+   * where it can be compiled, from its compiled form; the times are printed and the app quits.
+   */
+  void SetBenchmark(bool benchmark) { mBenchmark = benchmark; };
+
   void Create(Application& app)
   {
-    mTimer = Timer::New( 500 ); // ms
+    if( mBenchmark )
+    {
+      RunLayoutBenchmark();
+      mApp.Quit();
+      return;
+    }
+
+    if( fw.Start( MakeCallback( this, &ExampleApp::OnFileChanged ) ) )
+    {
+      // Coalesces the events of one save; the first load happens on the first tick
+      mTimer = Timer::New( RELOAD_DEBOUNCE_MILLISECONDS );
+    }
+    else
+    {
+      mTimer = Timer::New( POLL_INTERVAL_MILLISECONDS );
+    }
     mTimer.TickSignal().Connect( this, &ExampleApp::OnTimer);
     mTimer.Start();
 
@@ -192,6 +828,14 @@ private:
 
   void ReloadJsonFile(Builder& builder, Layer& layer)
   {
+    std::string data(fw.GetFileContents());
+    fw.SetReferencedFiles( FindReferencedFiles( data, fw.GetFilename() ) );
+
+    if( mIncremental && builder && layer && UpdateJsonFile( data ) )
+    {
+      return;
+    }
+
     Stage stage = Stage::GetCurrent();
     stage.SetBackgroundColor( Color::WHITE );
 
@@ -244,8 +888,7 @@ private:
       layer.Remove( layer.GetChildAt(0) );
     }
 
-    std::string data(fw.GetFileContents());
-
+    bool loaded = true;
     try
     {
       builder.LoadFromString(data);
@@ -253,21 +896,415 @@ private:
     catch(...)
     {
       builder.LoadFromString(ReplaceQuotes(JSON_BROKEN));
+      loaded = false;
     }
 
     builder.AddActors( layer );
 
+    if( mIncremental )
+    {
+      RecordStageActors( loaded ? data : std::string(), layer );
+    }
+  }
+
+  /**
+   * Keeps the parsed layout and the actors created for its stage section, to diff the next save against.
+   */
+  void RecordStageActors( const std::string& data, Layer& layer )
+  {
+    mLayout.Reset();
+    mStageActors.clear();
+
+    if( data.empty() )
+    {
+      return;
+    }
+
+    JsonParser parser = JsonParser::New();
+    parser.Parse( data );
+    if( parser.ParseError() || !parser.GetRoot() )
+    {
+      return;
+    }
+
+    // AddActors() adds the stage section in order, so the layer's children match it one to one
+    const TreeNode* stageNode = parser.GetRoot()->GetChild( "stage" );
+    const unsigned int count = stageNode ? stageNode->Size() : 0u;
+    if( layer.GetChildCount() != count )
+    {
+      return;
+    }
+
+    for( unsigned int i = 0; i < count; ++i )
+    {
+      mStageActors.push_back( layer.GetChildAt( i ) );
+    }
+    mLayout = parser;
+  }
+
+  /**
+   * Applies the difference between the previous layout and the new one to the live actors.
+   * @return false if the change cannot be applied incrementally and a full reload is needed
+   */
+  bool UpdateJsonFile( const std::string& data )
+  {
+    if( !mLayout )
+    {
+      return false;
+    }
+
+    JsonParser parser = JsonParser::New();
+    parser.Parse( data );
+    if( parser.ParseError() || !parser.GetRoot() || !mLayout.GetRoot() )
+    {
+      return false;
+    }
+
+    const TreeNode& previousRoot = *mLayout.GetRoot();
+    const TreeNode& currentRoot = *parser.GetRoot();
+    if( !SameSectionsExceptStage( previousRoot, currentRoot ) )
+    {
+      return false;
+    }
+
+    KeyedNodes previousActors, currentActors;
+    std::vector<std::string> previousOrder, currentOrder;
+    if( !GetKeyedActors( previousRoot.GetChild( "stage" ), previousActors, previousOrder ) ||
+        !GetKeyedActors( currentRoot.GetChild( "stage" ), currentActors, currentOrder ) ||
+        previousOrder.size() != mStageActors.size() ||
+        !SameRelativeOrder( previousOrder, previousActors, currentOrder, currentActors ) )
+    {
+      return false;
+    }
+
+    std::map<std::string, Actor> liveActors;
+    for( unsigned int i = 0; i < previousOrder.size(); ++i )
+    {
+      liveActors[ previousOrder[i] ] = mStageActors[i];
+    }
+
+    mPropertyUpdates = mAdditions = mRemovals = mReplacements = 0;
+
+    // Remove first, so that the actors which remain are at the indices of the current layout
+    for( KeyedNodes::const_iterator iter = previousActors.begin(); iter != previousActors.end(); ++iter )
+    {
+      if( currentActors.find( iter->first ) == currentActors.end() )
+      {
+        liveActors[ iter->first ].Unparent();
+        ++mRemovals;
+      }
+    }
+
+    std::vector<Actor> stageActors;
+    for( unsigned int i = 0; i < currentOrder.size(); ++i )
+    {
+      const TreeNode& current = *currentActors[ currentOrder[i] ];
+      KeyedNodes::const_iterator previous = previousActors.find( currentOrder[i] );
+      Actor actor;
+      if( previous == previousActors.end() )
+      {
+        actor = CreateActor( current );
+        if( actor )
+        {
+          mRootLayer.Add( actor );
+          MoveToIndex( mRootLayer, actor, i );
+        }
+        ++mAdditions;
+      }
+      else
+      {
+        actor = UpdateActor( *previous->second, current, liveActors[ currentOrder[i] ], mRootLayer );
+      }
+      stageActors.push_back( actor );
+    }
+
+    mStageActors.swap( stageActors );
+    mLayout = parser;
+
+    std::cout << "Incremental reload: " << mPropertyUpdates << " updated, " << mAdditions << " added, "
+              << mRemovals << " removed, " << mReplacements << " recreated" << std::endl;
+    return true;
+  }
+
+  /**
+   * Brings a live actor from its previous description to its current one.
+   * @return The actor, which is a new one if it had to be recreated
+   */
+  Actor UpdateActor( const TreeNode& previous, const TreeNode& current, Actor actor, Actor parent )
+  {
+    if( !actor || ToJson( previous ) == ToJson( current ) )
+    {
+      return actor;
+    }
+
+    // A removed property cannot be reset to its default, and the type cannot be changed in place
+    for( TreeNode::ConstIterator iter = previous.CBegin(); iter != previous.CEnd(); ++iter )
+    {
+      if( (*iter).first && !current.GetChild( (*iter).first ) )
+      {
+        return ReplaceActor( current, actor, parent );
+      }
+    }
+
+    std::ostringstream changed;
+    changed.precision(9);
+    changed << '{';
+    bool hasChanges = false;
+    for( TreeNode::ConstIterator iter = current.CBegin(); iter != current.CEnd(); ++iter )
+    {
+      const std::string key( (*iter).first ? (*iter).first : "" );
+      if( key.empty() || key == "actors" )
+      {
+        continue;
+      }
+
+      const TreeNode* before = previous.GetChild( key );
+      if( !before || ToJson( *before ) != ToJson( (*iter).second ) )
+      {
+        if( key == "type" )
+        {
+          return ReplaceActor( current, actor, parent );
+        }
+
+        if( hasChanges )
+        {
+          changed << ',';
+        }
+        WriteJsonString( key.c_str(), changed );
+        changed << ':';
+        WriteJson( (*iter).second, changed );
+        hasChanges = true;
+      }
+    }
+    changed << '}';
+
+    // Look up every live child first, so nothing is half applied if the actor has to be recreated
+    KeyedNodes previousChildren, currentChildren;
+    std::vector<std::string> previousOrder, currentOrder;
+    if( !GetKeyedActors( previous.GetChild( "actors" ), previousChildren, previousOrder ) ||
+        !GetKeyedActors( current.GetChild( "actors" ), currentChildren, currentOrder ) ||
+        !SameRelativeOrder( previousOrder, previousChildren, currentOrder, currentChildren ) )
+    {
+      return ReplaceActor( current, actor, parent );
+    }
+
+    std::map<std::string, Actor> liveChildren;
+    for( KeyedNodes::const_iterator iter = previousChildren.begin(); iter != previousChildren.end(); ++iter )
+    {
+      KeyedNodes::const_iterator after = currentChildren.find( iter->first );
+      if( after != currentChildren.end() && ToJson( *iter->second ) == ToJson( *after->second ) )
+      {
+        continue;
+      }
+
+      // Only named children can be found again among the actors the builder created
+      const std::string name = GetActorName( *iter->second );
+      Actor child = name.empty() ? Actor() : FindDirectChild( actor, name );
+      if( !child )
+      {
+        return ReplaceActor( current, actor, parent );
+      }
+      liveChildren[ iter->first ] = child;
+    }
+
+    if( hasChanges )
+    {
+      Handle handle( actor );
+      if( !mBuilder.ApplyFromJson( handle, changed.str() ) )
+      {
+        return ReplaceActor( current, actor, parent );
+      }
+      ++mPropertyUpdates;
+    }
+
+    for( std::map<std::string, Actor>::iterator iter = liveChildren.begin(); iter != liveChildren.end(); ++iter )
+    {
+      KeyedNodes::const_iterator after = currentChildren.find( iter->first );
+      if( after == currentChildren.end() )
+      {
+        iter->second.Unparent();
+        ++mRemovals;
+      }
+      else
+      {
+        UpdateActor( *previousChildren[ iter->first ], *after->second, iter->second, actor );
+      }
+    }
+
+    for( unsigned int i = 0; i < currentOrder.size(); ++i )
+    {
+      if( previousChildren.find( currentOrder[i] ) == previousChildren.end() )
+      {
+        Actor child = CreateActor( *currentChildren[ currentOrder[i] ] );
+        if( child )
+        {
+          actor.Add( child );
+          MoveToIndex( actor, child, i );
+        }
+        ++mAdditions;
+      }
+    }
+
+    return actor;
+  }
+
+  Actor ReplaceActor( const TreeNode& current, Actor actor, Actor parent )
+  {
+    unsigned int index = 0;
+    while( index < parent.GetChildCount() && parent.GetChildAt( index ) != actor )
+    {
+      ++index;
+    }
+
+    Actor replacement = CreateActor( current );
+    actor.Unparent();
+    if( replacement )
+    {
+      parent.Add( replacement );
+      MoveToIndex( parent, replacement, index );
+    }
+    ++mReplacements;
+    return replacement;
+  }
+
+  /**
+   * Finds a child by name among the direct children only; FindChildByName() would also match a deeper actor.
+   */
+  static Actor FindDirectChild( Actor parent, const std::string& name )
+  {
+    for( unsigned int i = 0; i < parent.GetChildCount(); ++i )
+    {
+      Actor child = parent.GetChildAt( i );
+      if( child.GetName() == name )
+      {
+        return child;
+      }
+    }
+    return Actor();
+  }
+
+  /**
+   * Moves the last child of parent to index, so that the sibling order, and with it the draw order, is that of
+   * a full reload. Actor has no insertion API, so the siblings from index onwards are re-added behind it.
+   */
+  static void MoveToIndex( Actor parent, Actor child, unsigned int index )
+  {
+    std::vector<Actor> following;
+    for( unsigned int i = index; i < parent.GetChildCount(); ++i )
+    {
+      Actor sibling = parent.GetChildAt( i );
+      if( sibling != child )
+      {
+        following.push_back( sibling );
+      }
+    }
+
+    for( std::vector<Actor>::iterator iter = following.begin(); iter != following.end(); ++iter )
+    {
+      parent.Remove( *iter );
+      parent.Add( *iter );
+    }
   }
 
+  Actor CreateActor( const TreeNode& node )
+  {
+    return Actor::DownCast( mBuilder.CreateFromJson( ToJson( node ) ) );
+  }
+
+
+  /**
+   * Times reading and building each demo layout with the Builder against mapping and building its compiled form.
+   */
+  void RunLayoutBenchmark()
+  {
+    Stage stage = Stage::GetCurrent();
+    Layer layer = Layer::New();
+    layer.SetParentOrigin(ParentOrigin::CENTER);
+    layer.SetAnchorPoint(AnchorPoint::CENTER);
+    layer.SetSize( stage.GetSize() );
+    stage.Add( layer );
+
+    Property::Map defaultDirs;
+    defaultDirs[ TOKEN_STRING(DEMO_IMAGE_DIR) ]  = DEMO_IMAGE_DIR;
+    defaultDirs[ TOKEN_STRING(DEMO_MODEL_DIR) ]  = DEMO_MODEL_DIR;
+    defaultDirs[ TOKEN_STRING(DEMO_SCRIPT_DIR) ] = DEMO_SCRIPT_DIR;
+
+    const DemoHelper::LayoutConstants constants = DemoHelper::GetDemoLayoutConstants();
+    const std::vector<std::string> files = GetLayoutFiles( DEMO_SCRIPT_DIR );
+
+    std::cout << "Layout parse + build time over " << BENCHMARK_ITERATIONS << " iterations (ms per build)" << std::endl;
+    std::cout << "layout\tjson\tcompiled\tcompiled bytes" << std::endl;
+
+    for( std::vector<std::string>::const_iterator iter = files.begin(); iter != files.end(); ++iter )
+    {
+      const std::string compiledPath = "/tmp/" + BaseNameOf( DemoHelper::GetCompiledLayoutPath( *iter ) );
+      std::vector<char> compiled;
+      bool canCompile = DemoHelper::CompileLayout( GetFileContents( *iter ), constants, compiled );
+      if( canCompile )
+      {
+        std::ofstream output( compiledPath.c_str(), std::ios::binary );
+        output.write( &compiled[0], compiled.size() );
+        canCompile = output.good();
+      }
+
+      double jsonTime = 0.0;
+      double compiledTime = 0.0;
+      for( unsigned int i = 0; i < BENCHMARK_ITERATIONS; ++i )
+      {
+        double start = DemoHelper::GetMilliseconds();
+        {
+          Builder builder = Builder::New();
+          builder.AddConstants( defaultDirs );
+          builder.LoadFromString( GetFileContents( *iter ) );
+          builder.AddActors( layer );
+        }
+        jsonTime += DemoHelper::GetMilliseconds() - start;
+        RemoveChildren( layer );
+
+        if( canCompile )
+        {
+          start = DemoHelper::GetMilliseconds();
+          DemoHelper::BuildCompiledLayoutFile( compiledPath, layer );
+          compiledTime += DemoHelper::GetMilliseconds() - start;
+          RemoveChildren( layer );
+        }
+      }
+
+      std::cout << BaseNameOf( *iter ) << "\t" << jsonTime / BENCHMARK_ITERATIONS << "\t";
+      if( canCompile )
+      {
+        std::cout << compiledTime / BENCHMARK_ITERATIONS << "\t" << compiled.size() << std::endl;
+        unlink( compiledPath.c_str() );
+      }
+      else
+      {
+        std::cout << "-\t(needs the Builder)" << std::endl;
+      }
+    }
+
+    stage.Remove( layer );
+  }
 
   bool OnTimer(void)
   {
     if(fw.FileHasChanged())
     {
+      const double start = DemoHelper::GetMilliseconds();
+
       ReloadJsonFile( mBuilder, mRootLayer );
+
+      std::cout << "Reloaded in " << DemoHelper::GetMilliseconds() - start << "ms" << std::endl;
     }
 
-    return true;
+    // Keep polling only if there is no watch thread to wake us up
+    return mTimer.GetInterval() == POLL_INTERVAL_MILLISECONDS;
+  }
+
+  // Called from the file watch thread's trigger when a watched file has been written
+  void OnFileChanged()
+  {
+    // Restarting the timer pushes the reload back while the events of one save keep coming in
+    mTimer.Start();
   }
 
   // Process Key events to Quit on back-key
@@ -288,6 +1325,16 @@ private:
   }
 
   Builder mBuilder;
+
+  JsonParser mLayout;                ///< The layout the live actors were built from, for incremental reloads
+  std::vector<Actor> mStageActors;   ///< The live actors of the layout's stage section, in order
+  bool mIncremental;
+  bool mBenchmark;
+
+  unsigned int mPropertyUpdates;
+  unsigned int mAdditions;
+  unsigned int mRemovals;
+  unsigned int mReplacements;
 };
 
 //------------------------------------------------------------------------------
@@ -301,10 +1348,49 @@ int main(int argc, char **argv)
   Application dali_app = Application::New(&argc, &argv, DEMO_THEME_PATH);
   ExampleApp app(dali_app);
 
-  if(argc > 1)
+  std::string filename;
+  std::string compiledFilename;
+  bool benchmark = false;
+  for(int i = 1; i < argc; ++i)
+  {
+    if(std::string(argv[i]) == "--incremental")
+    {
+      app.SetIncremental(true);
+    }
+    else if(std::string(argv[i]) == "--benchmark")
+    {
+      benchmark = true;
+    }
+    else if(std::string(argv[i]) == "--compile" && i + 1 < argc)
+    {
+      compiledFilename = argv[++i];
+    }
+    else if(filename.empty())
+    {
+      filename = argv[i];
+    }
+  }
+
+  if(!compiledFilename.empty())
+  {
+    // Precompile the layout for DemoHelper::BuildCompiledLayout() and exit
+    if(!DemoHelper::CompileLayoutFile(filename, compiledFilename, DemoHelper::GetDemoLayoutConstants()))
+    {
+      std::cout << "Could not compile " << filename << " (parse error, or it needs the Builder at run time)" << std::endl;
+      return 1;
+    }
+    std::cout << "Compiled " << filename << " to " << compiledFilename << std::endl;
+    return 0;
+  }
+
+  if(benchmark)
+  {
+    app.SetBenchmark(true);
+  }
+  else if(!filename.empty())
   {
-    std::cout << "Loading file:" << argc << " " << argv[1] << std::endl;
-    app.SetJSONFilename(argv[1]);
+    std::cout << "Loading file:" << argc << " " << filename << std::endl;
+    app.SetJSONFilename(filename);
   }
   else
   {
@@ -20,10 +20,15 @@
 #include <string>
 #include <map>
 #include <algorithm>
+#include <vector>
+#include <cstring>
+#include <cstdio>
 
 #include <dali/dali.h>
+#include <dali/devel-api/threading/mutex.h>
 #include <dali-toolkit/dali-toolkit.h>
 #include "shared/view.h"
+#include "shared/utility.h"
 
 using namespace Dali;
 using namespace Dali::Toolkit;
@@ -58,6 +63,7 @@ const Vector3 INITIAL_BALL_DIRECTION(1.0f, 1.0f, 0.0f);                     ///<
 
 const std::string WOBBLE_PROPERTY_NAME("wobbleProperty");                  ///< Wobble property name.
 const std::string COLLISION_PROPERTY_NAME("collisionProperty");            ///< Collision property name.
+const std::string BRICK_HIT_COUNT_PROPERTY_NAME("brickHitCountProperty");  ///< Brick hit count property name.
 
 const Vector2 BRICK_SIZE(0.1f, 0.05f );                                     ///< Brick size relative to width of stage.
 const Vector2 BALL_SIZE( 0.05f, 0.05f );                                    ///< Ball size relative to width of stage.
@@ -70,8 +76,359 @@ const Vector2 PADDLE_HIT_MARGIN( 0.1, 0.15f );                              ///<
 const int TOTAL_LIVES(3);                                                   ///< Total lives in game before it's game over!
 const int TOTAL_LEVELS(3);                                                  ///< 3 Levels total, then repeats.
 
+const int STRESS_LEVEL_ROWS(72);                                            ///< Rows of the stress level, thousands of small bricks.
+const int STRESS_LEVEL_COLUMNS(34);                                         ///< Columns of the stress level.
+const float GENERATED_LEVEL_TOP(0.125f);                                    ///< Top of the bricks of a generated level relative to stage height.
+const float GENERATED_LEVEL_MAX_HEIGHT(0.6f);                               ///< Max. height of the bricks of a generated level relative to stage height.
+
+int GENERATED_LEVEL_ROWS = 0;                                               ///< Set by --level ROWSxCOLUMNS or --stress to play a generated level.
+int GENERATED_LEVEL_COLUMNS = 0;
+bool PER_BRICK_COLLISIONS = false;                                          ///< Set by --per-brick-collisions to use a constraint and notification on every brick.
+
+const unsigned int BENCHMARK_FRAMES(3600u);                                 ///< Frames simulated by --benchmark, a minute at 60 frames per second.
+const float BENCHMARK_FRAME_TIME(1.0f / 60.0f);                             ///< The time step of --benchmark in seconds.
+const Vector2 BENCHMARK_STAGE_SIZE(720.0f, 1280.0f);                        ///< The stage size simulated by --benchmark.
+
+/**
+ * The levels simulated by --benchmark: rows, columns and balls.
+ */
+const int BENCHMARK_LEVELS[][3] = { { 10, 8, 1 }, { 72, 34, 1 }, { 72, 34, 4 }, { 150, 100, 8 } };
+const unsigned int NUM_BENCHMARK_LEVELS( sizeof( BENCHMARK_LEVELS ) / sizeof( BENCHMARK_LEVELS[0] ) );
+
+// levels /////////////////////////////////////////////////////////////////////
+
+/**
+ * The layout of a generated level.
+ */
+struct LevelLayout
+{
+  Vector2 brickSize;                        ///< The size of every brick
+  std::vector<Vector2> brickPositions;      ///< The center of each brick
+  std::vector<int> brickTypes;              ///< The image of each brick, 0 to TOTAL_BRICKS - 1
+  std::vector<Vector3> ballPositions;       ///< The start position of each ball
+  std::vector<Vector3> ballDirections;      ///< The normalized start direction of each ball
+};
+
+/**
+ * Generates a level of rows x columns bricks, in rings of brick types like level 1.
+ * The bricks cover 85 percent of the width of the stage, and are made flatter if needed
+ * so that the rows fit above the paddle. The balls start spread across the ball start
+ * row, heading up at different angles.
+ *
+ * @param[in] stageSize The size of the stage
+ * @param[in] rows The number of rows of bricks
+ * @param[in] columns The number of columns of bricks
+ * @param[in] ballCount The number of balls
+ * @param[out] layout The generated level
+ */
+void GenerateLevelLayout( const Vector2& stageSize, int rows, int columns, int ballCount, LevelLayout& layout )
+{
+  const float brickWidth = 0.85f * stageSize.width / columns;
+  const float brickHeight = std::min( brickWidth * BRICK_SIZE.height / BRICK_SIZE.width, GENERATED_LEVEL_MAX_HEIGHT * stageSize.height / rows );
+  layout.brickSize = Vector2( brickWidth, brickHeight );
+
+  const Vector2 offset( (stageSize.x - (columns * brickWidth)) * 0.5f, stageSize.y * GENERATED_LEVEL_TOP );
+  layout.brickPositions.clear();
+  layout.brickTypes.clear();
+  for(int j = 0; j < rows; j++)
+  {
+    for(int i = 0; i < columns; i++)
+    {
+      int i2 = columns - i - 1;
+      int j2 = rows - j - 1;
+      layout.brickPositions.push_back( Vector2(i * brickWidth + offset.x, j * brickHeight + offset.y) + (layout.brickSize * 0.5f) );
+      layout.brickTypes.push_back( std::min( std::min(i, j), std::min(i2, j2) ) % TOTAL_BRICKS );
+    }
+  }
+
+  layout.ballPositions.clear();
+  layout.ballDirections.clear();
+  for(int i = 0; i < ballCount; i++)
+  {
+    const float side = (i % 2) ? -1.0f : 1.0f;
+    Vector3 direction( side * (0.5f + 0.5f * i / ballCount), -1.0f, 0.0f );
+    direction.Normalize();
+    layout.ballPositions.push_back( Vector3( stageSize.width * (i + 1) / (ballCount + 1), stageSize.height * BALL_START_POSITION.y, 0.0f ) );
+    layout.ballDirections.push_back( direction );
+  }
+}
+
+// collisions /////////////////////////////////////////////////////////////////
+
+/**
+ * Calculates the collision vector between a circle and a rectangle.
+ *
+ * @param[in] a The center of the circle
+ * @param[in] radius The radius of the circle
+ * @param[in] b The center of the rectangle
+ * @param[in] halfSize Half the size of the rectangle
+ * @param[out] collisionVector The normalized direction from the rectangle to the circle, if they overlap
+ * @return true if the circle and rectangle overlap
+ */
+bool CalculateCollisionVector( const Vector3& a, float radius, const Vector3& b, const Vector3& halfSize, Vector3& collisionVector )
+{
+  // get collision relative to a (rectangle).
+  Vector3 delta = a - b;
+
+  // reduce rectangle to 0.
+  if (delta.x > halfSize.x)
+  {
+    delta.x -= halfSize.x;
+  }
+  else if (delta.x < -halfSize.x)
+  {
+    delta.x += halfSize.x;
+  }
+  else
+  {
+    delta.x = 0;
+  }
+
+  if (delta.y > halfSize.y)
+  {
+    delta.y -= halfSize.y;
+  }
+  else if (delta.y < -halfSize.y)
+  {
+    delta.y += halfSize.y;
+  }
+  else
+  {
+    delta.y = 0;
+  }
+
+  // now calculate collision vector vs origin. (assume A is a circle, not ellipse)
+  if(delta.Length() < radius)
+  {
+    delta.Normalize();
+    collisionVector = delta;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * BrickGrid buckets the bricks of a level into a uniform grid of cells,
+ * so that the ball is only tested against the bricks in the cells it overlaps.
+ */
+class BrickGrid
+{
+public:
+
+  /**
+   * @param[in] areaSize The size of the area the bricks are laid out in
+   * @param[in] cellSize The size of a cell, about the size of a brick
+   */
+  BrickGrid( const Vector2& areaSize, const Vector2& cellSize )
+  : mCellSize( cellSize ),
+    mColumns( std::max( static_cast<int>( ceilf( areaSize.width / cellSize.width ) ), 1 ) ),
+    mRows( std::max( static_cast<int>( ceilf( areaSize.height / cellSize.height ) ), 1 ) ),
+    mCells( mColumns * mRows )
+  {
+  }
+
+  /**
+   * Adds a brick to every cell it overlaps.
+   * @return The index of the brick, which is passed back by FindCollision()
+   */
+  unsigned int AddBrick( const Vector3& position, const Vector3& size )
+  {
+    Brick brick;
+    brick.position = position;
+    brick.halfSize = size * 0.5f;
+    brick.active = true;
+    const unsigned int index = mBricks.size();
+    mBricks.push_back( brick );
+
+    int left, top, right, bottom;
+    if( GetCellRange( position - brick.halfSize, position + brick.halfSize, left, top, right, bottom ) )
+    {
+      for( int row = top; row <= bottom; ++row )
+      {
+        for( int column = left; column <= right; ++column )
+        {
+          mCells[ row * mColumns + column ].push_back( index );
+        }
+      }
+    }
+    return index;
+  }
+
+  /**
+   * Stops a brick colliding.
+   */
+  void RemoveBrick( unsigned int index )
+  {
+    mBricks[index].active = false;
+  }
+
+  /**
+   * Finds the nearest brick the ball overlaps, testing only the bricks in the cells the ball overlaps.
+   * @param[in] position The center of the ball
+   * @param[in] radius The radius of the ball
+   * @param[out] index The index of the brick
+   * @param[out] collisionVector The collision vector of the ball and the brick
+   * @return true if the ball overlaps a brick
+   */
+  bool FindCollision( const Vector3& position, float radius, unsigned int& index, Vector3& collisionVector ) const
+  {
+    const Vector3 extent( radius, radius, 0.0f );
+    int left, top, right, bottom;
+    if( !GetCellRange( position - extent, position + extent, left, top, right, bottom ) )
+    {
+      return false;
+    }
+
+    bool found = false;
+    float nearestDistance = 0.0f;
+    for( int row = top; row <= bottom; ++row )
+    {
+      for( int column = left; column <= right; ++column )
+      {
+        const std::vector<unsigned int>& cell = mCells[ row * mColumns + column ];
+        for( std::vector<unsigned int>::const_iterator iter = cell.begin(); iter != cell.end(); ++iter )
+        {
+          const Brick& brick = mBricks[*iter];
+          Vector3 brickCollisionVector;
+          if( brick.active && CalculateCollisionVector( position, radius, brick.position, brick.halfSize, brickCollisionVector ) )
+          {
+            const float distance = ( position - brick.position ).LengthSquared();
+            if( !found || distance < nearestDistance )
+            {
+              found = true;
+              nearestDistance = distance;
+              index = *iter;
+              collisionVector = brickCollisionVector;
+            }
+          }
+        }
+      }
+    }
+    return found;
+  }
+
+private:
+
+  /**
+   * Retrieves the cells a box overlaps.
+   * @return false if the box is outside the grid
+   */
+  bool GetCellRange( const Vector3& topLeft, const Vector3& bottomRight, int& left, int& top, int& right, int& bottom ) const
+  {
+    left = std::max( static_cast<int>( floorf( topLeft.x / mCellSize.width ) ), 0 );
+    top = std::max( static_cast<int>( floorf( topLeft.y / mCellSize.height ) ), 0 );
+    right = std::min( static_cast<int>( floorf( bottomRight.x / mCellSize.width ) ), mColumns - 1 );
+    bottom = std::min( static_cast<int>( floorf( bottomRight.y / mCellSize.height ) ), mRows - 1 );
+    return left <= right && top <= bottom;
+  }
+
+  struct Brick
+  {
+    Vector3 position;
+    Vector3 halfSize;
+    bool active;
+  };
+
+  Vector2 mCellSize;                                    ///< The size of a cell
+  int mColumns;                                         ///< The number of columns of cells
+  int mRows;                                            ///< The number of rows of cells
+  std::vector< std::vector<unsigned int> > mCells;      ///< The indices of the bricks overlapping each cell
+  std::vector<Brick> mBricks;                           ///< Every brick added
+};
+
+/**
+ * A brick the ball has hit, queued by BrickCollisionConstraint on the update thread.
+ */
+struct BrickHit
+{
+  unsigned int ballIndex;                   ///< The index of the ball, in the order of the constraint's sources
+  unsigned int brickIndex;                  ///< The index of the brick in the BrickGrid
+  Vector3 collisionVector;                  ///< The collision vector of the ball and the brick
+};
+
+/**
+ * BrickHitQueue passes the bricks hit from the update thread to the event thread.
+ */
+class BrickHitQueue : public RefObject
+{
+public:
+
+  void Push( const BrickHit& hit )
+  {
+    Mutex::ScopedLock lock( mMutex );
+    mHits.push_back( hit );
+  }
+
+  /**
+   * Moves the queued hits to hits.
+   */
+  void Take( std::vector<BrickHit>& hits )
+  {
+    hits.clear();
+    Mutex::ScopedLock lock( mMutex );
+    mHits.swap( hits );
+  }
+
+private:
+
+  Mutex mMutex;
+  std::vector<BrickHit> mHits;
+};
+
+typedef IntrusivePtr<BrickHitQueue> BrickHitQueuePtr;
+
 // constraints ////////////////////////////////////////////////////////////////
 
+/**
+ * BrickCollisionConstraint tests the balls against every brick of a level through a BrickGrid.
+ * It replaces a CollisionCircleRectangleConstraint on each brick. The constraint owns its
+ * copy of the grid, which is only used on the update thread; a brick which is hit is removed
+ * from the grid and queued on the BrickHitQueue. The constrained property counts the hits,
+ * so a notification can tell the event thread to take them.
+ */
+struct BrickCollisionConstraint
+{
+  BrickCollisionConstraint( const BrickGrid& grid, BrickHitQueuePtr hits )
+  : mGrid( grid ),
+    mHits( hits ),
+    mHitCount( 0.0f )
+  {
+  }
+
+  /**
+   * @param[in,out] current The hit count
+   * @param[in] inputs Contains, for each ball:
+   *                    The ball's Position property.
+   *                    The ball's Size property.
+   */
+  void operator()( float& current, const PropertyInputContainer& inputs )
+  {
+    const unsigned int ballCount = inputs.Count() / 2u;
+    for( unsigned int ball = 0u; ball < ballCount; ++ball )
+    {
+      const Vector3& position = inputs[ball * 2u]->GetVector3();
+      const float radius = inputs[ball * 2u + 1u]->GetVector3().x * 0.5f;
+
+      BrickHit hit;
+      hit.ballIndex = ball;
+      hit.brickIndex = 0u;
+      if( mGrid.FindCollision( position, radius, hit.brickIndex, hit.collisionVector ) )
+      {
+        mGrid.RemoveBrick( hit.brickIndex );
+        mHits->Push( hit );
+        mHitCount += 1.0f;
+      }
+    }
+
+    current = mHitCount;
+  }
+
+  BrickGrid mGrid;                          ///< The bricks which have not been hit
+  BrickHitQueuePtr mHits;                   ///< Where hits are queued for the event thread
+  float mHitCount;                          ///< The number of hits so far
+};
+
 /**
  * CollisionCircleRectangleConstraint generates a collision vector
  * between two actors a (circle) and b (rectangle)
@@ -115,43 +472,7 @@ struct CollisionCircleRectangleConstraint
     const Vector3 sizeA2 = sizeA * 0.5f; // circle radius
     const Vector3 sizeB2 = (sizeB + mAdjustSize) * 0.5f; // rectangle half rectangle.
 
-    // get collision relative to a (rectangle).
-    Vector3 delta = a - b;
-
-    // reduce rectangle to 0.
-    if (delta.x > sizeB2.x)
-    {
-      delta.x -= sizeB2.x;
-    }
-    else if (delta.x < -sizeB2.x)
-    {
-      delta.x += sizeB2.x;
-    }
-    else
-    {
-      delta.x = 0;
-    }
-
-    if (delta.y > sizeB2.y)
-    {
-      delta.y -= sizeB2.y;
-    }
-    else if (delta.y < -sizeB2.y)
-    {
-      delta.y += sizeB2.y;
-    }
-    else
-    {
-      delta.y = 0;
-    }
-
-    // now calculate collision vector vs origin. (assume A is a circle, not ellipse)
-    if(delta.Length() < sizeA2.x)
-    {
-      delta.Normalize();
-      current = delta;
-    }
-    else
+    if( !CalculateCollisionVector( a, sizeA2.x, b, sizeB2, current ) )
     {
       current = Vector3::ZERO;
     }
@@ -321,6 +642,13 @@ private:
     PropertyNotification paddleNotification = delegate.AddPropertyNotification( property, GreaterThanCondition(0.0f) );
     paddleNotification.NotifySignal().Connect( this, &ExampleController::OnHitPaddle );
 
+    // Set up notification for ball colliding against bricks, the hit count steps up when a brick is hit.
+    mBrickCollisionDelegate = Actor::New();
+    stage.Add(mBrickCollisionDelegate);
+    mBrickHitCountProperty = mBrickCollisionDelegate.RegisterProperty(BRICK_HIT_COUNT_PROPERTY_NAME, 0.0f);
+    PropertyNotification brickNotification = mBrickCollisionDelegate.AddPropertyNotification( mBrickHitCountProperty, StepCondition(1.0f, 0.5f) );
+    brickNotification.NotifySignal().Connect( this, &ExampleController::OnHitBricks );
+
     RestartGame();
   }
 
@@ -361,18 +689,56 @@ private:
     mContentLayer.Add( mLevelContainer );
 
     mBrickCount = 0;
+    mBricks.clear();
+    mBrickPositions.clear();
 
-    if( mBrickImageMap.Empty() )
+    Vector2 stageSize(Stage::GetCurrent().GetSize());
+    if( GENERATED_LEVEL_ROWS > 0 )
+    {
+      // The game has one ball, so only the first ball of the layout is used
+      LevelLayout layout;
+      GenerateLevelLayout( stageSize, GENERATED_LEVEL_ROWS, GENERATED_LEVEL_COLUMNS, 1, layout );
+      SetBrickSize( layout.brickSize );
+      for( size_t i = 0; i < layout.brickPositions.size(); i++ )
+      {
+        Actor brick = CreateBrick( layout.brickPositions[i], layout.brickTypes[i] );
+        mLevelContainer.Add(brick);
+        mBrickCount++;
+      }
+    }
+    else
     {
-      Vector2 stageSize(Stage::GetCurrent().GetSize());
-      const Vector2 brickSize(BRICK_SIZE * Vector2(stageSize.x, stageSize.x));
+      SetBrickSize( BRICK_SIZE * stageSize.width );
+      GenerateLevel(level);
+    }
 
-      mBrickImageMap["desiredWidth"] = static_cast<int>( brickSize.width );
-      mBrickImageMap["desiredHeight"] = static_cast<int>( brickSize.height );
-      mBrickImageMap["fittingMode"] = "SCALE_TO_FILL";
-      mBrickImageMap["samplingMode"] = "BOX_THEN_LINEAR";
+    if( !PER_BRICK_COLLISIONS )
+    {
+      ApplyBrickCollisionConstraint();
     }
 
+    std::cout << "Level " << level << ": " << mBricks.size() << " bricks, "
+              << ( PER_BRICK_COLLISIONS ? "a collision constraint per brick" : "spatial hash collisions" ) << std::endl;
+  }
+
+  /**
+   * Sets the size of the bricks created by CreateBrick(), and the size their image is loaded at.
+   */
+  void SetBrickSize( const Vector2& brickSize )
+  {
+    mBrickSize = brickSize;
+    mBrickImageMap["desiredWidth"] = static_cast<int>( brickSize.width );
+    mBrickImageMap["desiredHeight"] = static_cast<int>( brickSize.height );
+    mBrickImageMap["fittingMode"] = "SCALE_TO_FILL";
+    mBrickImageMap["samplingMode"] = "BOX_THEN_LINEAR";
+  }
+
+  /**
+   * Generates one of the levels, which repeat.
+   * @param[in] level Level index to generate.
+   */
+  void GenerateLevel(int level)
+  {
     switch(level%TOTAL_LEVELS)
     {
       case 0:
@@ -397,6 +763,30 @@ private:
     } // end switch
   }
 
+  /**
+   * Tests the ball against every brick of the level with a single constraint, rather than one per brick.
+   */
+  void ApplyBrickCollisionConstraint()
+  {
+    if( mBrickCollisionConstraint )
+    {
+      mBrickCollisionConstraint.Remove();
+    }
+
+    BrickGrid grid( Stage::GetCurrent().GetSize(), mBrickSize );
+    for( std::vector<Vector3>::const_iterator iter = mBrickPositions.begin(); iter != mBrickPositions.end(); ++iter )
+    {
+      grid.AddBrick( *iter, Vector3( mBrickSize ) );
+    }
+
+    // Hits still queued for the previous level are dropped with its queue
+    mBrickHits = new BrickHitQueue;
+    mBrickCollisionConstraint = Constraint::New<float>( mBrickCollisionDelegate, mBrickHitCountProperty, BrickCollisionConstraint( grid, mBrickHits ) );
+    mBrickCollisionConstraint.AddSource( Source(mBall, Actor::Property::POSITION) );
+    mBrickCollisionConstraint.AddSource( Source(mBall, Actor::Property::SIZE) );
+    mBrickCollisionConstraint.Apply();
+  }
+
   /**
    * Generates level 0
    */
@@ -536,20 +926,26 @@ private:
     brick.SetParentOrigin(ParentOrigin::TOP_LEFT);
     brick.SetAnchorPoint(AnchorPoint::CENTER);
     brick.SetPosition( Vector3( position ) );
+    brick.SetSize( mBrickSize );
+    mBricks.push_back( brick );
+    mBrickPositions.push_back( Vector3( position ) );
 
-    // Add a constraint on the brick between it and the ball generating a collision-property
-    Property::Index property = brick.RegisterProperty(COLLISION_PROPERTY_NAME, Vector3::ZERO);
-    Constraint constraint = Constraint::New<Vector3>( brick, property, CollisionCircleRectangleConstraint(BRICK_COLLISION_MARGIN) );
-    constraint.AddSource( Source(mBall, Actor::Property::POSITION) );
-    constraint.AddSource( Source(brick, Actor::Property::POSITION) );
-    constraint.AddSource( Source(mBall, Actor::Property::SIZE) );
-    constraint.AddSource( Source(brick, Actor::Property::SIZE) );
-    constraint.Apply();
-
-    // Now add a notification on this collision-property
-
-    PropertyNotification brickNotification = brick.AddPropertyNotification( property, GreaterThanCondition(0.0f) );
-    brickNotification.NotifySignal().Connect( this, &ExampleController::OnHitBrick );
+    if( PER_BRICK_COLLISIONS )
+    {
+      // Add a constraint on the brick between it and the ball generating a collision-property
+      Property::Index property = brick.RegisterProperty(COLLISION_PROPERTY_NAME, Vector3::ZERO);
+      Constraint constraint = Constraint::New<Vector3>( brick, property, CollisionCircleRectangleConstraint(BRICK_COLLISION_MARGIN) );
+      constraint.AddSource( Source(mBall, Actor::Property::POSITION) );
+      constraint.AddSource( Source(brick, Actor::Property::POSITION) );
+      constraint.AddSource( Source(mBall, Actor::Property::SIZE) );
+      constraint.AddSource( Source(brick, Actor::Property::SIZE) );
+      constraint.Apply();
+
+      // Now add a notification on this collision-property
+
+      PropertyNotification brickNotification = brick.AddPropertyNotification( property, GreaterThanCondition(0.0f) );
+      brickNotification.NotifySignal().Connect( this, &ExampleController::OnHitBrick );
+    }
 
     return brick;
   }
@@ -754,6 +1150,38 @@ private:
     Actor brick = Actor::DownCast(source.GetTarget());
     Vector3 collisionVector = brick.GetProperty<Vector3>(source.GetTargetProperty());
 
+    // remove collision-constraint and notification.
+    brick.RemovePropertyNotification(source);
+    brick.RemoveConstraints();
+
+    DestroyBrick( brick, collisionVector );
+  }
+
+  /**
+   * Notification: Ball hit bricks, which BrickCollisionConstraint has queued
+   * @param source The notification
+   */
+  void OnHitBricks(PropertyNotification& source)
+  {
+    std::vector<BrickHit> hits;
+    if( mBrickHits )
+    {
+      mBrickHits->Take( hits );
+    }
+
+    for( std::vector<BrickHit>::const_iterator iter = hits.begin(); iter != hits.end(); ++iter )
+    {
+      DestroyBrick( mBricks[iter->brickIndex], iter->collisionVector );
+    }
+  }
+
+  /**
+   * Bounces the ball off a brick and fades the brick out.
+   * @param[in] brick The brick which was hit
+   * @param[in] collisionVector The collision vector of the ball and the brick
+   */
+  void DestroyBrick(Actor brick, const Vector3& collisionVector)
+  {
     const float normalVelocity = fabsf(mBallVelocity.Dot(collisionVector));
     mBallVelocity += collisionVector * normalVelocity * 2.0f;
     const float currentSpeed = mBallVelocity.Length();
@@ -762,10 +1190,6 @@ private:
 
     ContinueAnimation();
 
-    // remove collision-constraint and notification.
-    brick.RemovePropertyNotification(source);
-    brick.RemoveConstraints();
-
     // fade brick (destroy)
     Animation destroyAnimation = Animation::New(0.5f);
     destroyAnimation.AnimateTo( Property( brick, Actor::Property::COLOR_ALPHA ), 0.0f, AlphaFunction::EASE_IN );
@@ -824,6 +1248,13 @@ private:
   Property::Index mWobbleProperty;                      ///< The wobble property (generated from animation)
   Actor mLevelContainer;                                ///< The level container (contains bricks)
   Property::Map mBrickImageMap;                       ///< The property map used to load the brick
+  Vector2 mBrickSize;                                   ///< The size of the bricks of the current level
+  std::vector<Actor> mBricks;                           ///< The bricks of the current level, by index in the BrickGrid
+  std::vector<Vector3> mBrickPositions;                 ///< The positions of the bricks of the current level
+  Actor mBrickCollisionDelegate;                        ///< Holds the brick hit count
+  Property::Index mBrickHitCountProperty;               ///< The number of bricks hit, set by BrickCollisionConstraint
+  Constraint mBrickCollisionConstraint;                 ///< Tests the ball against the bricks of the current level
+  BrickHitQueuePtr mBrickHits;                          ///< The bricks hit, taken by OnHitBricks()
 
   // actor - dragging functionality
 
@@ -837,6 +1268,232 @@ private:
   int mBrickCount;                                      ///< Total bricks on screen.
 };
 
+// benchmark //////////////////////////////////////////////////////////////////
+
+/**
+ * Feeds a fixed value to a constraint outside of the update thread.
+ */
+class BenchmarkPropertyInput : public PropertyInput
+{
+public:
+
+  BenchmarkPropertyInput()
+  {
+  }
+
+  virtual Property::Type GetType() const
+  {
+    return Property::VECTOR3;
+  }
+
+  virtual const Vector3& GetVector3() const
+  {
+    return mValue;
+  }
+
+  Vector3 mValue;
+};
+
+/**
+ * The mean and maximum of a time per frame, in microseconds.
+ */
+struct FrameTimeStats
+{
+  FrameTimeStats()
+  : total( 0.0 ),
+    max( 0.0 )
+  {
+  }
+
+  /**
+   * Adds the time from start to end, in milliseconds.
+   */
+  void Add( double start, double end )
+  {
+    const double time = ( end - start ) * 1000.0;
+    total += time;
+    max = std::max( max, time );
+  }
+
+  double total;
+  double max;
+};
+
+/**
+ * Simulates generated levels without a stage and prints the time per frame spent evaluating the
+ * collision constraints and checking their notifications, with BrickCollisionConstraint and
+ * with a CollisionCircleRectangleConstraint per brick and ball.
+ *
+ * The balls move with a fixed time step and bounce off the walls, including the bottom one, so
+ * every run takes the same path. The path follows the hits of BrickCollisionConstraint; a brick's
+ * own constraints are removed when it is hit, as in the game. The number of hits and the final
+ * position of the first ball identify the path, so a change in collision behaviour shows up as a
+ * change in the output.
+ */
+void RunCollisionBenchmark()
+{
+  const Vector2 stageSize( BENCHMARK_STAGE_SIZE );
+  const Vector3 ballSize( BALL_SIZE * stageSize.width );
+  const float radius = ballSize.x * 0.5f;
+
+  for( unsigned int levelIndex = 0; levelIndex < NUM_BENCHMARK_LEVELS; levelIndex++ )
+  {
+    const int rows = BENCHMARK_LEVELS[levelIndex][0];
+    const int columns = BENCHMARK_LEVELS[levelIndex][1];
+    const int ballCount = BENCHMARK_LEVELS[levelIndex][2];
+    LevelLayout layout;
+    GenerateLevelLayout( stageSize, rows, columns, ballCount, layout );
+    const size_t brickCount = layout.brickPositions.size();
+
+    // The spatial hash constraint
+    BrickGrid grid( stageSize, layout.brickSize );
+    for( size_t i = 0; i < brickCount; i++ )
+    {
+      grid.AddBrick( Vector3( layout.brickPositions[i] ), Vector3( layout.brickSize ) );
+    }
+    BrickHitQueuePtr hitQueue( new BrickHitQueue );
+    BrickCollisionConstraint brickCollision( grid, hitQueue );
+
+    std::vector<BenchmarkPropertyInput> ballPositions( ballCount );
+    BenchmarkPropertyInput ballSizeInput;
+    ballSizeInput.mValue = ballSize;
+    PropertyInputContainer brickCollisionInputs;
+    for( int ball = 0; ball < ballCount; ball++ )
+    {
+      brickCollisionInputs.PushBack( &ballPositions[ball] );
+      brickCollisionInputs.PushBack( &ballSizeInput );
+    }
+
+    // The constraints per brick, whose inputs are swapped for each brick and ball
+    CollisionCircleRectangleConstraint brickConstraint( BRICK_COLLISION_MARGIN );
+    std::vector<BenchmarkPropertyInput> brickPositions( brickCount );
+    for( size_t i = 0; i < brickCount; i++ )
+    {
+      brickPositions[i].mValue = Vector3( layout.brickPositions[i] );
+    }
+    BenchmarkPropertyInput brickSizeInput;
+    brickSizeInput.mValue = Vector3( layout.brickSize );
+    PropertyInputContainer brickInputs;
+    brickInputs.PushBack( NULL );
+    brickInputs.PushBack( NULL );
+    brickInputs.PushBack( &ballSizeInput );
+    brickInputs.PushBack( &brickSizeInput );
+
+    std::vector<bool> brickConstrained( brickCount, true );
+    std::vector<Vector3> brickCollisionVectors( brickCount * ballCount );
+    std::vector<bool> brickNotified( brickCount * ballCount, false );
+
+    std::vector<Vector3> ballVelocities;
+    for( int ball = 0; ball < ballCount; ball++ )
+    {
+      ballPositions[ball].mValue = layout.ballPositions[ball];
+      ballVelocities.push_back( layout.ballDirections[ball] * BALL_VELOCITY );
+    }
+
+    FrameTimeStats hashConstraintTime, hashNotificationTime, brickConstraintTime, brickNotificationTime;
+    float hitCount = 0.0f;
+    int lastHitStep = 0;
+    unsigned int hits = 0u, brickNotifications = 0u;
+    std::vector<BrickHit> frameHits;
+
+    for( unsigned int frame = 0; frame < BENCHMARK_FRAMES; frame++ )
+    {
+      // Move the balls and bounce them off the walls
+      for( int ball = 0; ball < ballCount; ball++ )
+      {
+        Vector3& position = ballPositions[ball].mValue;
+        Vector3& velocity = ballVelocities[ball];
+        position += velocity * BENCHMARK_FRAME_TIME;
+        if( position.x < radius )
+        {
+          velocity.x = fabsf( velocity.x );
+        }
+        else if( position.x > stageSize.width - radius )
+        {
+          velocity.x = -fabsf( velocity.x );
+        }
+        if( position.y < radius )
+        {
+          velocity.y = fabsf( velocity.y );
+        }
+        else if( position.y > stageSize.height - radius )
+        {
+          velocity.y = -fabsf( velocity.y );
+        }
+      }
+
+      // Spatial hash: one constraint and a step notification on the hit count
+      double start = DemoHelper::GetMilliseconds();
+      brickCollision( hitCount, brickCollisionInputs );
+      double end = DemoHelper::GetMilliseconds();
+      hashConstraintTime.Add( start, end );
+
+      start = end;
+      const int hitStep = static_cast<int>( floorf( hitCount - 0.5f ) );
+      frameHits.clear();
+      if( hitStep != lastHitStep )
+      {
+        lastHitStep = hitStep;
+        hitQueue->Take( frameHits );
+      }
+      hashNotificationTime.Add( start, DemoHelper::GetMilliseconds() );
+
+      // Per brick: a constraint for each brick and ball, and a notification on each collision vector
+      start = DemoHelper::GetMilliseconds();
+      for( size_t brick = 0; brick < brickCount; brick++ )
+      {
+        if( brickConstrained[brick] )
+        {
+          brickInputs[1] = &brickPositions[brick];
+          for( int ball = 0; ball < ballCount; ball++ )
+          {
+            brickInputs[0] = &ballPositions[ball];
+            brickConstraint( brickCollisionVectors[brick * ballCount + ball], brickInputs );
+          }
+        }
+      }
+      end = DemoHelper::GetMilliseconds();
+      brickConstraintTime.Add( start, end );
+
+      start = end;
+      for( size_t i = 0; i < brickCollisionVectors.size(); i++ )
+      {
+        // GreaterThanCondition(0.0f) notifies when it becomes true
+        const bool notify = brickCollisionVectors[i].LengthSquared() > 0.0f;
+        brickNotifications += ( notify && !brickNotified[i] ) ? 1u : 0u;
+        brickNotified[i] = notify;
+      }
+      brickNotificationTime.Add( start, DemoHelper::GetMilliseconds() );
+
+      // Bounce the balls off the bricks hit, as the game does
+      for( std::vector<BrickHit>::const_iterator iter = frameHits.begin(); iter != frameHits.end(); ++iter )
+      {
+        Vector3& velocity = ballVelocities[iter->ballIndex];
+        const float normalVelocity = fabsf( velocity.Dot( iter->collisionVector ) );
+        velocity += iter->collisionVector * normalVelocity * 2.0f;
+        const float currentSpeed = velocity.Length();
+        velocity = velocity * std::min( currentSpeed, MAX_VELOCITY ) / currentSpeed;
+
+        brickConstrained[iter->brickIndex] = false;
+        for( int ball = 0; ball < ballCount; ball++ )
+        {
+          brickCollisionVectors[iter->brickIndex * ballCount + ball] = Vector3::ZERO;
+        }
+        hits++;
+      }
+    }
+
+    const Vector3& finalPosition = ballPositions[0].mValue;
+    std::cout << rows << "x" << columns << " bricks, " << ballCount << " ball(s), " << BENCHMARK_FRAMES << " frames: "
+              << hits << " bricks hit, first ball ends at (" << finalPosition.x << ", " << finalPosition.y << ")" << std::endl;
+    std::cout << "  spatial hash: constraint mean " << hashConstraintTime.total / BENCHMARK_FRAMES << "us max " << hashConstraintTime.max
+              << "us, notification mean " << hashNotificationTime.total / BENCHMARK_FRAMES << "us" << std::endl;
+    std::cout << "  per brick: constraint mean " << brickConstraintTime.total / BENCHMARK_FRAMES << "us max " << brickConstraintTime.max
+              << "us, notification mean " << brickNotificationTime.total / BENCHMARK_FRAMES << "us, "
+              << brickNotifications << " notifications" << std::endl;
+  }
+}
+
 void RunTest(Application& app)
 {
   ExampleController test(app);
@@ -846,6 +1503,33 @@ void RunTest(Application& app)
 
 int DALI_EXPORT_API main(int argc, char **argv)
 {
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--benchmark" ) == 0 )
+    {
+      RunCollisionBenchmark();
+      return 0;
+    }
+    else if( strcmp( argv[i], "--stress" ) == 0 )
+    {
+      GENERATED_LEVEL_ROWS = STRESS_LEVEL_ROWS;
+      GENERATED_LEVEL_COLUMNS = STRESS_LEVEL_COLUMNS;
+    }
+    else if( strcmp( argv[i], "--level" ) == 0 && i + 1 < argc )
+    {
+      if( sscanf( argv[++i], "%dx%d", &GENERATED_LEVEL_ROWS, &GENERATED_LEVEL_COLUMNS ) != 2 ||
+          GENERATED_LEVEL_ROWS <= 0 || GENERATED_LEVEL_COLUMNS <= 0 )
+      {
+        std::cerr << "--level expects ROWSxCOLUMNS, e.g. --level 40x20" << std::endl;
+        return 1;
+      }
+    }
+    else if( strcmp( argv[i], "--per-brick-collisions" ) == 0 )
+    {
+      PER_BRICK_COLLISIONS = true;
+    }
+  }
+
   Application app = Application::New(&argc, &argv, DEMO_THEME_PATH);
 
   RunTest(app);
@@ -15,11 +15,20 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 #include <dali/dali.h>
 #include <dali-toolkit/dali-toolkit.h>
 #include <dali-toolkit/devel-api/controls/bubble-effect/bubble-emitter.h>
 #include "shared/view.h"
 #include "shared/utility.h"
+#include "shared/progressive-image-loader.h"
+#include "shared/frame-time-monitor.h"
+#include "shared/touch-coalescer.h"
 
 using namespace Dali;
 
@@ -54,6 +63,14 @@ const unsigned int NUM_BUBBLE_SHAPE_IMAGES( sizeof( BUBBLE_SHAPE_IMAGES ) / size
 const Vector2 DEFAULT_BUBBLE_SIZE( 10.f, 30.f );
 const unsigned int DEFAULT_NUMBER_OF_BUBBLES( 1000 );
 
+const unsigned int DRAG_BENCHMARK_DURATION( 10000u );    ///< How long the scripted drag lasts, in milliseconds
+const unsigned int MAX_MOTION_POINTS_PER_FRAME( 2u );     ///< Bubbles are emitted along at most this many segments of a drag per frame
+
+bool ANIMATION_POOL = true;      ///< Cleared by --no-animation-pool to create a new animation for every four bubbles
+bool COALESCE_TOUCH = true;      ///< Cleared by --no-coalescing to emit bubbles for every motion event
+bool DRAG_BENCHMARK = false;     ///< Set by --drag-benchmark to drag across the stage, print statistics and quit
+unsigned int DRAG_BENCHMARK_INTERVAL = 16u;   ///< The interval between the scripted motion events in milliseconds, set by --drag-rate <hz>
+
 }// end LOCAL_STUFF
 
 // This example shows the usage of BubbleEmitter which displays lots of moving bubbles on the stage.
@@ -62,18 +79,27 @@ class BubbleEffectExample : public ConnectionTracker
 public:
   BubbleEffectExample(Application &app)
   : mApp(app),
+    mImageLoader( NULL ),
     mHSVDelta( Vector3( 0.f, 0.f, 0.5f ) ),
     mTimerInterval( 16 ),
     mCurrentBackgroundImageId( 0 ),
     mCurrentBubbleShapeImageId( 0 ),
+    mBackgroundLoadId( 0 ),
+    mTouchCoalescer( MAX_MOTION_POINTS_PER_FRAME ),
+    mAnimationsCreated( 0 ),
+    mAnimationsReused( 0 ),
+    mBubblesEmitted( 0 ),
+    mDragTime( 0 ),
     mNeedNewAnimation( true )
   {
     // Connect to the Application's Init signal
     app.InitSignal().Connect(this, &BubbleEffectExample::Create);
+    mTouchCoalescer.MotionSignal().Connect( this, &BubbleEffectExample::OnCoalescedMotion );
   }
 
   ~BubbleEffectExample()
   {
+    delete mImageLoader;
   }
 
 private:
@@ -120,7 +146,9 @@ private:
                                                   DemoHelper::LoadImage( BUBBLE_SHAPE_IMAGES[mCurrentBubbleShapeImageId] ),
                                                   DEFAULT_NUMBER_OF_BUBBLES,
                                                   DEFAULT_BUBBLE_SIZE);
-    mBackgroundImage = DemoHelper::LoadStageFillingImage( BACKGROUND_IMAGES[mCurrentBackgroundImageId] );
+    mImageLoader = new DemoHelper::ProgressiveImageLoader();
+    mImageLoader->ImageLoadedSignal().Connect( this, &BubbleEffectExample::OnBackgroundLoaded );
+    mBackgroundImage = DemoHelper::CreateImage( mImageLoader->LoadStageFilling( BACKGROUND_IMAGES[mCurrentBackgroundImageId], mBackgroundLoadId ) );
     mBubbleEmitter.SetBackground( mBackgroundImage, mHSVDelta );
 
     // Get the root actor of all bubbles, and add it to stage.
@@ -138,6 +166,16 @@ private:
 
     // Connect the callback to the touch signal on the background
     mBackground.TouchSignal().Connect( this, &BubbleEffectExample::OnTouch );
+
+    if( DRAG_BENCHMARK )
+    {
+      mFrameTimeMonitor.Start( content );
+      mDragTimer = Timer::New( DRAG_BENCHMARK_INTERVAL );
+      mDragTimer.TickSignal().Connect( this, &BubbleEffectExample::OnDragTimer );
+      mDragTimer.Start();
+      mCurrentTouchPosition = GetDragPosition( 0 );
+      mTouchCoalescer.Reset( mCurrentTouchPosition );
+    }
   }
 
 
@@ -151,7 +189,7 @@ private:
     if( mNeedNewAnimation )
     {
       float duration = Random::Range(1.f, 1.5f);
-      mEmitAnimation = Animation::New( duration );
+      mEmitAnimation = AcquireAnimation( duration );
       mNeedNewAnimation = false;
       mAnimateComponentCount = 0;
     }
@@ -159,6 +197,7 @@ private:
     mBubbleEmitter.EmitBubble( mEmitAnimation, emitPosition, direction + Vector2(0.f, 30.f) /* upwards */, Vector2(300, 600) );
 
     mAnimateComponentCount++;
+    mBubblesEmitted++;
 
     if( mAnimateComponentCount % 4 ==0 )
     {
@@ -167,6 +206,34 @@ private:
     }
   }
 
+  // Reuse an animation which has finished, rather than creating one for every few bubbles during a long drag
+  Animation AcquireAnimation( float duration )
+  {
+    if( ANIMATION_POOL && !mFreeAnimations.empty() )
+    {
+      Animation animation = mFreeAnimations.back();
+      mFreeAnimations.pop_back();
+      animation.SetDuration( duration );
+      mAnimationsReused++;
+      return animation;
+    }
+
+    Animation animation = Animation::New( duration );
+    if( ANIMATION_POOL )
+    {
+      animation.FinishedSignal().Connect( this, &BubbleEffectExample::OnEmitAnimationFinished );
+    }
+    mAnimationsCreated++;
+    return animation;
+  }
+
+  void OnEmitAnimationFinished( Animation& animation )
+  {
+    // The bubbles have reached their end, so dropping the animators leaves them where they are
+    animation.Clear();
+    mFreeAnimations.push_back( animation );
+  }
+
   // Emit bubbles when the finger touches down but keep stationary.
   // And stops emitting new bubble after being stationary for 2 seconds
   bool OnTimerTick()
@@ -199,6 +266,7 @@ private:
       case PointState::DOWN:
       {
         mCurrentTouchPosition = mEmitPosition = event.GetScreenPosition( 0 );
+        mTouchCoalescer.Reset( mCurrentTouchPosition );
         mTimerForBubbleEmission.Start();
         mNonMovementCount = 0;
 
@@ -206,14 +274,7 @@ private:
       }
       case PointState::MOTION:
       {
-        Vector2 displacement = event.GetScreenPosition( 0 ) - mCurrentTouchPosition;
-        mCurrentTouchPosition = event.GetScreenPosition( 0 );
-        //emit multiple bubbles along the moving direction when the finger moves quickly
-        float step = std::min(5.f, displacement.Length());
-        for( float i=0.25f; i<step; i=i+1.f)
-        {
-          SetUpAnimation( mCurrentTouchPosition+displacement*(i/step), displacement );
-        }
+        OnMotionSample( event.GetScreenPosition( 0 ) );
         break;
       }
       case PointState::UP:
@@ -221,9 +282,8 @@ private:
       case PointState::INTERRUPTED:
       {
         mTimerForBubbleEmission.Stop();
-        mEmitAnimation.Play();
-        mNeedNewAnimation = true;
-        mAnimateComponentCount = 0;
+        mTouchCoalescer.Flush();
+        PlayPendingEmissions();
         break;
       }
       case PointState::STATIONARY:
@@ -236,11 +296,91 @@ private:
     return true;
   }
 
+  // Touch panels can report motion faster than the display rate, so the samples are batched per frame
+  void OnMotionSample( const Vector2& position )
+  {
+    if( COALESCE_TOUCH )
+    {
+      mTouchCoalescer.AddSample( position );
+    }
+    else
+    {
+      OnDragMotion( position );
+    }
+  }
+
+  void OnCoalescedMotion( const DemoHelper::TouchCoalescer::Points& points )
+  {
+    for( DemoHelper::TouchCoalescer::Points::const_iterator iter = points.begin(); iter != points.end(); ++iter )
+    {
+      OnDragMotion( *iter );
+    }
+  }
+
+  // Emit multiple bubbles along the moving direction when the finger moves quickly
+  void OnDragMotion( const Vector2& position )
+  {
+    Vector2 displacement = position - mCurrentTouchPosition;
+    mCurrentTouchPosition = position;
+    float step = std::min(5.f, displacement.Length());
+    for( float i=0.25f; i<step; i=i+1.f)
+    {
+      SetUpAnimation( mCurrentTouchPosition+displacement*(i/step), displacement );
+    }
+  }
+
+  // Play the animation of the bubbles emitted since the last group of four
+  void PlayPendingEmissions()
+  {
+    if( !mNeedNewAnimation )
+    {
+      mEmitAnimation.Play();
+    }
+    mNeedNewAnimation = true;
+    mAnimateComponentCount = 0;
+  }
+
+  // A figure of eight across the stage, at the given time in milliseconds
+  Vector2 GetDragPosition( unsigned int time ) const
+  {
+    const Vector2 stageSize = Stage::GetCurrent().GetSize();
+    const float phase = time * Math::PI * 2.0f / 2000.0f;
+    return Vector2( stageSize.width * ( 0.5f + 0.4f * sinf( phase ) ), stageSize.height * ( 0.5f + 0.3f * sinf( phase * 2.0f ) ) );
+  }
+
+  // Sends the scripted drag one motion event per tick, then prints the statistics and quits
+  bool OnDragTimer()
+  {
+    mDragTime += DRAG_BENCHMARK_INTERVAL;
+    if( mDragTime <= DRAG_BENCHMARK_DURATION )
+    {
+      OnMotionSample( GetDragPosition( mDragTime ) );
+      return true;
+    }
+
+    mTouchCoalescer.Flush();
+    PlayPendingEmissions();
+    const DemoHelper::FrameTimeMonitor::Statistics statistics = mFrameTimeMonitor.TakeStatistics();
+    const float seconds = DRAG_BENCHMARK_DURATION / 1000.0f;
+    printf( "Drag of %u ms, a motion event every %u ms%s%s: %u bubbles, %u animations created, %u reused, %u pooled, %.1f animations per second",
+            DRAG_BENCHMARK_DURATION, DRAG_BENCHMARK_INTERVAL,
+            ANIMATION_POOL ? "" : " without the animation pool", COALESCE_TOUCH ? "" : " without coalescing",
+            mBubblesEmitted, mAnimationsCreated, mAnimationsReused, static_cast< unsigned int >( mFreeAnimations.size() ),
+            ( mAnimationsCreated + mAnimationsReused ) / seconds );
+    if( COALESCE_TOUCH )
+    {
+      printf( "; %u motion events in %u batches", mTouchCoalescer.GetSampleCount(), mTouchCoalescer.GetDispatchCount() );
+    }
+    printf( "; %u frames, mean %.2f ms, max %.2f ms, %u slow\n", statistics.frames, statistics.mean, statistics.max, statistics.slowFrames );
+    mApp.Quit();
+    return false;
+  }
+
   bool OnChangeIconClicked( Toolkit::Button button )
   {
     if(button == mChangeBackgroundButton)
     {
-      mBackgroundImage = DemoHelper::LoadStageFillingImage( BACKGROUND_IMAGES[ ++mCurrentBackgroundImageId % NUM_BACKGROUND_IMAGES  ] );
+      mBackgroundImage = DemoHelper::CreateImage( mImageLoader->LoadStageFilling( BACKGROUND_IMAGES[ ++mCurrentBackgroundImageId % NUM_BACKGROUND_IMAGES  ], mBackgroundLoadId ) );
 
       mBubbleEmitter.SetBackground( mBackgroundImage, mHSVDelta );
 
@@ -253,6 +393,20 @@ private:
     return true;
   }
 
+  /**
+   * Replaces the thumbnail of the background with the full resolution image once it has been decoded.
+   */
+  void OnBackgroundLoaded( unsigned int loadId, PixelData pixelData )
+  {
+    // Ignore images which have been superseded by another background change
+    if( loadId == mBackgroundLoadId && pixelData )
+    {
+      mBackgroundImage = DemoHelper::CreateImage( pixelData );
+      mBubbleEmitter.SetBackground( mBackgroundImage, mHSVDelta );
+      mBackground.SetBackgroundImage( mBackgroundImage );
+    }
+  }
+
   /**
    * Main key event handler
    */
@@ -270,11 +424,13 @@ private:
 private:
 
   Application&               mApp;
+  DemoHelper::ProgressiveImageLoader* mImageLoader;
   Image                      mBackgroundImage;
   Dali::Toolkit::Control     mBackground;
 
   Toolkit::BubbleEmitter     mBubbleEmitter;
   Animation                  mEmitAnimation;
+  std::vector< Animation >   mFreeAnimations;      ///< Finished emission animations, cleared for reuse
   Toolkit::PushButton        mChangeBackgroundButton;
   Toolkit::PushButton        mChangeBubbleShapeButton;
   Timer                      mTimerForBubbleEmission;
@@ -288,6 +444,15 @@ private:
   unsigned int               mTimerInterval;
   unsigned int               mCurrentBackgroundImageId;
   unsigned int               mCurrentBubbleShapeImageId;
+  unsigned int               mBackgroundLoadId;
+
+  DemoHelper::TouchCoalescer mTouchCoalescer;
+  DemoHelper::FrameTimeMonitor mFrameTimeMonitor;
+  Timer                      mDragTimer;
+  unsigned int               mAnimationsCreated;
+  unsigned int               mAnimationsReused;
+  unsigned int               mBubblesEmitted;
+  unsigned int               mDragTime;             ///< The time into the scripted drag, in milliseconds
 
   bool                       mNeedNewAnimation;
 };
@@ -305,6 +470,27 @@ RunTest(Application& app)
 
 int DALI_EXPORT_API main(int argc, char **argv)
 {
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--no-animation-pool" ) == 0 )
+    {
+      ANIMATION_POOL = false;
+    }
+    else if( strcmp( argv[i], "--no-coalescing" ) == 0 )
+    {
+      COALESCE_TOUCH = false;
+    }
+    else if( strcmp( argv[i], "--drag-benchmark" ) == 0 )
+    {
+      DRAG_BENCHMARK = true;
+    }
+    else if( strcmp( argv[i], "--drag-rate" ) == 0 && i + 1 < argc )
+    {
+      const int rate = atoi( argv[++i] );
+      DRAG_BENCHMARK_INTERVAL = rate > 0 ? std::max( 1000 / rate, 1 ) : DRAG_BENCHMARK_INTERVAL;
+    }
+  }
+
   Application app = Application::New(&argc, &argv, DEMO_THEME_PATH);
 
   RunTest(app);
@@ -26,6 +26,8 @@
 #include <dali-toolkit/devel-api/builder/tree-node.h>
 #include <dali-toolkit/devel-api/builder/json-parser.h>
 #include <dali-toolkit/devel-api/controls/popup/popup.h>
+#include <algorithm>
+#include <deque>
 #include <map>
 #include <string>
 #include <fstream>
@@ -41,6 +43,9 @@
 
 #include <dali/integration-api/debug.h>
 #include "shared/view.h"
+#include "shared/utility.h"
+#include "shared/compiled-layout.h"
+#include "shared/worker-pool.h"
 
 #define TOKEN_STRING(x) #x
 
@@ -56,6 +61,7 @@ const char* EDIT_IMAGE( DEMO_IMAGE_DIR "icon-change.png" );
 const char* EDIT_IMAGE_SELECTED( DEMO_IMAGE_DIR "icon-change-selected.png" );
 
 std::string USER_DIRECTORY;
+bool USE_LAYOUT_CACHE( true );
 
 std::string JSON_BROKEN("                                      \
 {                                                              \
@@ -130,6 +136,55 @@ void DirectoryFilesByType(const std::string& dir, const std::string& fileType /*
   }
 }
 
+/**
+ * A layout file, read, parsed and compiled once on a worker thread when the browser starts.
+ */
+struct LayoutFile
+{
+  LayoutFile()
+  : hasStage( false )
+  {
+  }
+
+  std::string       path;
+  std::string       data;      ///< The contents of the file, which the Builder loads when the layout cannot be compiled
+  std::vector<char> compiled;  ///< The compiled stage section, empty if the layout needs the Builder
+  Builder           builder;   ///< The Builder loaded with a layout which cannot be compiled, once the event thread has been idle
+  std::string       error;     ///< The parse error, if any
+  bool              hasStage;  ///< Whether there is a stage section with nodes, only those are listed
+};
+
+/**
+ * Reads, parses and compiles a layout file. Called on a worker thread; the parser is only used by that thread.
+ */
+void ParseLayoutFile( LayoutFile& layout )
+{
+  layout.data = GetFileContents( layout.path );
+
+  JsonParser parser = JsonParser::New();
+  parser.Parse( layout.data );
+
+  if( parser.ParseError() )
+  {
+    std::ostringstream error;
+    error << parser.GetErrorLineNumber() << "(" << parser.GetErrorColumn() << "):" << parser.GetErrorDescription();
+    layout.error = error.str();
+    return;
+  }
+
+  if( parser.GetRoot() )
+  {
+    const TreeNode* node = parser.GetRoot()->Find("stage");
+    layout.hasStage = node && node->Size();
+
+    // Layouts which need the Builder at run time keep only their data
+    if( layout.hasStage && !DemoHelper::CompileLayout( *parser.GetRoot(), DemoHelper::GetDemoLayoutConstants(), layout.compiled ) )
+    {
+      layout.compiled.clear();
+    }
+  }
+}
+
 const std::string ShortName( const std::string& name )
 {
   size_t pos = name.rfind( '/' );
@@ -228,12 +283,25 @@ std::string FileWatcher::GetFilename(void) const
 class ExampleApp : public ConnectionTracker, public Toolkit::ItemFactory
 {
 public:
-  ExampleApp(Application &app) : mApp(app)
+  ExampleApp(Application &app)
+  : mApp(app),
+    mParsePool(NULL),
+    mParseStartTime(0.0),
+    mParseTime(0.0),
+    mPreloadScheduled(false),
+    mPreloadCount(0u),
+    mPreloadTime(0.0),
+    mSelectedLayout(0),
+    mSelectionTime(0.0),
+    mFallbackTime(0.0)
   {
     app.InitSignal().Connect(this, &ExampleApp::Create);
   }
 
-  ~ExampleApp() {}
+  ~ExampleApp()
+  {
+    delete mParsePool;
+  }
 
 public:
 
@@ -298,6 +366,35 @@ public:
     mItemView.SetKeyboardFocusable( true );
 
     mFiles.clear();
+
+    // List the layouts which have been parsed so far, OnLayoutParsed() adds the rest
+    for( size_t index = 0; index < mLayoutFiles.size(); ++index )
+    {
+      if( mLayoutFiles[index].hasStage )
+      {
+        mItemView.InsertItem( Item( mFiles.size(), MenuItem( ShortName( mLayoutFiles[index].path ) ) ), 0.5f );
+        mFiles.push_back( index );
+      }
+    }
+
+    // Display item view on the stage
+    stage.Add( mItemView );
+
+    mItemView.SetVisible( true );
+    mBuilderLayer.SetVisible( false );
+
+    SetTitle("Select");
+
+    // Activate the layout
+    Vector3 size(stage.GetSize());
+    mItemView.ActivateLayout(0, size, 0.0f/*immediate*/);
+  }
+
+  /**
+   * Queues the parsing of every layout file, all CPUs are used.
+   */
+  void ParseLayoutFiles()
+  {
     FileList files;
 
     if( USER_DIRECTORY.size() )
@@ -311,60 +408,120 @@ public:
 
     std::sort(files.begin(), files.end());
 
-    ItemId itemId = 0;
-    for(FileList::iterator iter = files.begin(); iter != files.end(); ++iter)
+    mParsePool = new DemoHelper::WorkerPool( 0u );
+    mParseStartTime = DemoHelper::GetMilliseconds();
+    mParseTime = 0.0;
+    mLayoutFiles.resize( files.size() );
+
+    for( size_t index = 0; index < files.size(); ++index )
     {
-      JsonParser parser = JsonParser::New();
+      mLayoutFiles[index].path = files[index];
+      mParsePool->AddTask( new ParseTask( *this, index, files[index] ) );
+    }
+  }
+
+  /**
+   * Called when a layout file has been parsed; caches it, and lists it if it has a stage section.
+   * @param[in] parseTime The time the worker took to read, parse and compile it
+   */
+  void OnLayoutParsed( size_t index, LayoutFile& result, double parseTime )
+  {
+    mParseTime += parseTime;
 
-      std::string data( GetFileContents( *iter ) );
+    LayoutFile& layout = mLayoutFiles[index];
+    bool listed = layout.hasStage;
 
-      parser.Parse( data );
+    std::swap( layout, result );
 
-      if( parser.ParseError() )
+    if( !layout.error.empty() )
+    {
+      std::cout << "Parser Error:" << layout.path << std::endl;
+      std::cout << layout.error << std::endl;
+
+      if( !listed )
       {
-        std::cout << "Parser Error:" << *iter << std::endl;
-        std::cout << parser.GetErrorLineNumber() << "(" << parser.GetErrorColumn() << "):" << parser.GetErrorDescription() << std::endl;
         exit(1);
       }
 
-      if( parser.GetRoot() )
-      {
-        if( const TreeNode* node = parser.GetRoot()->Find("stage") )
-        {
-          // only those with a stage section
-          if( node->Size() )
-          {
-            mFiles.push_back( *iter );
-
-            mItemView.InsertItem( Item(itemId,
-                                       MenuItem( ShortName( *iter ) ) ),
-                                  0.5f );
-
-            itemId++;
-          }
-          else
-          {
-            std::cout << "Ignored file (stage has no nodes?):" << *iter << std::endl;
-          }
-        }
-        else
-        {
-          std::cout << "Ignored file (no stage section):" << *iter << std::endl;
-        }
-      }
+      // An edit broke a listed layout, keep it listed so that it shows the broken layout message
+      layout.hasStage = true;
     }
 
-    // Display item view on the stage
-    stage.Add( mItemView );
+    if( !layout.hasStage )
+    {
+      std::cout << "Ignored file (no stage section or stage has no nodes):" << layout.path << std::endl;
+    }
 
-    mItemView.SetVisible( true );
-    mBuilderLayer.SetVisible( false );
+    // The position of the layout in the list, which is sorted like mLayoutFiles
+    size_t position = std::lower_bound( mFiles.begin(), mFiles.end(), index ) - mFiles.begin();
 
-    SetTitle("Select");
+    if( layout.hasStage && !listed )
+    {
+      mFiles.insert( mFiles.begin() + position, index );
+      mItemView.InsertItem( Item( position, MenuItem( ShortName( layout.path ) ) ), 0.5f );
+    }
+    else if( listed && !layout.hasStage )
+    {
+      mFiles.erase( mFiles.begin() + position );
+      mItemView.RemoveItem( position, 0.5f );
+    }
 
-    // Activate the layout
-    Vector3 size(stage.GetSize());
-    mItemView.ActivateLayout(0, size, 0.0f/*immediate*/);
+    // The Builder can only load from a string, so it is loaded while the event thread is idle rather than on selection
+    if( USE_LAYOUT_CACHE && layout.hasStage && layout.error.empty() && layout.compiled.empty() )
+    {
+      mPreloadQueue.push_back( index );
+      SchedulePreload();
+    }
+
+    if( mParsePool->GetPendingTaskCount() == 0u && mParseStartTime > 0.0 )
+    {
+      std::cout << "Parsed " << mLayoutFiles.size() << " layouts on " << mParsePool->GetThreadCount() << " threads in "
+                << DemoHelper::GetMilliseconds() - mParseStartTime << " ms, " << mParseTime << " ms of worker time" << std::endl;
+      mParseStartTime = 0.0;
+    }
+  }
+
+  void SchedulePreload()
+  {
+    if( !mPreloadScheduled )
+    {
+      mPreloadScheduled = mApp.AddIdle( MakeCallback( this, &ExampleApp::OnPreloadIdle ) );
+    }
+  }
+
+  /**
+   * Loads a Builder with the next layout which cannot be compiled, one per idle so that the browser stays responsive.
+   */
+  void OnPreloadIdle()
+  {
+    mPreloadScheduled = false;
+
+    if( !mPreloadQueue.empty() )
+    {
+      LayoutFile& layout = mLayoutFiles[ mPreloadQueue.front() ];
+      mPreloadQueue.pop_front();
+
+      // The layout may have been selected, or edited and parsed again, since it was queued
+      if( !layout.builder && layout.hasStage && layout.error.empty() && layout.compiled.empty() )
+      {
+        const double start = DemoHelper::GetMilliseconds();
+        LoadBuilder( layout );
+        mPreloadTime += DemoHelper::GetMilliseconds() - start;
+        ++mPreloadCount;
+      }
+    }
+
+    if( !mPreloadQueue.empty() )
+    {
+      SchedulePreload();
+    }
+    else if( mPreloadCount > 0u )
+    {
+      std::cout << "Preloaded " << mPreloadCount << " layouts which cannot be compiled into Builders in "
+                << mPreloadTime << " ms of idle time" << std::endl;
+      mPreloadCount = 0u;
+      mPreloadTime = 0.0;
+    }
   }
 
   void ExitSelection()
@@ -381,7 +538,35 @@ public:
   {
     ItemId id = mItemView.GetItemId( actor );
 
+    mSelectionTime = DemoHelper::GetMilliseconds();
     LoadFromFileList( id );
+
+    // Idle is reached once the layout has been built and the update which shows it has been queued
+    mApp.AddIdle( MakeCallback( this, &ExampleApp::OnSelectionShown ) );
+  }
+
+  void OnSelectionShown()
+  {
+    const LayoutFile& layout = mLayoutFiles[mSelectedLayout];
+    std::cout << "Selection to visible: " << ShortName( layout.path ) << " " << DemoHelper::GetMilliseconds() - mSelectionTime << " ms (";
+    if( !USE_LAYOUT_CACHE )
+    {
+      std::cout << "read and parsed on selection";
+    }
+    else if( layout.compiled.empty() && mFallbackTime > 0.0 )
+    {
+      // Selected before the event thread was idle long enough to preload it
+      std::cout << "Builder fallback, LoadFromString on selection " << mFallbackTime << " ms";
+    }
+    else if( layout.compiled.empty() )
+    {
+      std::cout << "preloaded Builder";
+    }
+    else
+    {
+      std::cout << "compiled";
+    }
+    std::cout << ")" << std::endl;
   }
 
   Actor MenuItem(const std::string& text)
@@ -401,16 +586,20 @@ public:
     if( mFileWatcher.FileHasChanged() )
     {
       LoadFromFile( mFileWatcher.GetFilename() );
+
+      // Refresh the cache, or selecting the layout again would show the old version
+      mParsePool->AddTask( new ParseTask( *this, mSelectedLayout, mFileWatcher.GetFilename() ) );
     }
 
     return true;
   }
 
-  void ReloadJsonFile(const std::string& filename, Builder& builder, Layer& layer)
+  /**
+   * Creates a new builder, with the demo directories as constants.
+   */
+  Builder NewBuilder()
   {
-    Stage stage = Stage::GetCurrent();
-
-    builder = Builder::New();
+    Builder builder = Builder::New();
     builder.QuitSignal().Connect( this, &ExampleApp::OnBuilderQuit );
 
     Property::Map defaultDirs;
@@ -419,6 +608,31 @@ public:
     defaultDirs[ TOKEN_STRING(DEMO_SCRIPT_DIR) ] = DEMO_SCRIPT_DIR;
 
     builder.AddConstants( defaultDirs );
+    return builder;
+  }
+
+  /**
+   * Loads a new builder with a layout which cannot be compiled, and caches it with the layout.
+   */
+  void LoadBuilder( LayoutFile& layout )
+  {
+    layout.builder = NewBuilder();
+    try
+    {
+      layout.builder.LoadFromString( layout.data );
+    }
+    catch(...)
+    {
+      layout.builder.LoadFromString(ReplaceQuotes(JSON_BROKEN));
+    }
+  }
+
+  /**
+   * Removes what the last layout added.
+   */
+  void ResetLayout(Layer& layer)
+  {
+    Stage stage = Stage::GetCurrent();
 
     // render tasks may have been setup last load so remove them
     RenderTaskList taskList = stage.GetRenderTaskList();
@@ -449,6 +663,19 @@ public:
     {
       layer.Remove( layer.GetChildAt(0) );
     }
+  }
+
+  void ReloadJsonFile(const std::string& filename, Builder& builder, Layer& layer)
+  {
+    ResetLayout( layer );
+    builder = NewBuilder();
+
+    // Use the layout precompiled by dali-builder --compile if there is one, it needs no parsing
+    if( DemoHelper::HasUpToDateCompiledLayout( filename ) &&
+        DemoHelper::BuildCompiledLayoutFile( DemoHelper::GetCompiledLayoutPath( filename ), layer ) )
+    {
+      return;
+    }
 
     std::string data(GetFileContents(filename));
 
@@ -464,21 +691,62 @@ public:
     builder.AddActors( layer );
   }
 
+  /**
+   * As ReloadJsonFile() but from the cache, so only the actors are created: from the compiled layout, or by the
+   * Builder preloaded with the layout. A layout selected before its Builder was preloaded is loaded now.
+   */
+  void LoadCachedLayout(LayoutFile& layout, Builder& builder, Layer& layer)
+  {
+    ResetLayout( layer );
+    mFallbackTime = 0.0;
+
+    DemoHelper::CompiledLayout compiled;
+    if( !layout.compiled.empty() &&
+        compiled.Attach( &layout.compiled[0], layout.compiled.size() ) &&
+        DemoHelper::BuildCompiledLayout( compiled, layer ) )
+    {
+      return;
+    }
+
+    if( !layout.builder )
+    {
+      const double fallbackStart = DemoHelper::GetMilliseconds();
+      LoadBuilder( layout );
+      mFallbackTime = DemoHelper::GetMilliseconds() - fallbackStart;
+    }
+
+    builder = layout.builder;
+    builder.AddActors( layer );
+  }
 
   void LoadFromFileList( size_t index )
   {
     if( index < mFiles.size())
     {
-      const std::string& name = mFiles[index];
-      mFileWatcher.SetFilename( name );
-      LoadFromFile( name );
+      mSelectedLayout = mFiles[index];
+      LayoutFile& layout = mLayoutFiles[mSelectedLayout];
+      mFileWatcher.SetFilename( layout.path );
+
+      if( USE_LAYOUT_CACHE )
+      {
+        LoadCachedLayout( layout, mBuilder, mBuilderLayer );
+        ShowLayout();
+      }
+      else
+      {
+        LoadFromFile( layout.path );
+      }
     }
   }
 
   void LoadFromFile( const std::string& name )
   {
     ReloadJsonFile( name, mBuilder, mBuilderLayer );
+    ShowLayout();
+  }
 
+  void ShowLayout()
+  {
     mBuilderLayer.SetParentOrigin(ParentOrigin::BOTTOM_CENTER);
     mBuilderLayer.SetAnchorPoint(AnchorPoint::BOTTOM_CENTER);
     Dali::Vector3 size = Stage::GetCurrent().GetRootLayer().GetCurrentSize();
@@ -518,6 +786,7 @@ public:
     editButton.SetLeaveRequired( true );
     mToolBar.AddControl( editButton, DemoHelper::DEFAULT_VIEW_STYLE.mToolBarButtonPercentage, Toolkit::Alignment::HorizontalLeft, DemoHelper::DEFAULT_MODE_SWITCH_PADDING  );
 
+    ParseLayoutFiles();
     EnterSelection();
 
     mTimer = Timer::New( 500 ); // ms
@@ -534,7 +803,7 @@ public:
   virtual Actor NewItem(unsigned int itemId)
   {
     DALI_ASSERT_DEBUG( itemId < mFiles.size() );
-    return MenuItem( ShortName( mFiles[itemId] ) );
+    return MenuItem( ShortName( mLayoutFiles[ mFiles[itemId] ].path ) );
   }
 
   /**
@@ -573,6 +842,41 @@ public:
     }
   }
 
+private:
+
+  /**
+   * Parses a layout file on a worker thread and hands it to OnLayoutParsed().
+   */
+  class ParseTask : public DemoHelper::WorkerTask
+  {
+  public:
+    ParseTask( ExampleApp& app, size_t index, const std::string& path )
+    : mApp( app ),
+      mIndex( index ),
+      mParseTime( 0.0 )
+    {
+      mLayout.path = path;
+    }
+
+    virtual void Process()
+    {
+      const double start = DemoHelper::GetMilliseconds();
+      ParseLayoutFile( mLayout );
+      mParseTime = DemoHelper::GetMilliseconds() - start;
+    }
+
+    virtual void Complete()
+    {
+      mApp.OnLayoutParsed( mIndex, mLayout, mParseTime );
+    }
+
+  private:
+    ExampleApp& mApp;
+    size_t      mIndex;
+    LayoutFile  mLayout;
+    double      mParseTime;
+  };
+
 private:
   Application& mApp;
 
@@ -594,7 +898,19 @@ private:
   // builder
   Builder mBuilder;
 
-  FileList mFiles;
+  std::vector<LayoutFile> mLayoutFiles;  ///< Every layout file, sorted by path
+  std::vector<size_t> mFiles;            ///< The index in mLayoutFiles of each item
+  DemoHelper::WorkerPool* mParsePool;
+  double mParseStartTime;
+  double mParseTime;                     ///< The time the workers spent reading, parsing and compiling the layouts
+  std::deque<size_t> mPreloadQueue;      ///< The layouts which cannot be compiled, to load into Builders when idle
+  bool mPreloadScheduled;
+  unsigned int mPreloadCount;
+  double mPreloadTime;
+
+  size_t mSelectedLayout;
+  double mSelectionTime;
+  double mFallbackTime;                  ///< The time the Builder took to load the selected layout, if it had not been preloaded
 
   FileWatcher mFileWatcher;
   Timer mTimer;
@@ -609,11 +925,16 @@ private:
 //------------------------------------------------------------------------------
 int DALI_EXPORT_API main(int argc, char **argv)
 {
-  if(argc > 2)
+  for( int i = 1; i < argc; ++i )
   {
-    if(strcmp(argv[1], "-f") == 0)
+    if( strcmp( argv[i], "-f" ) == 0 && i + 1 < argc )
+    {
+      USER_DIRECTORY = argv[++i];
+    }
+    else if( strcmp( argv[i], "--no-cache" ) == 0 )
     {
-      USER_DIRECTORY = argv[2];
+      // Read and parse a layout when it is selected, as before the layout cache, to compare
+      USE_LAYOUT_CACHE = false;
     }
   }
 
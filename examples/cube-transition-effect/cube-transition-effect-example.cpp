@@ -17,10 +17,14 @@
 
 // EXTERNAL INCLUDES
 #include <math.h>
+#include <iostream>
 
 // INTERNAL INCLUDES
 #include "shared/view.h"
 #include "shared/utility.h"
+#include "shared/progressive-image-loader.h"
+#include "shared/slide-prefetcher.h"
+#include "shared/frame-time-monitor.h"
 
 #include <dali/dali.h>
 #include <dali-toolkit/dali-toolkit.h>
@@ -126,7 +130,7 @@ private:
    */
   void OnPanGesture( Actor actor, const PanGesture& gesture );
   /**
-   * Load the next image and start the transition;
+   * Start the transition to the image at mIndex, using the prefetched texture when it is ready
    */
   void GoToNextImage();
   /**
@@ -158,12 +162,26 @@ private:
   bool OnTimerTick();
 
   /**
-   * Loads image, resizes it to the size of stage and creates a textue out of it
+   * Loads the thumbnail of an image resized to the size of stage and creates a texture out of it.
+   * The full resolution texture is delivered to OnImageLoaded() once decoded.
    * @param[in] filepath Path to the image file
    * @return New texture object
    */
   Texture LoadStageFillingTexture( const char* filepath );
 
+  /**
+   * Callback function of the progressive image loader
+   * Replaces the thumbnail with the full resolution texture, or keeps it until the transition has completed
+   * @param[in] loadId The id of the load
+   * @param[in] pixelData The full resolution image
+   */
+  void OnImageLoaded( unsigned int loadId, PixelData pixelData );
+
+  /**
+   * Shows the full resolution texture on all the effects.
+   */
+  void SetFullResolutionTexture();
+
 private:
   Application&                    mApplication;
   Toolkit::Control                mView;
@@ -173,9 +191,13 @@ private:
 
   Vector2                         mViewSize;
 
+  DemoHelper::ProgressiveImageLoader* mImageLoader;
+  DemoHelper::SlidePrefetcher< Texture >* mSlides;   ///< Keeps the previous and next images decoded and uploaded
   Texture                         mCurrentTexture;
   Texture                         mNextTexture;
+  Texture                         mPendingTexture;    ///< Full resolution texture waiting for the transition to complete
   unsigned int                    mIndex;
+  unsigned int                    mImageLoadId;
   bool                            mIsImageLoading;
 
   PanGestureDetector              mPanGestureDetector;
@@ -188,6 +210,9 @@ private:
   bool                            mSlideshow;
   Timer                           mViewTimer;
   Toolkit::PushButton             mSlideshowButton;
+  DemoHelper::FrameTimeMonitor    mFrameTimeMonitor;  ///< Records the frames of the slideshow
+  float                           mTransitionStartTime; ///< The time GoToNextImage() took, in milliseconds
+  bool                            mIsPrefetched;      ///< Whether the target of the transition had been prefetched
 
   Vector2                         mPanPosition;
   Vector2                         mPanDisplacement;
@@ -197,16 +222,22 @@ private:
 
 CubeTransitionApp::CubeTransitionApp( Application& application )
 : mApplication( application ),
+  mImageLoader( NULL ),
+  mSlides( NULL ),
   mIndex( 0 ),
+  mImageLoadId( 0 ),
   mIsImageLoading( false ),
-  mSlideshow( false )
+  mSlideshow( false ),
+  mTransitionStartTime( 0.0f ),
+  mIsPrefetched( false )
 {
   mApplication.InitSignal().Connect( this, &CubeTransitionApp::OnInit );
 }
 
 CubeTransitionApp::~CubeTransitionApp()
 {
-  //Nothing to do
+  delete mSlides;
+  delete mImageLoader;
 }
 
 void CubeTransitionApp::OnInit( Application& application )
@@ -238,8 +269,16 @@ void CubeTransitionApp::OnInit( Application& application )
   // Set size to stage size to avoid seeing a black border on transition
   mViewSize = Stage::GetCurrent().GetSize();
 
+  mImageLoader = new DemoHelper::ProgressiveImageLoader();
+  mImageLoader->ImageLoadedSignal().Connect( this, &CubeTransitionApp::OnImageLoaded );
+
+  mSlides = new DemoHelper::SlidePrefetcher< Texture >( IMAGES, NUM_IMAGES, ImageDimensions( mViewSize.x, mViewSize.y ),
+                                                         FittingMode::SCALE_TO_FILL, SamplingMode::BOX_THEN_LINEAR,
+                                                         &DemoHelper::CreateTexture );
+
   // show the first image
   mCurrentTexture = LoadStageFillingTexture( IMAGES[mIndex] );
+  mSlides->SetCurrent( mIndex );
 
   //use small cubes
   mCubeWaveEffect = Toolkit::CubeTransitionWaveEffect::New( NUM_ROWS_WAVE, NUM_COLUMNS_WAVE );
@@ -310,11 +349,28 @@ void CubeTransitionApp::OnPanGesture( Actor actor, const PanGesture& gesture )
 
 void CubeTransitionApp::GoToNextImage()
 {
-  mNextTexture = LoadStageFillingTexture( IMAGES[ mIndex ] );
+  const double start = DemoHelper::GetMilliseconds();
+
+  mNextTexture = mSlides->Get( mIndex );
+  mIsPrefetched = mNextTexture;
+  if( mIsPrefetched )
+  {
+    // Already at full resolution, so drop any load still in flight for the previous image
+    mPendingTexture.Reset();
+    mImageLoadId = 0;
+  }
+  else
+  {
+    mNextTexture = LoadStageFillingTexture( IMAGES[ mIndex ] );
+  }
+
   mCurrentEffect.SetTargetTexture( mNextTexture );
   mIsImageLoading = false;
   mCurrentEffect.StartTransition( mPanPosition, mPanDisplacement );
   mCurrentTexture = mNextTexture;
+
+  mSlides->SetCurrent( mIndex );
+  mTransitionStartTime = DemoHelper::GetMilliseconds() - start;
 }
 
 bool CubeTransitionApp::OnEffectButtonClicked( Toolkit::Button button )
@@ -361,6 +417,7 @@ bool CubeTransitionApp::OnSildeshowButtonClicked( Toolkit::Button button )
     mPanPosition = Vector2( mViewSize.width, mViewSize.height*0.5f );
     mPanDisplacement = Vector2( -10.f, 0.f );
     mViewTimer.Start();
+    mFrameTimeMonitor.Start( mContent );
   }
   else
   {
@@ -368,14 +425,26 @@ bool CubeTransitionApp::OnSildeshowButtonClicked( Toolkit::Button button )
     mSlideshowButton.SetUnselectedImage( SLIDE_SHOW_START_ICON );
     mSlideshowButton.SetSelectedImage( SLIDE_SHOW_START_ICON_SELECTED );
     mViewTimer.Stop();
+    mFrameTimeMonitor.Stop();
   }
   return true;
 }
 
 void CubeTransitionApp::OnTransitionCompleted(Toolkit::CubeTransitionEffect effect, Texture texture )
 {
+  if( mPendingTexture )
+  {
+    SetFullResolutionTexture();
+  }
+
   if( mSlideshow )
   {
+    DemoHelper::FrameTimeMonitor::Statistics statistics = mFrameTimeMonitor.TakeStatistics();
+    std::cout << "Slide " << mIndex << ( mIsPrefetched ? " (prefetched)" : " (loaded on demand)" )
+              << ": transition started in " << mTransitionStartTime << " ms, "
+              << statistics.frames << " frames, mean " << statistics.mean << " ms, max " << statistics.max << " ms, "
+              << statistics.slowFrames << " slow" << std::endl;
+
     mViewTimer.Start();
   }
 }
@@ -385,6 +454,9 @@ bool CubeTransitionApp::OnTimerTick()
   if(mSlideshow)
   {
     mIndex = (mIndex + 1)%NUM_IMAGES;
+
+    // Only the frames of the transition itself are reported
+    mFrameTimeMonitor.TakeStatistics();
     GoToNextImage();
   }
 
@@ -394,13 +466,33 @@ bool CubeTransitionApp::OnTimerTick()
 
 Texture CubeTransitionApp::LoadStageFillingTexture( const char* filepath )
 {
-  ImageDimensions dimensions( Stage::GetCurrent().GetSize().x, Stage::GetCurrent().GetSize().y );
-  BitmapLoader loader = BitmapLoader::New( filepath, dimensions, FittingMode::SCALE_TO_FILL );
-  loader.Load();
-  PixelData pixelData = loader.GetPixelData();
-  Texture texture = Texture::New( TextureType::TEXTURE_2D, pixelData.GetPixelFormat(), pixelData.GetWidth(), pixelData.GetHeight() );
-  texture.Upload( pixelData );
-  return texture;
+  mPendingTexture.Reset();
+  return DemoHelper::CreateTexture( mImageLoader->LoadStageFilling( filepath, mImageLoadId ) );
+}
+
+void CubeTransitionApp::OnImageLoaded( unsigned int loadId, PixelData pixelData )
+{
+  // Ignore images which have been superseded by another transition
+  if( loadId != mImageLoadId || !pixelData )
+  {
+    return;
+  }
+
+  mPendingTexture = DemoHelper::CreateTexture( pixelData );
+  if( !mCurrentEffect.IsTransitioning() )
+  {
+    SetFullResolutionTexture();
+  }
+}
+
+void CubeTransitionApp::SetFullResolutionTexture()
+{
+  mCurrentTexture = mPendingTexture;
+  mPendingTexture.Reset();
+
+  mCubeWaveEffect.SetCurrentTexture( mCurrentTexture );
+  mCubeCrossEffect.SetCurrentTexture( mCurrentTexture );
+  mCubeFoldEffect.SetCurrentTexture( mCurrentTexture );
 }
 
 void CubeTransitionApp::OnKeyEvent(const KeyEvent& event)
@@ -17,9 +17,14 @@
 
 // EXTERNAL INCLUDES
 #include <math.h>
+#include <iostream>
 
 // INTERNAL INCLUDES
 #include "shared/view.h"
+#include "shared/utility.h"
+#include "shared/progressive-image-loader.h"
+#include "shared/slide-prefetcher.h"
+#include "shared/frame-time-monitor.h"
 
 #include <dali/dali.h>
 #include <dali-toolkit/dali-toolkit.h>
@@ -80,25 +85,14 @@ const float TRANSITION_DURATION = 2.5f; //2.5 second
 const float INITIAL_DEPTH = 10.0f;
 
 /**
- * @brief Create an image view with an image which would be scaled-down to no more than the stage dimensions.
- *
- * Uses image scaling mode SCALE_TO_FILL to resize the image at
- * load time to cover the entire stage with pixels with no borders,
- * and filter mode BOX_THEN_LINEAR to sample the image with maximum quality.
+ * @brief Create an image view showing an image which has already been scaled to the stage dimensions.
  */
-Toolkit::ImageView CreateStageFillingImageView( const char * const imagePath )
+Toolkit::ImageView CreateStageFillingImageView( Image image )
 {
-  Size stageSize = Stage::GetCurrent().GetSize();
-  Toolkit::ImageView imageView = Toolkit::ImageView::New();
-  Property::Map map;
-  map[Toolkit::Visual::Property::TYPE] = Toolkit::Visual::IMAGE;
-  map[Toolkit::ImageVisual::Property::URL] = imagePath;
-  map[Toolkit::ImageVisual::Property::DESIRED_WIDTH] = stageSize.x;
-  map[Toolkit::ImageVisual::Property::DESIRED_HEIGHT] = stageSize.y;
-  map[Toolkit::ImageVisual::Property::FITTING_MODE] = FittingMode::SCALE_TO_FILL;
-  map[Toolkit::ImageVisual::Property::SAMPLING_MODE] = SamplingMode::BOX_THEN_LINEAR;
-  map[Toolkit::ImageVisual::Property::SYNCHRONOUS_LOADING] = true;
-  imageView.SetProperty( Toolkit::ImageView::Property::IMAGE, map );
+  Toolkit::ImageView imageView = Toolkit::ImageView::New( image );
+  imageView.SetParentOrigin( ParentOrigin::CENTER );
+  imageView.SetResizePolicy( ResizePolicy::FILL_TO_PARENT, Dimension::ALL_DIMENSIONS );
+  imageView.SetSizeScalePolicy( SizeScalePolicy::FIT_WITH_ASPECT_RATIO );
 
   return imageView;
 }
@@ -165,6 +159,22 @@ private:
    */
   void OnKeyEvent(const KeyEvent& event);
 
+  /**
+   * Creates the view for an image, using the prefetched image when it is ready, otherwise
+   * showing its thumbnail until the full resolution image has been decoded.
+   * @param[in] index The index of the image in IMAGES
+   * @return The image view
+   */
+  Toolkit::ImageView LoadImageView( unsigned int index );
+
+  /**
+   * Callback function of the progressive image loader
+   * Replaces the thumbnail with the full resolution image, or keeps it until the transition has completed
+   * @param[in] loadId The id of the load
+   * @param[in] pixelData The full resolution image
+   */
+  void OnImageLoaded( unsigned int loadId, PixelData pixelData );
+
 private:
   Application&                    mApplication;
   Toolkit::Control                mView;
@@ -173,9 +183,13 @@ private:
   Toolkit::TextLabel              mTitleActor;
   Actor                           mParent;
 
+  DemoHelper::ProgressiveImageLoader* mImageLoader;
+  DemoHelper::SlidePrefetcher< Atlas >* mSlides;     ///< Keeps the previous and next images decoded and uploaded
   Toolkit::ImageView              mCurrentImage;
   Toolkit::ImageView              mNextImage;
+  Image                           mPendingImage;      ///< Full resolution image waiting for the transition to complete
   unsigned int                    mIndex;
+  unsigned int                    mImageLoadId;
 
   Property::Map                   mDissolveEffect;
   Property::Map                   mEmptyEffect;
@@ -191,25 +205,35 @@ private:
   bool                            mTimerReady;
   unsigned int                    mCentralLineIndex;
 
+  DemoHelper::FrameTimeMonitor    mFrameTimeMonitor;  ///< Records the frames of the slideshow
+  float                           mTransitionStartTime; ///< The time taken to start the slideshow transition, in milliseconds
+  bool                            mIsPrefetched;      ///< Whether the image being transited to had been prefetched
+
   Toolkit::PushButton             mPlayStopButton;
   Toolkit::PushButton             mEffectChangeButton;
 };
 
 DissolveEffectApp::DissolveEffectApp( Application& application )
 : mApplication( application ),
+  mImageLoader( NULL ),
+  mSlides( NULL ),
   mIndex( 0 ),
+  mImageLoadId( 0 ),
   mUseHighPrecision(true),
   mIsTransiting( false ),
   mSlideshow( false ),
   mTimerReady( false ),
-  mCentralLineIndex( 0 )
+  mCentralLineIndex( 0 ),
+  mTransitionStartTime( 0.0f ),
+  mIsPrefetched( false )
 {
   mApplication.InitSignal().Connect( this, &DissolveEffectApp::OnInit );
 }
 
 DissolveEffectApp::~DissolveEffectApp()
 {
-  //Nothing to do
+  delete mSlides;
+  delete mImageLoader;
 }
 
 void DissolveEffectApp::OnInit( Application& application )
@@ -251,11 +275,16 @@ void DissolveEffectApp::OnInit( Application& application )
   mParent.SetParentOrigin( ParentOrigin::CENTER );
   mContent.Add( mParent );
 
+  mImageLoader = new DemoHelper::ProgressiveImageLoader();
+  mImageLoader->ImageLoadedSignal().Connect( this, &DissolveEffectApp::OnImageLoaded );
+
+  const Vector2 stageSize = Stage::GetCurrent().GetSize();
+  mSlides = new DemoHelper::SlidePrefetcher< Atlas >( IMAGES, NUM_IMAGES, ImageDimensions( stageSize.x, stageSize.y ),
+                                                       FittingMode::SCALE_TO_FILL, SamplingMode::BOX_THEN_LINEAR,
+                                                       &DemoHelper::CreateImage );
+
   // show the first image
-  mCurrentImage = CreateStageFillingImageView( IMAGES[mIndex] );
-  mCurrentImage.SetParentOrigin( ParentOrigin::CENTER );
-  mCurrentImage.SetResizePolicy( ResizePolicy::FILL_TO_PARENT, Dimension::ALL_DIMENSIONS );
-  mCurrentImage.SetSizeScalePolicy( SizeScalePolicy::FIT_WITH_ASPECT_RATIO );
+  mCurrentImage = LoadImageView( mIndex );
   mParent.Add( mCurrentImage );
 
   mPanGestureDetector.Attach( mCurrentImage );
@@ -285,10 +314,7 @@ void DissolveEffectApp::OnPanGesture( Actor actor, const PanGesture& gesture )
       mIndex = (mIndex + NUM_IMAGES -1)%NUM_IMAGES;
     }
 
-    mNextImage = CreateStageFillingImageView( IMAGES[ mIndex ] );
-    mNextImage.SetParentOrigin( ParentOrigin::CENTER );
-    mNextImage.SetResizePolicy( ResizePolicy::FILL_TO_PARENT, Dimension::ALL_DIMENSIONS );
-    mNextImage.SetSizeScalePolicy( SizeScalePolicy::FIT_WITH_ASPECT_RATIO );
+    mNextImage = LoadImageView( mIndex );
     mNextImage.SetZ(INITIAL_DEPTH);
     mParent.Add( mNextImage );
     Vector2 size = Vector2( mCurrentImage.GetCurrentSize() );
@@ -364,6 +390,7 @@ bool DissolveEffectApp::OnSildeshowButtonClicked( Toolkit::Button button )
     mPanGestureDetector.Detach( mParent );
     mViewTimer.Start();
     mTimerReady = false;
+    mFrameTimeMonitor.Start( mContent );
   }
   else
   {
@@ -371,6 +398,7 @@ bool DissolveEffectApp::OnSildeshowButtonClicked( Toolkit::Button button )
     mPlayStopButton.SetProperty( Toolkit::Button::Property::SELECTED_STATE_IMAGE, PLAY_ICON_SELECTED );
     mTimerReady = true;
     mPanGestureDetector.Attach( mParent );
+    mFrameTimeMonitor.Stop();
   }
   return true;
 }
@@ -387,8 +415,20 @@ void DissolveEffectApp::OnTransitionCompleted( Animation& source )
   mPanGestureDetector.Attach( mCurrentImage );
   mIsTransiting = false;
 
+  if( mPendingImage )
+  {
+    mCurrentImage.SetImage( mPendingImage );
+    mPendingImage.Reset();
+  }
+
   if( mSlideshow)
   {
+    DemoHelper::FrameTimeMonitor::Statistics statistics = mFrameTimeMonitor.TakeStatistics();
+    std::cout << "Slide " << mIndex << ( mIsPrefetched ? " (prefetched)" : " (loaded on demand)" )
+              << ": transition started in " << mTransitionStartTime << " ms, "
+              << statistics.frames << " frames, mean " << statistics.mean << " ms, max " << statistics.max << " ms, "
+              << statistics.slowFrames << " slow" << std::endl;
+
     mViewTimer.Start();
     mTimerReady = false;
   }
@@ -399,11 +439,12 @@ bool DissolveEffectApp::OnTimerTick()
   mTimerReady = true;
   if(mSlideshow)
   {
+    // Only the frames of the transition itself are reported
+    mFrameTimeMonitor.TakeStatistics();
+    const double start = DemoHelper::GetMilliseconds();
+
     mIndex = (mIndex + 1)%NUM_IMAGES;
-    mNextImage = CreateStageFillingImageView( IMAGES[ mIndex ] );
-    mNextImage.SetParentOrigin( ParentOrigin::CENTER );
-    mNextImage.SetResizePolicy( ResizePolicy::FILL_TO_PARENT, Dimension::ALL_DIMENSIONS );
-    mNextImage.SetSizeScalePolicy( SizeScalePolicy::FIT_WITH_ASPECT_RATIO );
+    mNextImage = LoadImageView( mIndex );
     mNextImage.SetZ(INITIAL_DEPTH);
     mParent.Add( mNextImage );
     switch( mCentralLineIndex%4 )
@@ -431,10 +472,52 @@ bool DissolveEffectApp::OnTimerTick()
 
     }
     mCentralLineIndex++;
+
+    mTransitionStartTime = DemoHelper::GetMilliseconds() - start;
   }
   return false;   //return false to stop the timer
 }
 
+Toolkit::ImageView DissolveEffectApp::LoadImageView( unsigned int index )
+{
+  mPendingImage.Reset();
+
+  Image image = mSlides->Get( index );
+  mIsPrefetched = image;
+  if( mIsPrefetched )
+  {
+    // Already at full resolution, so drop any load still in flight for the previous image
+    mImageLoadId = 0;
+  }
+  else
+  {
+    image = DemoHelper::CreateImage( mImageLoader->LoadStageFilling( IMAGES[ index ], mImageLoadId ) );
+  }
+
+  mSlides->SetCurrent( index );
+  return CreateStageFillingImageView( image );
+}
+
+void DissolveEffectApp::OnImageLoaded( unsigned int loadId, PixelData pixelData )
+{
+  // Ignore images which have been superseded by another transition
+  if( loadId != mImageLoadId || !pixelData )
+  {
+    return;
+  }
+
+  Image image = DemoHelper::CreateImage( pixelData );
+  if( mIsTransiting )
+  {
+    // Swapping the visual would drop the dissolve shader of the image being transited to
+    mPendingImage = image;
+  }
+  else
+  {
+    mCurrentImage.SetImage( image );
+  }
+}
+
 // Entry point for Linux & Tizen applications
 int DALI_EXPORT_API main( int argc, char **argv )
 {
@@ -18,6 +18,8 @@
  */
 #include <algorithm>
 #include <cassert>
+#include <vector>
+#include <stdint.h>
 #include <dali/dali.h>
 
 /** Controls the output of application logging. */
@@ -29,6 +31,9 @@ namespace Demo
 {
 /**
  * @brief A 2D grid of booleans, settable and gettable via integer (x,y) coordinates.
+ *
+ * Each row is stored as a bitmask so that runs of set or clear cells are found a
+ * word at a time, and rows which are full are skipped by the allocator.
  * */
 class GridFlags
 {
@@ -36,7 +41,14 @@ public:
   /**
    * Create grid of specified dimensions.
    */
-  GridFlags( unsigned width, unsigned height ) :  mCells( width * height ), mWidth( width ), mHeight( height ), mHighestUsedRow( 0 )
+  GridFlags( unsigned width, unsigned height ) :
+    mWordsPerRow( ( width + BITS_PER_WORD - 1 ) / BITS_PER_WORD ),
+    mCells( mWordsPerRow * height ),
+    mWidth( width ),
+    mHeight( height ),
+    mHighestUsedRow( 0 ),
+    mFirstRowWithSpace( 0 ),
+    mCellSetTwice( false )
   {
 #ifdef DEBUG_PRINT_GRID_DIAGNOSTICS
       fprintf(stderr, "Grid created with dimensions: (%u, %u).\n", mWidth, mHeight );
@@ -45,14 +57,21 @@ public:
 
   void Set( const unsigned x, const unsigned y )
   {
-    const unsigned index = CellIndex( x, y );
-    mCells[index] += 1u; ///< += To allow a debug check of the number of times a cell is set.
+    Word& word = mCells[ WordIndex( x, y ) ];
+    const Word bit = Word( 1u ) << ( x % BITS_PER_WORD );
+    mCellSetTwice |= ( word & bit ) != 0; ///< To allow a debug check of cells being set more than once.
+    word |= bit;
     mHighestUsedRow = std::max( mHighestUsedRow, y );
+
+    while( mFirstRowWithSpace < mHeight && FindClearCell( mFirstRowWithSpace, 0, mWidth ) == mWidth )
+    {
+      ++mFirstRowWithSpace;
+    }
   }
 
   bool Get( unsigned x, unsigned y ) const
   {
-    return mCells[ CellIndex( x, y ) ] != 0;
+    return ( mCells[ WordIndex( x, y ) ] >> ( x % BITS_PER_WORD ) ) & 1u;
   }
 
   unsigned GetHighestUsedRow() const
@@ -82,6 +101,83 @@ public:
     unsigned bestCellX = 0;
     unsigned bestCellY = 0;
 
+    // Visit the clear cells in the same order as AllocateRegionByCellScan(), skipping the
+    // full rows at the top and the set cells of each row a word at a time:
+    for( unsigned y = mFirstRowWithSpace; y < mHeight; ++y )
+    {
+      for( unsigned x = FindClearCell( y, 0, mWidth ); x < mWidth; x = FindClearCell( y, x + 1, mWidth ) )
+      {
+        const unsigned clampedRegionHeight = std::min( regionHeight, mHeight - y);
+        const unsigned clampedRegionWidth = std::min( regionWidth, mWidth - x);
+        const unsigned regionLimitY = y + clampedRegionHeight;
+        const unsigned regionLimitX = x + clampedRegionWidth;
+
+        // No region from here can beat the best one, nor be an exact match as that would be bigger:
+        if( clampedRegionWidth * clampedRegionHeight <= bestRegionWidth * bestRegionHeight )
+        {
+          continue;
+        }
+
+        // Look for the first row of the region with a set cell:
+        bool wholeRegionClear = true;
+        for( unsigned regionY = y; regionY < regionLimitY; ++regionY )
+        {
+          const unsigned regionX = FindSetCell( regionY, x, regionLimitX );
+          if( regionX < regionLimitX )
+          {
+            // The region of clear cells is not big enough but remember it
+            // anyway in case there is no region that fits:
+            const unsigned clearRegionWidth = regionX - x;
+            const unsigned clearRegionHeight = (regionY + 1) - y;
+            if( clearRegionWidth * clearRegionHeight > bestRegionWidth * bestRegionHeight )
+            {
+              bestCellX = x;
+              bestCellY = y;
+              bestRegionWidth = clearRegionWidth;
+              bestRegionHeight = clearRegionHeight;
+            }
+            wholeRegionClear = false;
+            break;
+          }
+        }
+
+        if( wholeRegionClear )
+        {
+          // Every cell in the region is clear so check if it is the best one yet:
+          if( clampedRegionWidth * clampedRegionHeight > bestRegionWidth * bestRegionHeight )
+          {
+            bestCellX = x;
+            bestCellY = y;
+            bestRegionWidth = clampedRegionWidth;
+            bestRegionHeight = clampedRegionHeight;
+          }
+
+          // If a big-enough region was found, end the search early and greedily allocate it:
+          if( clampedRegionHeight == regionHeight && clampedRegionWidth == regionWidth )
+          {
+            return SetRegion( bestCellX, bestCellY, bestRegionWidth, bestRegionHeight, outCellX, outCellY, outRegion );
+          }
+        }
+      }
+    }
+
+    return SetRegion( bestCellX, bestCellY, bestRegionWidth, bestRegionHeight, outCellX, outCellY, outRegion );
+  }
+
+  /**
+   * @brief The original allocator, which rescans the whole candidate region from every clear cell.
+   *
+   * Kept as the reference for AllocateRegion(), which places regions identically.
+   */
+  bool AllocateRegionByCellScan( const Vector2& region, unsigned& outCellX, unsigned& outCellY, Vector2& outRegion )
+  {
+    const unsigned regionWidth = (region.x + 0.5f);
+    const unsigned regionHeight = (region.y + 0.5f);
+    unsigned bestRegionWidth = 0;
+    unsigned bestRegionHeight = 0;
+    unsigned bestCellX = 0;
+    unsigned bestCellY = 0;
+
     // Look for a non-set cell:
     for( unsigned y = 0; y < mHeight; ++y )
     {
@@ -139,9 +235,65 @@ whole_region_not_found:
       }
     }
 
-    // Allocate and return the best cell region found:
+    return SetRegion( bestCellX, bestCellY, bestRegionWidth, bestRegionHeight, outCellX, outCellY, outRegion );
+  }
+
+  /** @return True if every cell was set one or zero times, else false. */
+  bool DebugCheckGridValid()
+  {
+    return !mCellSetTwice;
+  }
+
+private:
+
+  typedef uint64_t Word;
+  static const unsigned BITS_PER_WORD = 64u;
+
+  unsigned WordIndex( unsigned x, unsigned y ) const
+  {
+    const unsigned offset = mWordsPerRow * y + x / BITS_PER_WORD;
+    assert( x < mWidth && offset < mCells.size() && "Out of range access to grid." );
+    return offset;
+  }
+
+  /**
+   * @return The X coordinate of the first set cell of row y in [x, limitX), or limitX if there is none.
+   */
+  unsigned FindSetCell( unsigned y, unsigned x, unsigned limitX ) const
+  {
+    return FindCell( y, x, limitX, 0u );
+  }
+
+  /**
+   * @return The X coordinate of the first clear cell of row y in [x, limitX), or limitX if there is none.
+   */
+  unsigned FindClearCell( unsigned y, unsigned x, unsigned limitX ) const
+  {
+    return FindCell( y, x, limitX, ~Word( 0u ) );
+  }
+
+  unsigned FindCell( unsigned y, unsigned x, unsigned limitX, Word invert ) const
+  {
+    const Word* row = &mCells[ mWordsPerRow * y ];
+    while( x < limitX )
+    {
+      const unsigned wordIndex = x / BITS_PER_WORD;
+      const Word word = ( row[ wordIndex ] ^ invert ) >> ( x % BITS_PER_WORD );
+      if( word )
+      {
+        return std::min( x + static_cast<unsigned>( __builtin_ctzll( word ) ), limitX );
+      }
+      x = ( wordIndex + 1 ) * BITS_PER_WORD;
+    }
+    return limitX;
+  }
 
-    if( bestRegionWidth == 0 || bestRegionHeight == 0 )
+  /**
+   * Sets the cells of the region found by an allocator.
+   */
+  bool SetRegion( unsigned cellX, unsigned cellY, unsigned regionWidth, unsigned regionHeight, unsigned& outCellX, unsigned& outCellY, Vector2& outRegion )
+  {
+    if( regionWidth == 0 || regionHeight == 0 )
     {
 #ifdef DEBUG_PRINT_GRID_DIAGNOSTICS
         fputs( "false.\n", stderr );
@@ -151,50 +303,32 @@ whole_region_not_found:
 
     // Allocate the found region:
 #ifdef DEBUG_PRINT_GRID_DIAGNOSTICS
-      fprintf( stderr, " - bestCellX = %u, bestCellY = %u, bestRegionWidth = %u, bestRegionHeight = %u - ", bestCellX, bestCellY, bestRegionWidth, bestRegionHeight );
+      fprintf( stderr, " - bestCellX = %u, bestCellY = %u, bestRegionWidth = %u, bestRegionHeight = %u - ", cellX, cellY, regionWidth, regionHeight );
 #endif
-    for( unsigned y = bestCellY; y < bestCellY + bestRegionHeight; ++y )
+    for( unsigned y = cellY; y < cellY + regionHeight; ++y )
     {
-      for( unsigned x = bestCellX; x < bestCellX + bestRegionWidth; ++x )
+      for( unsigned x = cellX; x < cellX + regionWidth; ++x )
       {
         Set( x, y );
       }
     }
 
-    outCellX = bestCellX;
-    outCellY = bestCellY;
-    outRegion = Vector2( bestRegionWidth, bestRegionHeight );
+    outCellX = cellX;
+    outCellY = cellY;
+    outRegion = Vector2( regionWidth, regionHeight );
 #ifdef DEBUG_PRINT_GRID_DIAGNOSTICS
       fputs( "true.\n", stderr );
 #endif
     return true;
   }
 
-  /** @return True if every cell was set one or zero times, else false. */
-  bool DebugCheckGridValid()
-  {
-    for( unsigned cell = 0; cell < mWidth * mHeight; ++cell )
-    {
-      if( mCells[cell] > 1 )
-      {
-        return false;
-      }
-    }
-    return true;
-  }
-
-private:
-  unsigned CellIndex( unsigned x, unsigned y ) const
-  {
-    const unsigned offset = mWidth * y + x;
-    assert( offset < mCells.size() && "Out of range access to grid." );
-    return offset;
-  }
-
-  std::vector<unsigned char> mCells;
+  const unsigned mWordsPerRow;
+  std::vector<Word> mCells;    ///< One bit per cell, each row starting on a new word
   const unsigned mWidth;
   const unsigned mHeight;
   unsigned mHighestUsedRow;
+  unsigned mFirstRowWithSpace; ///< Every row above this one is full
+  bool mCellSetTwice;
 };
 
 } /* namespace Demo */
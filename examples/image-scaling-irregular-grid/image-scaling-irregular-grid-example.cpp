@@ -44,12 +44,16 @@
 // EXTERNAL INCLUDES
 #include <algorithm>
 #include <map>
+#include <cstdlib>
+#include <cstring>
 #include <dali-toolkit/dali-toolkit.h>
 #include <iostream>
 
 // INTERNAL INCLUDES
 #include "grid-flags.h"
+#include "shared/utility.h"
 #include "shared/view.h"
+#include "shared/worker-pool.h"
 
 using namespace Dali;
 using namespace Dali::Toolkit;
@@ -75,6 +79,15 @@ const unsigned GRID_MAX_HEIGHT = 600;
 /** The space between the edge of a grid cell and the image embedded within it. */
 const unsigned GRID_CELL_PADDING = 4;
 
+/** Only create image actors within this many screen heights above and below the visible part of a virtualized field. */
+const float VIRTUAL_FIELD_MARGIN = 0.5f;
+
+/** Whether to create image actors only for the visible part of the field, recycling them as it scrolls. */
+bool VIRTUALIZE_FIELD = false;
+
+/** The number of fitting modes cycled through: SHRINK_TO_FIT, SCALE_TO_FILL, FIT_WIDTH and FIT_HEIGHT. */
+const unsigned NUM_FITTING_MODES = 4u;
+
 /** The aspect ratio of cells in the image grid. */
 const float CELL_ASPECT_RATIO = 1.33333333333333333333f;
 
@@ -257,6 +270,49 @@ struct PositionedImage
   Vector2 imageGridDims;
 };
 
+/**
+ * An image of the field, in its parent's frame. Its actor is empty while a virtualized field is scrolled away from it.
+ */
+struct FieldImage
+{
+  FieldImage( const char * const path, const Vector2& position, const Vector2& size, Dali::FittingMode::Type fittingMode ) :
+    path( path ),
+    position( position ),
+    size( size ),
+    fittingMode( fittingMode ),
+    requestedVariants( 0u ),
+    generation( 0u ),
+    modeSwitchPending( false ),
+    prefetching( false )
+  {}
+
+  float GetTop() const
+  {
+    return position.y - size.y * 0.5f;
+  }
+
+  float GetBottom() const
+  {
+    return position.y + size.y * 0.5f;
+  }
+
+  bool operator<( const FieldImage& rhs ) const
+  {
+    return GetTop() < rhs.GetTop();
+  }
+
+  const char * path;
+  Vector2 position;
+  Vector2 size;
+  Dali::FittingMode::Type fittingMode;
+  ImageView actor;
+  Image variants[NUM_FITTING_MODES]; ///< The image resampled in each fitting mode, once the worker pool has produced it.
+  unsigned requestedVariants;        ///< A bit per fitting mode which has been queued for resampling.
+  unsigned generation;               ///< Incremented when the variants are dropped, so that late ones are ignored.
+  bool modeSwitchPending;            ///< Whether the field's last mode switch is waiting for this image's variant.
+  bool prefetching;                  ///< Whether the image is in view, so its next fitting mode is resampled ahead.
+};
+
 }
 
 /**
@@ -268,7 +324,11 @@ public:
 
   ImageScalingIrregularGridController( Application& application )
   : mApplication( application ),
-    mScrolling( false )
+    mScrolling( false ),
+    mMaxImageHeight( 0.0f ),
+    mResamplePool( NULL ),
+    mModeSwitchPendingCount( 0u ),
+    mModeSwitchStartTime( 0.0 )
   {
     std::cout << "ImageScalingIrregularGridController::ImageScalingIrregularGridController" << std::endl;
 
@@ -278,7 +338,7 @@ public:
 
   ~ImageScalingIrregularGridController()
   {
-    // Nothing to do here.
+    delete mResamplePool;
   }
 
   /**
@@ -314,6 +374,9 @@ public:
 
     SetTitle( APPLICATION_TITLE );
 
+    // Resample the images of the field in every fitting mode in the background, on all CPUs:
+    mResamplePool = new DemoHelper::WorkerPool( 0u );
+
     // Build the main content of the widow:
     PopulateContentLayer( DEFAULT_SCALING_MODE );
   }
@@ -334,6 +397,10 @@ public:
     mScrollView.ScrollStartedSignal().Connect( this, &ImageScalingIrregularGridController::OnScrollStarted );
     mScrollView.ScrollCompletedSignal().Connect( this, &ImageScalingIrregularGridController::OnScrollCompleted );
 
+    // Update the images of the field every time it scrolls by a cell:
+    mScrollView.SetScrollUpdateDistance( stageSize.x / GRID_WIDTH / CELL_ASPECT_RATIO );
+    mScrollView.ScrollUpdatedSignal().Connect( this, &ImageScalingIrregularGridController::OnScrollUpdated );
+
     mScrollView.SetAnchorPoint(AnchorPoint::CENTER);
     mScrollView.SetParentOrigin(ParentOrigin::CENTER);
 
@@ -349,7 +416,8 @@ public:
     mScrollView.SetRulerX ( rulerX );
 
     RulerPtr rulerY = new DefaultRuler(); //< Snap in multiples of a screen / stage height
-    rulerY->SetDomain( RulerDomain( - fieldHeight * 0.5f + stageSize.height * 0.5f - GRID_CELL_PADDING, fieldHeight * 0.5f + stageSize.height * 0.5f + GRID_CELL_PADDING ) );
+    const float topScrollPosition = - fieldHeight * 0.5f + stageSize.height * 0.5f - GRID_CELL_PADDING;
+    rulerY->SetDomain( RulerDomain( topScrollPosition, fieldHeight * 0.5f + stageSize.height * 0.5f + GRID_CELL_PADDING ) );
     mScrollView.SetRulerY ( rulerY );
 
     mContentLayer.Add( mScrollView );
@@ -375,6 +443,15 @@ public:
 
     // Scroll to top of grid so first images loaded are on-screen:
     mScrollView.ScrollTo( Vector2( 0, -1000000 ) );
+
+    if( VIRTUALIZE_FIELD )
+    {
+      UpdateVisibleImages( topScrollPosition );
+    }
+    else
+    {
+      UpdatePrefetchedImages( topScrollPosition );
+    }
   }
 
   void OnScrollViewRelayout(Actor actor)
@@ -450,7 +527,10 @@ public:
     outFieldHeight = actualGridHeight * cellHeight;
     const Vector2 gridOrigin = Vector2( -fieldWidth * 0.5f, -outFieldHeight * 0.5 );
 
-    // Build the image actors in their right locations in their parent's frame:
+    // Work out the images' locations in their parent's frame:
+    mFieldImages.clear();
+    mFieldImages.reserve( placedImages.size() );
+    mMaxImageHeight = 0.0f;
     for( std::vector<PositionedImage>::const_iterator i = placedImages.begin(), end = placedImages.end(); i != end; ++i )
     {
       const PositionedImage& imageSource = *i;
@@ -458,20 +538,292 @@ public:
       const Vector2 imageRegionCorner = gridOrigin + cellSize * Vector2( imageSource.cellX, imageSource.cellY );
       const Vector2 imagePosition = imageRegionCorner + Vector2( GRID_CELL_PADDING , GRID_CELL_PADDING ) + imageSize * 0.5f;
 
-      ImageView image = CreateImageView( imageSource.configuration.path, imageSize.x, imageSize.y, fittingMode );
-      image.SetPosition( Vector3( imagePosition.x, imagePosition.y, 0 ) );
-      image.SetSize( imageSize );
-      image.TouchSignal().Connect( this, &ImageScalingIrregularGridController::OnTouchImage );
-      mFittingModes[image.GetId()] = fittingMode;
-      mResourceUrls[image.GetId()] = imageSource.configuration.path;
-      mSizes[image.GetId()] = imageSize;
+      mFieldImages.push_back( FieldImage( imageSource.configuration.path, imagePosition, imageSize, fittingMode ) );
+      mMaxImageHeight = std::max( mMaxImageHeight, imageSize.y );
+    }
+
+    // Sorted from top to bottom so the images overlapping a band of the field are found by binary search:
+    std::sort( mFieldImages.begin(), mFieldImages.end() );
+    mGridActor = gridActor;
 
-      gridActor.Add( image );
+    // A virtualized field only gets the actors it needs when it is scrolled:
+    if( !VIRTUALIZE_FIELD )
+    {
+      const double start = DemoHelper::GetMilliseconds();
+      for( unsigned i = 0; i < mFieldImages.size(); ++i )
+      {
+        AcquireImageView( i );
+      }
+      std::cout << "Created " << mFieldImages.size() << " image actors in " << DemoHelper::GetMilliseconds() - start << " ms" << std::endl;
     }
 
     return gridActor;
   }
 
+  /**
+   * Creates the actor of an image of the field, reusing one which has been scrolled away from if there is one.
+   */
+  void AcquireImageView( unsigned index )
+  {
+    FieldImage& fieldImage = mFieldImages[index];
+
+    if( !mSpareImageViews.empty() )
+    {
+      fieldImage.actor = mSpareImageViews.back();
+      mSpareImageViews.pop_back();
+      fieldImage.actor.SetImage( CreateImage( fieldImage.path, fieldImage.size.x, fieldImage.size.y, fieldImage.fittingMode ) );
+      fieldImage.actor.SetName( fieldImage.path );
+      fieldImage.actor.SetOrientation( Quaternion::IDENTITY );
+    }
+    else
+    {
+      fieldImage.actor = CreateImageView( fieldImage.path, fieldImage.size.x, fieldImage.size.y, fieldImage.fittingMode );
+      fieldImage.actor.TouchSignal().Connect( this, &ImageScalingIrregularGridController::OnTouchImage );
+    }
+
+    fieldImage.actor.SetPosition( Vector3( fieldImage.position.x, fieldImage.position.y, 0 ) );
+    fieldImage.actor.SetSize( fieldImage.size );
+    mImageIndices[ fieldImage.actor.GetId() ] = index;
+
+    mGridActor.Add( fieldImage.actor );
+  }
+
+  /**
+   * Queues the resampling of an image of the field in a fitting mode, unless it has been already.
+   */
+  void RequestVariant( unsigned index, Dali::FittingMode::Type fittingMode, bool urgent = false )
+  {
+    FieldImage& fieldImage = mFieldImages[index];
+    const unsigned variantBit = 1u << fittingMode;
+    if( fieldImage.requestedVariants & variantBit )
+    {
+      return;
+    }
+    fieldImage.requestedVariants |= variantBit;
+
+    BitmapLoader loader = BitmapLoader::New( fieldImage.path, ImageDimensions( fieldImage.size.x, fieldImage.size.y ), fittingMode, Dali::SamplingMode::BOX_THEN_LINEAR );
+    mResamplePool->AddTask( new ResampleTask( *this, index, fieldImage.generation, fittingMode, loader ), urgent );
+  }
+
+  /**
+   * Called on the event thread with an image of the field resampled in a fitting mode.
+   * It is shown straight away if the image has switched to that mode while it was resampled.
+   */
+  void OnVariantResampled( unsigned index, unsigned generation, Dali::FittingMode::Type fittingMode, PixelData pixelData )
+  {
+    FieldImage& fieldImage = mFieldImages[index];
+    if( generation != fieldImage.generation || !( fieldImage.requestedVariants & ( 1u << fittingMode ) ) || !pixelData )
+    {
+      // The actor has been reused, or the variant has been released since it was requested
+      return;
+    }
+
+    fieldImage.variants[fittingMode] = DemoHelper::CreateImage( pixelData );
+
+    if( fieldImage.actor && fittingMode == fieldImage.fittingMode )
+    {
+      fieldImage.actor.SetImage( fieldImage.variants[fittingMode] );
+
+      if( fieldImage.modeSwitchPending )
+      {
+        fieldImage.modeSwitchPending = false;
+        CompleteModeSwitch();
+      }
+    }
+  }
+
+  /**
+   * Switches an image of the field to a fitting mode.
+   * @return true if the variant was ready and is shown, false if it is shown once it has been resampled
+   */
+  bool SetFittingMode( unsigned index, Dali::FittingMode::Type fittingMode )
+  {
+    FieldImage& fieldImage = mFieldImages[index];
+    fieldImage.fittingMode = fittingMode;
+
+    // Only the mode shown and, in view, the next one are kept:
+    ReleaseVariants( index );
+    if( fieldImage.prefetching )
+    {
+      RequestVariant( index, NextMode( fittingMode ) );
+    }
+
+    // Images without an actor are loaded with their new mode when they are scrolled to:
+    if( !fieldImage.actor || fieldImage.variants[fittingMode] )
+    {
+      if( fieldImage.actor )
+      {
+        fieldImage.actor.SetImage( fieldImage.variants[fittingMode] );
+      }
+      return true;
+    }
+
+    RequestVariant( index, fittingMode, true );
+    return false;
+  }
+
+  /**
+   * Releases the variants of an image of the field other than those of its current mode and, while it is
+   * prefetched, the next one. Those still being resampled are ignored when they arrive.
+   */
+  void ReleaseVariants( unsigned index )
+  {
+    FieldImage& fieldImage = mFieldImages[index];
+    unsigned keptVariants = 1u << fieldImage.fittingMode;
+    if( fieldImage.prefetching )
+    {
+      keptVariants |= 1u << NextMode( fieldImage.fittingMode );
+    }
+
+    for( unsigned i = 0; i < NUM_FITTING_MODES; ++i )
+    {
+      if( !( keptVariants & ( 1u << i ) ) )
+      {
+        fieldImage.variants[i].Reset();
+      }
+    }
+    fieldImage.requestedVariants &= keptVariants;
+  }
+
+  /**
+   * Resamples the next fitting mode ahead for the images in view, so that the scaling button can show it
+   * straight away, and releases the variants of the images which have left the view. In a virtualized field,
+   * the images with actors are the ones in view.
+   * @param[in] scrollPosition The vertical scroll position of the field, which is at the centre of the view
+   */
+  void UpdatePrefetchedImages( float scrollPosition )
+  {
+    std::vector<unsigned> prefetchedImages;
+    if( VIRTUALIZE_FIELD )
+    {
+      prefetchedImages = mVisibleImages;
+    }
+    else
+    {
+      const float viewHeight = Stage::GetCurrent().GetSize().height;
+      const float top = scrollPosition - viewHeight * 0.5f;
+      const float bottom = scrollPosition + viewHeight * 0.5f;
+      const FieldImage firstCandidate( "", Vector2( 0.0f, top - mMaxImageHeight * 0.5f ), Vector2( 0.0f, mMaxImageHeight ), FittingMode::DEFAULT );
+      for( std::vector<FieldImage>::const_iterator i = std::lower_bound( mFieldImages.begin(), mFieldImages.end(), firstCandidate ), end = mFieldImages.end();
+           i != end && i->GetTop() <= bottom; ++i )
+      {
+        if( i->GetBottom() >= top )
+        {
+          prefetchedImages.push_back( i - mFieldImages.begin() );
+        }
+      }
+    }
+
+    for( std::vector<unsigned>::const_iterator i = mPrefetchedImages.begin(), end = mPrefetchedImages.end(); i != end; ++i )
+    {
+      mFieldImages[*i].prefetching = false;
+    }
+    for( std::vector<unsigned>::const_iterator i = prefetchedImages.begin(), end = prefetchedImages.end(); i != end; ++i )
+    {
+      FieldImage& fieldImage = mFieldImages[*i];
+      if( !fieldImage.prefetching )
+      {
+        fieldImage.prefetching = true;
+        RequestVariant( *i, NextMode( fieldImage.fittingMode ) );
+      }
+    }
+    for( std::vector<unsigned>::const_iterator i = mPrefetchedImages.begin(), end = mPrefetchedImages.end(); i != end; ++i )
+    {
+      if( !mFieldImages[*i].prefetching )
+      {
+        ReleaseVariants( *i );
+      }
+    }
+
+    mPrefetchedImages.swap( prefetchedImages );
+  }
+
+  /**
+   * Counts down the images a mode switch of the whole field is waiting for, printing the time it took after the last one.
+   */
+  void CompleteModeSwitch()
+  {
+    if( mModeSwitchPendingCount > 0u && --mModeSwitchPendingCount == 0u )
+    {
+      std::cout << "Fitting mode switch of the field completed in " << DemoHelper::GetMilliseconds() - mModeSwitchStartTime << " ms" << std::endl;
+    }
+  }
+
+  /**
+   * Removes the actor of an image of the field and keeps it for reuse. Its image is released.
+   */
+  void ReleaseImageView( unsigned index )
+  {
+    FieldImage& fieldImage = mFieldImages[index];
+
+    mImageIndices.erase( fieldImage.actor.GetId() );
+    fieldImage.actor.Unparent();
+    fieldImage.actor.SetImage( Image() );
+    mSpareImageViews.push_back( fieldImage.actor );
+    fieldImage.actor.Reset();
+
+    // Drop the variants too, those still being resampled are ignored when they arrive:
+    for( unsigned i = 0; i < NUM_FITTING_MODES; ++i )
+    {
+      fieldImage.variants[i].Reset();
+    }
+    fieldImage.requestedVariants = 0u;
+    ++fieldImage.generation;
+
+    if( fieldImage.modeSwitchPending )
+    {
+      fieldImage.modeSwitchPending = false;
+      CompleteModeSwitch();
+    }
+  }
+
+  /**
+   * Creates the actors of the images around the visible part of a virtualized field and releases the rest.
+   * @param[in] scrollPosition The vertical scroll position of the field, which is at the centre of the view
+   */
+  void UpdateVisibleImages( float scrollPosition )
+  {
+    const float viewHeight = Stage::GetCurrent().GetSize().height;
+    const float top = scrollPosition - viewHeight * ( 0.5f + VIRTUAL_FIELD_MARGIN );
+    const float bottom = scrollPosition + viewHeight * ( 0.5f + VIRTUAL_FIELD_MARGIN );
+
+    // Release the actors of the images which are now outside the band:
+    std::vector<unsigned> visibleImages;
+    for( std::vector<unsigned>::const_iterator i = mVisibleImages.begin(), end = mVisibleImages.end(); i != end; ++i )
+    {
+      const FieldImage& fieldImage = mFieldImages[*i];
+      if( fieldImage.GetBottom() < top || fieldImage.GetTop() > bottom )
+      {
+        ReleaseImageView( *i );
+      }
+      else
+      {
+        visibleImages.push_back( *i );
+      }
+    }
+
+    // No image starting above the band less the tallest image can reach into it:
+    const FieldImage firstCandidate( "", Vector2( 0.0f, top - mMaxImageHeight * 0.5f ), Vector2( 0.0f, mMaxImageHeight ), FittingMode::DEFAULT );
+    for( std::vector<FieldImage>::iterator i = std::lower_bound( mFieldImages.begin(), mFieldImages.end(), firstCandidate ), end = mFieldImages.end();
+         i != end && i->GetTop() <= bottom; ++i )
+    {
+      if( !i->actor && i->GetBottom() >= top )
+      {
+        const unsigned index = i - mFieldImages.begin();
+        AcquireImageView( index );
+        visibleImages.push_back( index );
+      }
+    }
+
+    mVisibleImages.swap( visibleImages );
+    UpdatePrefetchedImages( scrollPosition );
+
+#ifdef DEBUG_PRINT_DIAGNOSTICS
+    fprintf( stderr, "Virtualized field: %u of %u images have actors, %u spare.\n",
+             unsigned( mVisibleImages.size() ), unsigned( mFieldImages.size() ), unsigned( mSpareImageViews.size() ) );
+#endif
+  }
+
  /**
   * Upon Touching an image (Release), change its scaling mode and make it spin, provided we're not scrolling.
   * @param[in] actor The actor touched
@@ -489,18 +841,11 @@ public:
         animation.Play();
 
         // Change the scaling mode:
-        const unsigned id = actor.GetId();
-        Dali::FittingMode::Type newMode = NextMode( mFittingModes[id] );
-        const Vector2 imageSize = mSizes[actor.GetId()];
-
-        const std::string& url = mResourceUrls[id];
-        Image newImage = CreateImage( url, imageSize.width + 0.5f, imageSize.height + 0.5f, newMode );
-        ImageView imageView = ImageView::DownCast( actor );
-        if(imageView)
+        std::map<unsigned, unsigned>::const_iterator index = mImageIndices.find( actor.GetId() );
+        if( index != mImageIndices.end() )
         {
-          imageView.SetImage( newImage );
+          SetFittingMode( index->second, NextMode( mFieldImages[ index->second ].fittingMode ) );
         }
-        mFittingModes[id] = newMode;
       }
     }
     return false;
@@ -529,26 +874,24 @@ public:
   */
   bool OnToggleScalingTouched( Button button )
   {
-    const unsigned numChildren = mGridActor.GetChildCount();
+    mModeSwitchStartTime = DemoHelper::GetMilliseconds();
+    mModeSwitchPendingCount = 0u;
 
-    for( unsigned i = 0; i < numChildren; ++i )
+    for( unsigned i = 0; i < mFieldImages.size(); ++i )
     {
-      ImageView gridImageView = ImageView::DownCast( mGridActor.GetChildAt( i ) );
-      if( gridImageView )
+      // Cycle the scaling mode options, showing the variants already resampled in the background straight away:
+      Dali::FittingMode::Type newMode = NextMode( mFieldImages[i].fittingMode );
+      mFieldImages[i].modeSwitchPending = !SetFittingMode( i, newMode );
+      if( mFieldImages[i].modeSwitchPending )
       {
-        // Cycle the scaling mode options:
-        unsigned int id = gridImageView.GetId();
-
-        const Vector2 imageSize = mSizes[ id ];
-        Dali::FittingMode::Type newMode = NextMode( mFittingModes[ id ] );
-        Image newImage = CreateImage( mResourceUrls[ id ], imageSize.width, imageSize.height, newMode );
-        gridImageView.SetImage( newImage );
-
-        mFittingModes[ id ] = newMode;
-
-        SetTitle( std::string( newMode == FittingMode::SHRINK_TO_FIT ? "SHRINK_TO_FIT" : newMode == FittingMode::SCALE_TO_FILL ?  "SCALE_TO_FILL" : newMode == FittingMode::FIT_WIDTH ? "FIT_WIDTH" : "FIT_HEIGHT" ) );
+        ++mModeSwitchPendingCount;
       }
+
+      SetTitle( std::string( newMode == FittingMode::SHRINK_TO_FIT ? "SHRINK_TO_FIT" : newMode == FittingMode::SCALE_TO_FILL ?  "SCALE_TO_FILL" : newMode == FittingMode::FIT_WIDTH ? "FIT_WIDTH" : "FIT_HEIGHT" ) );
     }
+
+    std::cout << "Fitting mode switch of the field: " << mModeSwitchPendingCount << " images waiting for resampling after "
+              << DemoHelper::GetMilliseconds() - mModeSwitchStartTime << " ms" << std::endl;
     return true;
   }
 
@@ -586,8 +929,60 @@ public:
   void OnScrollCompleted( const Vector2& position )
   {
     mScrolling = false;
+    OnScrollUpdated( position );
+  }
+
+  /**
+   * Called every time the field has scrolled by a cell.
+   * @param[in] position Current Scroll Position
+   */
+  void OnScrollUpdated( const Vector2& position )
+  {
+    if( VIRTUALIZE_FIELD )
+    {
+      UpdateVisibleImages( mScrollView.GetCurrentScrollPosition().y );
+    }
+    else
+    {
+      UpdatePrefetchedImages( mScrollView.GetCurrentScrollPosition().y );
+    }
   }
 
+private:
+
+  /**
+   * Resamples an image of the field in a fitting mode on a worker thread.
+   */
+  class ResampleTask : public DemoHelper::WorkerTask
+  {
+  public:
+    ResampleTask( ImageScalingIrregularGridController& controller, unsigned index, unsigned generation, Dali::FittingMode::Type fittingMode, BitmapLoader loader )
+    : mController( controller ),
+      mLoader( loader ),
+      mIndex( index ),
+      mGeneration( generation ),
+      mFittingMode( fittingMode )
+    {
+    }
+
+    virtual void Process()
+    {
+      mLoader.Load();
+    }
+
+    virtual void Complete()
+    {
+      mController.OnVariantResampled( mIndex, mGeneration, mFittingMode, mLoader.GetPixelData() );
+    }
+
+  private:
+    ImageScalingIrregularGridController& mController;
+    BitmapLoader mLoader;
+    unsigned mIndex;
+    unsigned mGeneration;
+    Dali::FittingMode::Type mFittingMode;
+  };
+
 private:
   Application&  mApplication;
 
@@ -600,11 +995,84 @@ private:
   ScrollBar mScrollBarVertical;
   ScrollBar mScrollBarHorizontal;
   bool mScrolling;                    ///< ScrollView scrolling state (true = scrolling, false = stationary)
-  std::map<unsigned, Dali::FittingMode::Type> mFittingModes; ///< Stores the current scaling mode of each image, keyed by image actor id.
-  std::map<unsigned, std::string> mResourceUrls; ///< Stores the url of each image, keyed by image actor id.
-  std::map<unsigned, Vector2> mSizes; ///< Stores the current size of each image, keyed by image actor id.
+  std::vector<FieldImage> mFieldImages; ///< Every image of the field, sorted from top to bottom.
+  float mMaxImageHeight;              ///< The height of the tallest image of the field.
+  std::map<unsigned, unsigned> mImageIndices; ///< The index in mFieldImages of each image actor, keyed by image actor id.
+  std::vector<unsigned> mVisibleImages; ///< The images of a virtualized field which have actors.
+  std::vector<unsigned> mPrefetchedImages; ///< The images in view, whose next fitting mode is resampled ahead.
+  std::vector<ImageView> mSpareImageViews; ///< Image actors of a virtualized field waiting to be reused.
+  DemoHelper::WorkerPool* mResamplePool; ///< Resamples the images of the field in each fitting mode.
+  unsigned mModeSwitchPendingCount;   ///< The number of images the last mode switch of the field is waiting for.
+  double mModeSwitchStartTime;
 };
 
+namespace
+{
+
+/**
+ * Places thousands of images with GridFlags::AllocateRegion() and the original cell scan,
+ * checks that both give the same placements and prints the time each took.
+ * @return false if the placements differ
+ */
+bool RunGridBenchmark()
+{
+  const unsigned IMAGE_COUNTS[] = { 1000u, 5000u, 10000u };
+  bool identical = true;
+
+  for( unsigned countIndex = 0; countIndex < sizeof( IMAGE_COUNTS ) / sizeof( IMAGE_COUNTS[0] ); ++countIndex )
+  {
+    const unsigned imageCount = IMAGE_COUNTS[countIndex];
+
+    // Some images are shrunk to fit holes, so the grid only fills up at the end:
+    const unsigned gridHeight = imageCount * 2u;
+
+    std::vector<Vector2> regions;
+    regions.reserve( imageCount );
+    srand( imageCount );
+    for( unsigned i = 0; i < imageCount; ++i )
+    {
+      regions.push_back( IMAGE_SIZES[ rand() % NUM_IMAGE_SIZES ] );
+    }
+
+    GridFlags grid( GRID_WIDTH, gridHeight );
+    std::vector<Vector4> placements;
+    placements.reserve( imageCount );
+    double start = DemoHelper::GetMilliseconds();
+    for( unsigned i = 0; i < imageCount; ++i )
+    {
+      unsigned cellX = 0, cellY = 0;
+      Vector2 region;
+      const bool allocated = grid.AllocateRegion( regions[i], cellX, cellY, region );
+      placements.push_back( allocated ? Vector4( cellX, cellY, region.x, region.y ) : Vector4::ZERO );
+    }
+    const double allocateTime = DemoHelper::GetMilliseconds() - start;
+
+    GridFlags referenceGrid( GRID_WIDTH, gridHeight );
+    unsigned differences = 0;
+    start = DemoHelper::GetMilliseconds();
+    for( unsigned i = 0; i < imageCount; ++i )
+    {
+      unsigned cellX = 0, cellY = 0;
+      Vector2 region;
+      const bool allocated = referenceGrid.AllocateRegionByCellScan( regions[i], cellX, cellY, region );
+      if( placements[i] != ( allocated ? Vector4( cellX, cellY, region.x, region.y ) : Vector4::ZERO ) )
+      {
+        ++differences;
+      }
+    }
+    const double scanTime = DemoHelper::GetMilliseconds() - start;
+
+    std::cout << imageCount << " images: AllocateRegion " << allocateTime << " ms, cell scan " << scanTime << " ms, "
+              << differences << " placements differ" << std::endl;
+
+    identical = identical && differences == 0 && grid.DebugCheckGridValid();
+  }
+
+  return identical;
+}
+
+} // unnamed namespace
+
 void RunTest( Application& application )
 {
   ImageScalingIrregularGridController test( application );
@@ -615,6 +1083,19 @@ void RunTest( Application& application )
 /** Entry point for Linux & Tizen applications */
 int DALI_EXPORT_API main( int argc, char **argv )
 {
+  if( argc > 1 && strcmp( argv[1], "--benchmark" ) == 0 )
+  {
+    return RunGridBenchmark() ? 0 : 1;
+  }
+
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--virtualized" ) == 0 )
+    {
+      VIRTUALIZE_FIELD = true;
+    }
+  }
+
   Application application = Application::New( &argc, &argv, DEMO_THEME_PATH );
 
   RunTest( application );
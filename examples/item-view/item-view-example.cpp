@@ -15,8 +15,17 @@
  *
  */
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
 #include <sstream>
+#include <vector>
+#include "shared/frame-time-monitor.h"
+#include "shared/utility.h"
 #include "shared/view.h"
+#include "shared/worker-pool.h"
 
 #include <dali/dali.h>
 #include <dali-toolkit/dali-toolkit.h>
@@ -135,6 +144,24 @@ const Vector3 INITIAL_OFFSCREEN_POSITION( 1000.0f, 0, -1000.0f );
 
 const float SCROLL_TO_ITEM_ANIMATION_TIME = 5.f;
 
+const unsigned int MAX_RECYCLED_ITEMS = 64u;            ///< More than the item view keeps around the visible range, so flings never allocate once warmed up
+
+const unsigned int FLING_BENCHMARK_COUNT = 8u;          ///< The number of scrolls from one end of the items to the other
+const float FLING_BENCHMARK_DURATION = 0.75f;           ///< The duration of each scroll in seconds
+const unsigned int FLING_BENCHMARK_SETTLE_TIME = 500u;  ///< The time between scrolls in milliseconds
+
+const float ASYNC_ITEM_FRAME_BUDGET = 4.0f;             ///< The time spent adding decoded images and decorations to items per frame, in milliseconds
+const unsigned int ASYNC_ITEM_POPULATE_INTERVAL = 16u;  ///< The interval at which decoded items are populated, in milliseconds
+const Vector4 PLACEHOLDER_COLOR( 0.3f, 0.3f, 0.3f, 1.0f );
+
+const unsigned int SELECTION_BENCHMARK_ITEMS = 5000u;     ///< The number of decorated items the selection benchmark creates
+const unsigned int SELECTION_BENCHMARK_SELECTED = 50u;    ///< The number of those which are selected
+
+bool RECYCLE_ITEMS = true;                              ///< Cleared by --no-recycling to allocate a new actor subtree for every item
+bool ASYNC_ITEMS = false;                               ///< Set by --async-items to show placeholders and decode item images on worker threads
+bool SELECTION_BENCHMARK = false;                       ///< Set by --selection-benchmark to time the edit mode bookkeeping with thousands of items, and quit
+bool FLING_BENCHMARK = false;                           ///< Set by --fling-benchmark to fling across the items, print item and frame statistics, and quit
+
 static Vector3 DepthLayoutItemSizeFunctionPortrait( float layoutWidth )
 {
   float width = ( layoutWidth / ( DEPTH_LAYOUT_COLUMNS + 1.0f ) ) * DEPTH_LAYOUT_ITEM_SIZE_FACTOR_PORTRAIT;
@@ -184,12 +211,26 @@ public:
     mMode( MODE_NORMAL ),
     mOrientation( 0 ),
     mCurrentLayout( SPIRAL_LAYOUT ),
-    mDurationSeconds( 0.25f )
+    mDurationSeconds( 0.25f ),
+    mFlingCount( 0u ),
+    mItemsCreated( 0u ),
+    mItemsRecycled( 0u ),
+    mNewItemTime( 0.0 ),
+    mItemDecodePool( NULL ),
+    mItemRequestCounter( 0u ),
+    mItemsPopulated( 0u ),
+    mLongestPopulateTime( 0.0 ),
+    mCheckBoxesVisible( false )
   {
     // Connect to the Application's Init signal
     mApplication.InitSignal().Connect(this, &ItemViewExample::OnInit);
   }
 
+  ~ItemViewExample()
+  {
+    delete mItemDecodePool;
+  }
+
   /**
    * This method gets called once the main loop of application is up and running
    */
@@ -277,6 +318,17 @@ public:
     mItemView.SetParentOrigin(ParentOrigin::CENTER);
     mItemView.SetAnchorPoint(AnchorPoint::CENTER);
 
+    mTapDetector = TapGestureDetector::New();
+    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::OnItemTap );
+
+    if( ASYNC_ITEMS )
+    {
+      // Leave a core for the event and update threads
+      mItemDecodePool = new DemoHelper::WorkerPool( std::max( DemoHelper::WorkerPool::GetCpuCount(), 2u ) - 1u );
+      mPopulateTimer = Timer::New( ASYNC_ITEM_POPULATE_INTERVAL );
+      mPopulateTimer.TickSignal().Connect( this, &ItemViewExample::OnPopulateTimer );
+    }
+
     // Display item view on the stage
     stage.Add( mItemView );
     stage.GetRootLayer().SetBehavior( Layer::LAYER_3D );
@@ -306,6 +358,128 @@ public:
     mLongPressDetector = LongPressGestureDetector::New();
     mLongPressDetector.Attach( mItemView );
     mLongPressDetector.DetectedSignal().Connect( this, &ItemViewExample::OnLongPress );
+
+    if( SELECTION_BENCHMARK )
+    {
+      RunSelectionBenchmark();
+      mApplication.Quit();
+      return;
+    }
+
+    if( FLING_BENCHMARK )
+    {
+      mFrameTimeMonitor.Start( stage.GetRootLayer() );
+      mFlingTimer = Timer::New( static_cast< unsigned int >( FLING_BENCHMARK_DURATION * 1000.0f ) + FLING_BENCHMARK_SETTLE_TIME );
+      mFlingTimer.TickSignal().Connect( this, &ItemViewExample::OnFlingTimer );
+      mFlingTimer.Start();
+    }
+  }
+
+  /**
+   * Prints the statistics of the last fling and starts the next one, or quits after the last.
+   */
+  bool OnFlingTimer()
+  {
+    const DemoHelper::FrameTimeMonitor::Statistics frames = mFrameTimeMonitor.TakeStatistics();
+    if( mFlingCount > 0u )
+    {
+      std::cout << "Fling " << mFlingCount << ": " << mItemsCreated << " items created, " << mItemsRecycled << " recycled, "
+                << mNewItemTime << "ms in NewItem; " << frames.frames << " frames, mean " << frames.mean << "ms, max "
+                << frames.max << "ms, " << frames.slowFrames << " slow" << std::endl;
+      if( ASYNC_ITEMS )
+      {
+        std::cout << "  " << mItemsPopulated << " items populated, longest populate tick " << mLongestPopulateTime << "ms" << std::endl;
+      }
+    }
+    mItemsCreated = 0u;
+    mItemsRecycled = 0u;
+    mNewItemTime = 0.0;
+    mItemsPopulated = 0u;
+    mLongestPopulateTime = 0.0;
+
+    if( mFlingCount == FLING_BENCHMARK_COUNT )
+    {
+      mApplication.Quit();
+      return false;
+    }
+
+    const unsigned int itemId = ( mFlingCount % 2u == 0u ) ? GetNumberOfItems() - 1u : 0u;
+    mItemView.ScrollToItem( itemId, FLING_BENCHMARK_DURATION );
+    ++mFlingCount;
+    return true;
+  }
+
+  /**
+   * Times showing the checkboxes and collecting the selection with thousands of items, both by searching every item's
+   * subtree for its checkbox and tick by name, and through the recorded decorations and the selection.
+   */
+  void RunSelectionBenchmark()
+  {
+    Actor container = Actor::New();
+    container.SetVisible( false );
+    Stage::GetCurrent().Add( container );
+
+    for( unsigned int i = 0u; i < SELECTION_BENCHMARK_ITEMS; ++i )
+    {
+      ImageView item = ImageView::New();
+      SetUpItemDecorations( item );
+      container.Add( item );
+
+      if( i % ( SELECTION_BENCHMARK_ITEMS / SELECTION_BENCHMARK_SELECTED ) == 0u )
+      {
+        Actor tick = mItemDecorations[ item.GetId() ].tick;
+        tick.SetVisible( true );
+        mSelectedItems[ i ] = tick;
+      }
+    }
+
+    double start = DemoHelper::GetMilliseconds();
+    for( unsigned int i = 0u; i < container.GetChildCount(); ++i )
+    {
+      Actor box = container.GetChildAt( i ).FindChildByName( "CheckBox" );
+      if( box )
+      {
+        box.SetVisible( true );
+      }
+    }
+    const double searchShowTime = DemoHelper::GetMilliseconds() - start;
+
+    start = DemoHelper::GetMilliseconds();
+    SetCheckBoxesVisible( true );
+    const double recordedShowTime = DemoHelper::GetMilliseconds() - start;
+
+    start = DemoHelper::GetMilliseconds();
+    ItemIdContainer searchSelection;
+    for( unsigned int i = 0u; i < container.GetChildCount(); ++i )
+    {
+      Actor tick = container.GetChildAt( i ).FindChildByName( "Tick" );
+      if( tick && tick.IsVisible() )
+      {
+        searchSelection.push_back( i );
+      }
+    }
+    const double searchSelectionTime = DemoHelper::GetMilliseconds() - start;
+
+    start = DemoHelper::GetMilliseconds();
+    ItemIdContainer selection;
+    for( std::map< ItemId, Actor >::const_iterator iter = mSelectedItems.begin(); iter != mSelectedItems.end(); ++iter )
+    {
+      selection.push_back( iter->first );
+    }
+    const double selectionTime = DemoHelper::GetMilliseconds() - start;
+    ClearSelection();
+
+    std::cout << SELECTION_BENCHMARK_ITEMS << " items, " << selection.size() << " selected ("
+              << ( searchSelection == selection ? "same" : "DIFFERENT" ) << " by search)" << std::endl;
+    std::cout << "  show checkboxes: " << searchShowTime << "ms searching each item, " << recordedShowTime << "ms through the recorded checkboxes" << std::endl;
+    std::cout << "  collect selection: " << searchSelectionTime << "ms searching each item, " << selectionTime << "ms through the selection" << std::endl;
+
+    SetCheckBoxesVisible( false );
+    for( unsigned int i = 0u; i < container.GetChildCount(); ++i )
+    {
+      mItemDecorations.erase( container.GetChildAt( i ).GetId() );
+    }
+    container.Unparent();
   }
 
   Actor OnKeyboardPreFocusChange( Actor current, Actor proposed, Control::KeyboardFocus::Direction direction )
@@ -469,20 +643,10 @@ public:
   void EnterRemoveMode()
   {
     SetTitle("Edit: Remove");
-
-    mTapDetector = TapGestureDetector::New();
-
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      mTapDetector.Attach(mItemView.GetChildAt(i));
-    }
-
-    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::RemoveOnTap );
   }
 
   void ExitRemoveMode()
   {
-    mTapDetector.Reset();
   }
 
   void RemoveOnTap( Actor actor, const TapGesture& tap )
@@ -496,54 +660,86 @@ public:
 
     mDeleteButton.SetVisible( true );
 
-    mTapDetector = TapGestureDetector::New();
-
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      Actor child = mItemView.GetChildAt( i );
-      Actor box = child.FindChildByName( "CheckBox" );
+    SetCheckBoxesVisible( true );
+  }
 
-      if( box )
-      {
-        mTapDetector.Attach( child );
-        box.SetVisible( true );
-      }
-    }
+  void ExitRemoveManyMode()
+  {
+    ClearSelection();
+    SetCheckBoxesVisible( false );
 
-    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::SelectOnTap );
+    mDeleteButton.SetVisible( false );
   }
 
-  void ExitRemoveManyMode()
+  /**
+   * Every item is connected to the tap detector when it is created; taps are handled according to the mode.
+   */
+  void OnItemTap( Actor actor, const TapGesture& tap )
   {
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
+    switch( mMode )
     {
-      Actor child = mItemView.GetChildAt( i );
-      Actor box = child.FindChildByName( "CheckBox" );
-
-      if( box )
+      case MODE_REMOVE:
       {
-        box.SetVisible( false );
-
-        Actor tick = box.FindChildByName( "Tick" );
-        if( tick )
-        {
-          tick.SetVisible( false );
-        }
+        RemoveOnTap( actor, tap );
+        break;
+      }
+      case MODE_INSERT:
+      {
+        InsertOnTap( actor, tap );
+        break;
+      }
+      case MODE_REPLACE:
+      {
+        ReplaceOnTap( actor, tap );
+        break;
+      }
+      case MODE_REMOVE_MANY:
+      case MODE_INSERT_MANY:
+      case MODE_REPLACE_MANY:
+      {
+        SelectOnTap( actor, tap );
+        break;
+      }
+      default:
+      {
+        break;
       }
     }
+  }
 
-    mTapDetector.Reset();
+  void SelectOnTap( Actor actor, const TapGesture& tap )
+  {
+    std::map< unsigned int, ItemDecorations >::iterator decorations = mItemDecorations.find( actor.GetId() );
+    if( decorations == mItemDecorations.end() )
+    {
+      // A placeholder which has not been populated yet
+      return;
+    }
 
-    mDeleteButton.SetVisible( false );
+    const ItemId itemId = mItemView.GetItemId( actor );
+    std::map< ItemId, Actor >::iterator selected = mSelectedItems.find( itemId );
+    if( selected == mSelectedItems.end() )
+    {
+      decorations->second.tick.SetVisible( true );
+      mSelectedItems[ itemId ] = decorations->second.tick;
+    }
+    else
+    {
+      selected->second.SetVisible( false );
+      mSelectedItems.erase( selected );
+    }
   }
 
-  void SelectOnTap( Actor actor, const TapGesture& tap )
+  /**
+   * Untick the selected items. Item IDs change when items are inserted or removed, so this is done before any batch edit.
+   */
+  void ClearSelection()
   {
-    Actor tick = actor.FindChildByName( "Tick" );
-    if( tick )
+    for( std::map< ItemId, Actor >::iterator iter = mSelectedItems.begin(); iter != mSelectedItems.end(); ++iter )
     {
-      tick.SetVisible( !tick.IsVisible() );
+      iter->second.SetVisible( false );
     }
+    mSelectedItems.clear();
   }
 
   void OnLongPress( Actor actor, const LongPressGesture& gesture )
@@ -579,16 +775,11 @@ public:
   {
     ItemIdContainer removeList;
 
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
+    for( std::map< ItemId, Actor >::const_iterator iter = mSelectedItems.begin(); iter != mSelectedItems.end(); ++iter )
     {
-      Actor child = mItemView.GetChildAt( i );
-      Actor tick = child.FindChildByName( "Tick" );
-
-      if( tick && tick.IsVisible() )
-      {
-        removeList.push_back( mItemView.GetItemId(child) );
-      }
+      removeList.push_back( iter->first );
     }
+    ClearSelection();
 
     if( ! removeList.empty() )
     {
@@ -601,20 +792,10 @@ public:
   void EnterInsertMode()
   {
     SetTitle("Edit: Insert");
-
-    mTapDetector = TapGestureDetector::New();
-
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      mTapDetector.Attach( mItemView.GetChildAt(i) );
-    }
-
-    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::InsertOnTap );
   }
 
   void ExitInsertMode()
   {
-    mTapDetector.Reset();
   }
 
   void InsertOnTap( Actor actor, const TapGesture& tap )
@@ -632,43 +813,13 @@ public:
 
     mInsertButton.SetVisible( true );
 
-    mTapDetector = TapGestureDetector::New();
-
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      Actor child = mItemView.GetChildAt( i );
-      Actor box = child.FindChildByName( "CheckBox" );
-
-      if( box )
-      {
-        mTapDetector.Attach( child );
-        box.SetVisible( true );
-      }
-    }
-
-    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::SelectOnTap );
+    SetCheckBoxesVisible( true );
   }
 
   void ExitInsertManyMode()
   {
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      Actor child = mItemView.GetChildAt( i );
-      Actor box = child.FindChildByName( "CheckBox" );
-
-      if( box )
-      {
-        box.SetVisible( false );
-
-        Actor tick = box.FindChildByName( "Tick" );
-        if( tick )
-        {
-          tick.SetVisible( false );
-        }
-      }
-    }
-
-    mTapDetector.Reset();
+    ClearSelection();
+    SetCheckBoxesVisible( false );
 
     mInsertButton.SetVisible( false );
   }
@@ -677,16 +828,11 @@ public:
   {
     ItemContainer insertList;
 
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
+    for( std::map< ItemId, Actor >::const_iterator iter = mSelectedItems.begin(); iter != mSelectedItems.end(); ++iter )
     {
-      Actor child = mItemView.GetChildAt( i );
-      Actor tick = child.FindChildByName( "Tick" );
-
-      if( tick && tick.IsVisible() )
-      {
-        insertList.push_back( Item( mItemView.GetItemId(child), NewItem(rand()) ) );
-      }
+      insertList.push_back( Item( iter->first, NewItem(rand()) ) );
     }
+    ClearSelection();
 
     if( ! insertList.empty() )
     {
@@ -699,15 +845,6 @@ public:
   void EnterReplaceMode()
   {
     SetTitle("Edit: Replace");
-
-    mTapDetector = TapGestureDetector::New();
-
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      mTapDetector.Attach(mItemView.GetChildAt(i));
-    }
-
-    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::ReplaceOnTap );
   }
 
   void ReplaceOnTap( Actor actor, const TapGesture& tap )
@@ -717,7 +854,6 @@ public:
 
   void ExitReplaceMode()
   {
-    mTapDetector.Reset();
   }
 
   void EnterReplaceManyMode()
@@ -726,43 +862,13 @@ public:
 
     mReplaceButton.SetVisible( true );
 
-    mTapDetector = TapGestureDetector::New();
-
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      Actor child = mItemView.GetChildAt( i );
-      Actor box = child.FindChildByName( "CheckBox" );
-
-      if( box )
-      {
-        mTapDetector.Attach( child );
-        box.SetVisible( true );
-      }
-    }
-
-    mTapDetector.DetectedSignal().Connect( this, &ItemViewExample::SelectOnTap );
+    SetCheckBoxesVisible( true );
   }
 
   void ExitReplaceManyMode()
   {
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
-    {
-      Actor child = mItemView.GetChildAt( i );
-      Actor box = child.FindChildByName( "CheckBox" );
-
-      if( box )
-      {
-        box.SetVisible( false );
-
-        Actor tick = box.FindChildByName( "Tick" );
-        if( tick )
-        {
-          tick.SetVisible( false );
-        }
-      }
-    }
-
-    mTapDetector.Reset();
+    ClearSelection();
+    SetCheckBoxesVisible( false );
 
     mReplaceButton.SetVisible( false );
   }
@@ -771,16 +877,11 @@ public:
   {
     ItemContainer replaceList;
 
-    for( unsigned int i = 0u; i < mItemView.GetChildCount(); ++i )
+    for( std::map< ItemId, Actor >::const_iterator iter = mSelectedItems.begin(); iter != mSelectedItems.end(); ++iter )
     {
-      Actor child = mItemView.GetChildAt( i );
-      Actor tick = child.FindChildByName( "Tick" );
-
-      if( tick && tick.IsVisible() )
-      {
-        replaceList.push_back( Item( mItemView.GetItemId(child), NewItem(rand()) ) );
-      }
+      replaceList.push_back( Item( iter->first, NewItem(rand()) ) );
     }
+    ClearSelection();
 
     if( ! replaceList.empty() )
     {
@@ -859,81 +960,259 @@ public: // From ItemFactory
 
   /**
    * Create an Actor to represent a visible item.
+   * Actors released by the item view are reused when possible. With --async-items, the actor is a
+   * placeholder until its image has been decoded.
    * @param itemId
    * @return the created actor.
    */
   virtual Actor NewItem(unsigned int itemId)
   {
-    // Create an image view for this item
-    ImageView actor = ImageView::New( IMAGE_PATHS[ itemId % NUM_IMAGES ] );
-    actor.SetZ( 0.0f );
-    actor.SetPosition( INITIAL_OFFSCREEN_POSITION );
+    const double start = DemoHelper::GetMilliseconds();
 
-    // Add a border image child actor
-    ImageView borderActor = ImageView::New();
-    borderActor.SetParentOrigin( ParentOrigin::CENTER );
-    borderActor.SetAnchorPoint( AnchorPoint::CENTER );
-    borderActor.SetResizePolicy( ResizePolicy::SIZE_FIXED_OFFSET_FROM_PARENT, Dimension::ALL_DIMENSIONS );
-    borderActor.SetSizeModeFactor( Vector3( 2.0f * ITEM_BORDER_SIZE, 2.0f * ITEM_BORDER_SIZE, 0.0f ) );
-    borderActor.SetColorMode( USE_PARENT_COLOR );
+    ImageView actor;
+    if( !mRecycledItems.empty() )
+    {
+      actor = mRecycledItems.back();
+      mRecycledItems.pop_back();
+      ++mItemsRecycled;
+    }
+    else
+    {
+      actor = ImageView::New();
+      ++mItemsCreated;
+    }
+    BindItem( actor, itemId );
 
-    Property::Map borderProperty;
-    borderProperty.Insert( Visual::Property::TYPE, Visual::BORDER );
-    borderProperty.Insert( BorderVisual::Property::COLOR, Color::WHITE );
-    borderProperty.Insert( BorderVisual::Property::SIZE, ITEM_BORDER_SIZE );
-    borderProperty.Insert( BorderVisual::Property::ANTI_ALIASING, true );
-    borderActor.SetProperty( ImageView::Property::IMAGE, borderProperty );
+    mNewItemTime += DemoHelper::GetMilliseconds() - start;
+    return actor;
+  }
 
-    actor.Add(borderActor);
+  /**
+   * Keep a released actor to represent another item later.
+   * @param itemId
+   * @param actor The actor the item view no longer uses.
+   */
+  virtual void ItemReleased(unsigned int itemId, Actor actor)
+  {
+    // Drop the item's image if it is still being decoded
+    std::map< unsigned int, PendingItem >::iterator pending = mPendingItems.find( actor.GetId() );
+    if( pending != mPendingItems.end() )
+    {
+      pending->second.task->Cancel();
+      mPendingItems.erase( pending );
+    }
+
+    std::map< unsigned int, ItemDecorations >::iterator decorations = mItemDecorations.find( actor.GetId() );
+    if( decorations != mItemDecorations.end() )
+    {
+      std::map< ItemId, Actor >::iterator selected = mSelectedItems.find( itemId );
+      if( selected != mSelectedItems.end() && selected->second == decorations->second.tick )
+      {
+        mSelectedItems.erase( selected );
+      }
+    }
 
+    ImageView item = ImageView::DownCast( actor );
+    if( RECYCLE_ITEMS && item && mRecycledItems.size() < MAX_RECYCLED_ITEMS )
+    {
+      // The item view applies its layout constraints again when the actor is reused
+      item.RemoveConstraints();
+      mRecycledItems.push_back( item );
+    }
+    else if( decorations != mItemDecorations.end() )
+    {
+      mItemDecorations.erase( decorations );
+    }
+  }
+
+private:
+
+  /**
+   * Set up a new or recycled item actor to represent an item, resetting anything the item view or the editing modes changed.
+   */
+  void BindItem( ImageView actor, unsigned int itemId )
+  {
+    actor.SetPosition( INITIAL_OFFSCREEN_POSITION );
+    actor.SetOrientation( Quaternion() );
+    actor.SetScale( Vector3::ONE );
+    actor.SetColor( Color::WHITE );
     actor.SetKeyboardFocusable( true );
 
-    Vector3 spiralItemSize;
-    static_cast<ItemLayout&>(*mSpiralLayout).GetItemSize( 0u, Vector3( Stage::GetCurrent().GetSize() ), spiralItemSize );
-
-    // Add a checkbox child actor; invisible until edit-mode is enabled
-    ImageView checkbox = ImageView::New();
-    checkbox.SetName( "CheckBox" );
-    checkbox.SetColorMode( USE_PARENT_COLOR );
-    checkbox.SetParentOrigin( ParentOrigin::TOP_RIGHT );
-    checkbox.SetAnchorPoint( AnchorPoint::TOP_RIGHT );
-    checkbox.SetSize( spiralItemSize.width * 0.2f, spiralItemSize.width * 0.2f );
-    checkbox.SetPosition( -SELECTION_BORDER_WIDTH, SELECTION_BORDER_WIDTH );
-    checkbox.SetZ( 0.1f );
-
-    Property::Map solidColorProperty;
-    solidColorProperty.Insert( Visual::Property::TYPE, Visual::COLOR );
-    solidColorProperty.Insert( ColorVisual::Property::MIX_COLOR, Vector4(0.f, 0.f, 0.f, 0.6f) );
-    checkbox.SetProperty( ImageView::Property::IMAGE, solidColorProperty );
-
-    if( MODE_REMOVE_MANY  != mMode &&
-        MODE_INSERT_MANY  != mMode &&
-        MODE_REPLACE_MANY != mMode )
-    {
-      checkbox.SetVisible( false );
-    }
-    borderActor.Add( checkbox );
-
-    ImageView tick = ImageView::New( SELECTED_IMAGE );
-    tick.SetName( "Tick" );
-    tick.SetColorMode( USE_PARENT_COLOR );
-    tick.SetParentOrigin( ParentOrigin::TOP_RIGHT );
-    tick.SetAnchorPoint( AnchorPoint::TOP_RIGHT );
-    tick.SetSize( spiralItemSize.width * 0.2f, spiralItemSize.width * 0.2f );
-    tick.SetZ( 0.2f );
-    tick.SetVisible( false );
-    checkbox.Add( tick );
+    if( ASYNC_ITEMS )
+    {
+      Property::Map placeholderProperty;
+      placeholderProperty.Insert( Visual::Property::TYPE, Visual::COLOR );
+      placeholderProperty.Insert( ColorVisual::Property::MIX_COLOR, PLACEHOLDER_COLOR );
+      actor.SetProperty( ImageView::Property::IMAGE, placeholderProperty );
+
+      // A recycled actor keeps its decorations, which only need resetting
+      if( mItemDecorations.find( actor.GetId() ) != mItemDecorations.end() )
+      {
+        SetUpItemDecorations( actor );
+      }
+      RequestItemImage( actor, itemId );
+    }
+    else
+    {
+      actor.SetImage( IMAGE_PATHS[ itemId % NUM_IMAGES ] );
+      SetUpItemDecorations( actor );
+    }
 
     // Connect new items for various editing modes
-    if( mTapDetector )
+    mTapDetector.Attach( actor );
+  }
+
+  /**
+   * Show or hide the checkboxes of the items, in the modes which select items. Items created later apply
+   * the state when they are set up.
+   */
+  void SetCheckBoxesVisible( bool visible )
+  {
+    mCheckBoxesVisible = visible;
+    for( std::map< unsigned int, ItemDecorations >::iterator iter = mItemDecorations.begin(); iter != mItemDecorations.end(); ++iter )
     {
-      mTapDetector.Attach( actor );
+      iter->second.checkBox.SetVisible( visible );
     }
+  }
 
-    return actor;
+  /**
+   * Add the border, checkbox and tick to an item if it does not have them yet, or untick it.
+   */
+  void SetUpItemDecorations( ImageView actor )
+  {
+    std::map< unsigned int, ItemDecorations >::iterator decorations = mItemDecorations.find( actor.GetId() );
+    if( decorations != mItemDecorations.end() )
+    {
+      decorations->second.checkBox.SetVisible( mCheckBoxesVisible );
+      decorations->second.tick.SetVisible( false );
+    }
+    else
+    {
+      // Add a border image child actor
+      ImageView borderActor = ImageView::New();
+      borderActor.SetParentOrigin( ParentOrigin::CENTER );
+      borderActor.SetAnchorPoint( AnchorPoint::CENTER );
+      borderActor.SetResizePolicy( ResizePolicy::SIZE_FIXED_OFFSET_FROM_PARENT, Dimension::ALL_DIMENSIONS );
+      borderActor.SetSizeModeFactor( Vector3( 2.0f * ITEM_BORDER_SIZE, 2.0f * ITEM_BORDER_SIZE, 0.0f ) );
+      borderActor.SetColorMode( USE_PARENT_COLOR );
+
+      Property::Map borderProperty;
+      borderProperty.Insert( Visual::Property::TYPE, Visual::BORDER );
+      borderProperty.Insert( BorderVisual::Property::COLOR, Color::WHITE );
+      borderProperty.Insert( BorderVisual::Property::SIZE, ITEM_BORDER_SIZE );
+      borderProperty.Insert( BorderVisual::Property::ANTI_ALIASING, true );
+      borderActor.SetProperty( ImageView::Property::IMAGE, borderProperty );
+
+      actor.Add(borderActor);
+
+      Vector3 spiralItemSize;
+      static_cast<ItemLayout&>(*mSpiralLayout).GetItemSize( 0u, Vector3( Stage::GetCurrent().GetSize() ), spiralItemSize );
+
+      // Add a checkbox child actor; only visible in the modes which select items
+      ImageView checkbox = ImageView::New();
+      checkbox.SetName( "CheckBox" );
+      checkbox.SetColorMode( USE_PARENT_COLOR );
+      checkbox.SetParentOrigin( ParentOrigin::TOP_RIGHT );
+      checkbox.SetAnchorPoint( AnchorPoint::TOP_RIGHT );
+      checkbox.SetSize( spiralItemSize.width * 0.2f, spiralItemSize.width * 0.2f );
+      checkbox.SetPosition( -SELECTION_BORDER_WIDTH, SELECTION_BORDER_WIDTH );
+      checkbox.SetZ( 0.1f );
+      checkbox.SetVisible( mCheckBoxesVisible );
+
+      Property::Map solidColorProperty;
+      solidColorProperty.Insert( Visual::Property::TYPE, Visual::COLOR );
+      solidColorProperty.Insert( ColorVisual::Property::MIX_COLOR, Vector4(0.f, 0.f, 0.f, 0.6f) );
+      checkbox.SetProperty( ImageView::Property::IMAGE, solidColorProperty );
+      borderActor.Add( checkbox );
+
+      ImageView tick = ImageView::New( SELECTED_IMAGE );
+      tick.SetName( "Tick" );
+      tick.SetColorMode( USE_PARENT_COLOR );
+      tick.SetParentOrigin( ParentOrigin::TOP_RIGHT );
+      tick.SetAnchorPoint( AnchorPoint::TOP_RIGHT );
+      tick.SetSize( spiralItemSize.width * 0.2f, spiralItemSize.width * 0.2f );
+      tick.SetZ( 0.2f );
+      tick.SetVisible( false );
+      checkbox.Add( tick );
+
+      ItemDecorations& itemDecorations = mItemDecorations[ actor.GetId() ];
+      itemDecorations.checkBox = checkbox;
+      itemDecorations.tick = tick;
+    }
   }
 
-private:
+  /**
+   * Queue the decode of an item's image, at the item size of the current layout.
+   */
+  void RequestItemImage( ImageView actor, unsigned int itemId )
+  {
+    Vector3 itemSize;
+    static_cast<ItemLayout&>(*mItemView.GetLayout( mCurrentLayout )).GetItemSize( itemId, Vector3( Stage::GetCurrent().GetSize() ), itemSize );
+
+    BitmapLoader loader = BitmapLoader::New( IMAGE_PATHS[ itemId % NUM_IMAGES ],
+                                             ImageDimensions( itemSize.width, itemSize.height ),
+                                             FittingMode::SCALE_TO_FILL,
+                                             SamplingMode::BOX_THEN_LINEAR );
+
+    PendingItem& pending = mPendingItems[ actor.GetId() ];
+    pending.actor = actor;
+    pending.requestId = ++mItemRequestCounter;
+    pending.task = new ItemImageTask( *this, actor.GetId(), pending.requestId, loader );
+
+    // The newest items are the ones on screen during a fling
+    mItemDecodePool->AddTask( pending.task, true );
+  }
+
+  /**
+   * Called on the event thread with a decoded item image; it is added to the item on the next populate tick.
+   */
+  void OnItemImageDecoded( unsigned int actorId, unsigned int requestId, PixelData pixelData )
+  {
+    DecodedItem decoded;
+    decoded.actorId = actorId;
+    decoded.requestId = requestId;
+    decoded.pixelData = pixelData;
+    mDecodedItems.push_back( decoded );
+
+    if( !mPopulateTimer.IsRunning() )
+    {
+      mPopulateTimer.Start();
+    }
+  }
+
+  /**
+   * Swaps the placeholders of decoded items for their images and decorations, until the frame budget has been spent.
+   */
+  bool OnPopulateTimer()
+  {
+    const double start = DemoHelper::GetMilliseconds();
+    double elapsed = 0.0;
+    while( !mDecodedItems.empty() && elapsed < ASYNC_ITEM_FRAME_BUDGET )
+    {
+      const DecodedItem decoded = mDecodedItems.front();
+      mDecodedItems.pop_front();
+
+      // The item may have been released, or recycled for another item, since its image was requested
+      std::map< unsigned int, PendingItem >::iterator pending = mPendingItems.find( decoded.actorId );
+      if( pending != mPendingItems.end() && pending->second.requestId == decoded.requestId )
+      {
+        ImageView actor = pending->second.actor;
+        mPendingItems.erase( pending );
+
+        if( decoded.pixelData )
+        {
+          actor.SetImage( DemoHelper::CreateImage( decoded.pixelData ) );
+        }
+        SetUpItemDecorations( actor );
+        ++mItemsPopulated;
+      }
+
+      elapsed = DemoHelper::GetMilliseconds() - start;
+    }
+
+    mLongestPopulateTime = std::max( mLongestPopulateTime, elapsed );
+    return !mDecodedItems.empty();
+  }
 
   /**
    * Sets/Updates the title of the View
@@ -965,6 +1244,68 @@ private:
     }
   }
 
+private:
+
+  /**
+   * Decodes the image of an item on a worker thread.
+   */
+  class ItemImageTask : public DemoHelper::WorkerTask
+  {
+  public:
+    ItemImageTask( ItemViewExample& controller, unsigned int actorId, unsigned int requestId, BitmapLoader loader )
+    : mController( controller ),
+      mLoader( loader ),
+      mActorId( actorId ),
+      mRequestId( requestId )
+    {
+    }
+
+    virtual void Process()
+    {
+      mLoader.Load();
+    }
+
+    virtual void Complete()
+    {
+      mController.OnItemImageDecoded( mActorId, mRequestId, mLoader.GetPixelData() );
+    }
+
+  private:
+    ItemViewExample& mController;
+    BitmapLoader mLoader;
+    unsigned int mActorId;
+    unsigned int mRequestId;
+  };
+
+  /**
+   * The decorations of an item which change with the mode and the selection.
+   */
+  struct ItemDecorations
+  {
+    Actor checkBox;
+    Actor tick;
+  };
+
+  /**
+   * An item showing a placeholder while its image is decoded.
+   */
+  struct PendingItem
+  {
+    ImageView actor;
+    unsigned int requestId;                    ///< Distinguishes the requests of a recycled actor
+    DemoHelper::WorkerTaskPtr task;
+  };
+
+  /**
+   * A decoded image waiting to be added to its item.
+   */
+  struct DecodedItem
+  {
+    unsigned int actorId;
+    unsigned int requestId;
+    PixelData pixelData;
+  };
+
 private:
 
   Application& mApplication;
@@ -984,13 +1325,33 @@ private:
   ItemLayoutPtr mDepthLayout;
   ItemLayoutPtr mGridLayout;
 
-  TapGestureDetector mTapDetector;
+  TapGestureDetector mTapDetector;            ///< Attached to every item
   Toolkit::PushButton mLayoutButton;
   Toolkit::PushButton mDeleteButton;
   Toolkit::PushButton mInsertButton;
   Toolkit::PushButton mReplaceButton;
 
   LongPressGestureDetector mLongPressDetector;
+
+  std::vector< ImageView > mRecycledItems;     ///< Released item actors, ready to represent other items
+  DemoHelper::FrameTimeMonitor mFrameTimeMonitor;
+  Timer mFlingTimer;
+  unsigned int mFlingCount;
+  unsigned int mItemsCreated;                  ///< The number of item actor subtrees allocated since the statistics were last printed
+  unsigned int mItemsRecycled;                 ///< The number of released item actors reused since the statistics were last printed
+  double mNewItemTime;                         ///< The time spent in NewItem since the statistics were last printed, in milliseconds
+
+  DemoHelper::WorkerPool* mItemDecodePool;     ///< Decodes item images with --async-items
+  std::map< unsigned int, PendingItem > mPendingItems;  ///< Items showing a placeholder, by actor ID
+  std::deque< DecodedItem > mDecodedItems;     ///< Decoded images, in the order they were completed
+  Timer mPopulateTimer;
+  unsigned int mItemRequestCounter;
+  unsigned int mItemsPopulated;                ///< The number of placeholders replaced since the statistics were last printed
+  double mLongestPopulateTime;                 ///< The longest populate tick since the statistics were last printed, in milliseconds
+
+  std::map< unsigned int, ItemDecorations > mItemDecorations;  ///< The decorations of each item actor, by actor ID
+  std::map< ItemId, Actor > mSelectedItems;    ///< The ticks of the selected items, by item ID
+  bool mCheckBoxesVisible;                     ///< Whether the checkboxes are shown, in the modes which select items
 };
 
 void RunTest(Application& app)
@@ -1002,6 +1363,26 @@ void RunTest(Application& app)
 
 int DALI_EXPORT_API main(int argc, char **argv)
 {
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--no-recycling" ) == 0 )
+    {
+      RECYCLE_ITEMS = false;
+    }
+    else if( strcmp( argv[i], "--async-items" ) == 0 )
+    {
+      ASYNC_ITEMS = true;
+    }
+    else if( strcmp( argv[i], "--selection-benchmark" ) == 0 )
+    {
+      SELECTION_BENCHMARK = true;
+    }
+    else if( strcmp( argv[i], "--fling-benchmark" ) == 0 )
+    {
+      FLING_BENCHMARK = true;
+    }
+  }
+
   Application app = Application::New(&argc, &argv, DEMO_THEME_PATH);
 
   RunTest(app);
@@ -16,17 +16,26 @@
  */
 
 // EXTERNAL INCLUDES
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
 #include <string>
 
 // INTERNAL INCLUDES
 #include <dali/dali.h>
 #include <dali/devel-api/images/texture-set-image.h>
 #include <dali/public-api/rendering/renderer.h>
+#include <dali/public-api/rendering/sampler.h>
 #include <dali-toolkit/dali-toolkit.h>
 
 #include "shared/view.h"
 #include "shared/utility.h"
+#include "shared/metaball-field.h"
+#include "shared/field-scaler.h"
 
 using namespace Dali;
 using namespace Dali::Toolkit;
@@ -38,6 +47,26 @@ const char * const TOOLBAR_IMAGE( DEMO_IMAGE_DIR "top-bar.png" );
 
 const float GRAVITY_X(0);
 const float GRAVITY_Y(-0.09);
+
+float FIELD_SCALE = 1.0f;       ///< Set by --field-scale to render the metaball field at a fraction of the screen resolution
+bool ADAPTIVE_FIELD = false;    ///< Set by --adaptive-field to scale the metaball field according to the measured frame time
+
+const unsigned int MAX_INSTANCED_BALLS( 512u );
+const float BALL_PARAMETER_RANGE( 2.0f );            ///< The ball texture holds values in [-range, range]
+const float DISPERSION_INTERVAL( 0.15f );            ///< The delay between the balls flying off, with METABALL_NUMBER balls
+const float DISPERSION_DURATION( 2.0f );
+const float RETURN_DURATION( 1.5f );
+const float RETURN_INTERVAL( 0.25f );                ///< How much longer each ball takes to return, with METABALL_NUMBER balls
+const float CLOCK_DURATION( 3600.0f );               ///< The period of the instanced metaballs' clock, a multiple of the wobble period
+
+bool INSTANCED_METABALLS = false;   ///< Set by --instanced to draw all the metaballs with a single renderer
+unsigned int INSTANCED_BALL_COUNT = 0u;   ///< Set by --balls to the number of instanced metaballs
+
+const Vector2 BENCHMARK_FIELD_SIZE( 720.0f, 1280.0f );
+const unsigned int BENCHMARK_ITERATIONS( 10u );
+const unsigned int BENCHMARK_BALL_COUNTS[] = { 1u, 2u, 4u, 6u, 8u, 16u, 32u, 64u };
+const unsigned int NUM_BENCHMARK_BALL_COUNTS( sizeof( BENCHMARK_BALL_COUNTS ) / sizeof( BENCHMARK_BALL_COUNTS[0] ) );
+
 }
 
 #define METABALL_NUMBER 6
@@ -82,6 +111,51 @@ const char*const METABALL_FRAG_SHADER = DALI_COMPOSE_SHADER (
   }\n
 );
 
+// Evaluates all the balls in one pass. BALL_COUNT is defined when the shader is created.
+// Each column of sTexture holds a ball: its dispersion target, gravity, wobble and radius, one per row.
+// The balls move with uTime alone, so it is the only property which changes every frame; the launch and
+// return follow DisperseBallAnimation() and LaunchResetMetaballPosition(), over DISPERSION_DURATION and RETURN_DURATION.
+const char*const INSTANCED_METABALL_FRAG_SHADER = DALI_COMPOSE_SHADER (
+  precision highp float;\n
+  varying vec2 vTexCoord;\n
+  uniform sampler2D sTexture;\n
+  uniform vec2 uCenter;\n
+  uniform float uTime;\n
+  uniform float uReleaseTime;\n
+  uniform float uLaunchInterval;\n
+  uniform float uReturnInterval;\n
+  uniform float uRange;\n
+  \n
+  vec2 Decode( float u, float row )\n
+  {\n
+    vec4 texel = texture2D( sTexture, vec2( u, row ) );\n
+    return ( ( texel.xz * 65280.0 + texel.yw * 255.0 ) / 65535.0 * 2.0 - 1.0 ) * uRange;\n
+  }\n
+  \n
+  void main()\n
+  {\n
+    vec2 adjustedCoords = vTexCoord * 2.0 - 1.0;\n
+    float phase = uTime * 6.2831853 / 3.0;\n
+    vec2 wobble = vec2( sin( phase ), cos( phase ) );\n
+    float sinceRelease = uReleaseTime < 0.0 ? -1.0 : uTime - uReleaseTime;\n
+    float returnStart = float( BALL_COUNT ) * uLaunchInterval + 2.0;\n
+    \n
+    float color = 0.0;\n
+    for( int i = 0; i < BALL_COUNT; ++i )\n
+    {\n
+      float u = ( float( i ) + 0.5 ) / float( BALL_COUNT );\n
+      float outward = clamp( ( sinceRelease - float( i + 1 ) * uLaunchInterval ) / 2.0, 0.0, 1.0 );\n
+      float back = clamp( ( sinceRelease - returnStart ) / ( 1.5 + float( i ) * uReturnInterval ), 0.0, 1.0 );\n
+      vec2 position = mix( mix( uCenter, Decode( u, 0.125 ), outward ), vec2( 0.0 ), back );\n
+      position += Decode( u, 0.375 ) + Decode( u, 0.625 ) * wobble;\n
+      \n
+      vec2 distanceVec = adjustedCoords - position;\n
+      color += inversesqrt( dot( distanceVec, distanceVec ) ) * Decode( u, 0.875 ).x;\n
+    }\n
+    gl_FragColor = vec4( color, color, color, 1.0 );\n
+  }\n
+);
+
 const char*const REFRACTION_FRAG_SHADER = DALI_COMPOSE_SHADER (
   precision highp float;\n
   varying vec2 vTexCoord;\n
@@ -213,6 +287,24 @@ private:
 
   Actor             mMetaballRoot;
   MetaballInfo      mMetaballs[METABALL_NUMBER];
+  RenderTask        mMetaballTask;
+  GaussianBlurView  mBlurView;
+
+  // The instanced metaballs, with --instanced
+  Actor                  mInstancedActor;
+  Texture                mBallTexture;          ///< The parameters of every ball, a column each
+  std::vector< Vector2 > mBallGravity;
+  std::vector< Vector2 > mBallWobble;
+  std::vector< float >   mBallRadius;
+  Property::Index        mCenterIndex;
+  Property::Index        mTimeIndex;
+  Property::Index        mReleaseTimeIndex;
+  Animation              mClockAnimation;
+  double                 mClockStart;           ///< When mClockAnimation was started, in milliseconds
+  Timer                  mInstancedEndTimer;
+  FrameBufferImage  mBlurredFBO;
+
+  DemoHelper::FieldScaler      mFieldScaler;          ///< Picks the resolution of mMetaballFBO as a fraction of the screen's
 
   Property::Index   mPositionIndex;
   Actor             mCompositionActor;
@@ -251,6 +343,21 @@ private:
    */
   void              CreateMetaballActors();
 
+  /**
+   * Create a single actor which draws all the metaballs, moved by one animated clock
+   */
+  void              CreateInstancedMetaballs();
+
+  /**
+   * Pick new dispersion targets for the instanced metaballs and upload the parameters of all of them
+   */
+  void              UploadInstancedMetaballs();
+
+  /**
+   * Reset the composition once the instanced metaballs have returned
+   */
+  bool              OnInstancedEndTimer();
+
   /**
    * Create the render task and FBO to render the metaballs into a texture
    */
@@ -261,6 +368,11 @@ private:
    */
   void              AddRefractionImage();
 
+  /**
+   * Render the metaballs at a fraction of the screen resolution; the composition upsamples them.
+   */
+  void              SetFieldScale( float scale );
+
   /**
    * Function to create animations for the small variations of position inside the metaball
    */
@@ -306,7 +418,12 @@ private:
 //----------------
 
 MetaballExplosionController::MetaballExplosionController( Application& application )
-  : mApplication( application )
+  : mApplication( application ),
+    mCenterIndex( Property::INVALID_INDEX ),
+    mTimeIndex( Property::INVALID_INDEX ),
+    mReleaseTimeIndex( Property::INVALID_INDEX ),
+    mClockStart( 0.0 ),
+    mFieldScaler( FIELD_SCALE, ADAPTIVE_FIELD )
 {
   // Connect to the Application's Init signal
   mApplication.InitSignal().Connect( this, &MetaballExplosionController::Create );
@@ -335,16 +452,29 @@ void MetaballExplosionController::Create( Application& app )
   srand((unsigned)time(0));
 
   //Create internal data
-  CreateMetaballActors();
+  if( INSTANCED_METABALLS )
+  {
+    CreateInstancedMetaballs();
+  }
+  else
+  {
+    CreateMetaballActors();
+  }
   CreateMetaballImage();
   AddRefractionImage();
 
-  CreateAnimations();
+  if( !INSTANCED_METABALLS )
+  {
+    CreateAnimations();
+  }
 
   mDispersion = 0;
   mTimerDispersion = Timer::New( 150 );
   mTimerDispersion.TickSignal().Connect(this, &MetaballExplosionController::OnTimerDispersionTick);
 
+  mFieldScaler.ScaleChangedSignal().Connect( this, &MetaballExplosionController::SetFieldScale );
+  mFieldScaler.Start( stage.GetRootLayer(), mScreenSize );
+
   // Connect the callback to the touch signal on the mesh actor
   stage.GetRootLayer().TouchSignal().Connect( this, &MetaballExplosionController::OnTouch );
 }
@@ -514,38 +644,168 @@ void MetaballExplosionController::CreateMetaballActors()
   mCurrentTouchPosition = Vector2(0,0);
 }
 
+void MetaballExplosionController::CreateInstancedMetaballs()
+{
+  std::ostringstream defines;
+  defines << "#define BALL_COUNT " << INSTANCED_BALL_COUNT << "\n";
+  Shader shader = Shader::New( METABALL_VERTEX_SHADER, defines.str() + INSTANCED_METABALL_FRAG_SHADER );
+
+  // The same parameters as CreateMetaballActors() and CreateAnimations() pick for each ball
+  for( unsigned int i = 0; i < INSTANCED_BALL_COUNT; ++i )
+  {
+    mBallGravity.push_back( Vector2( randomNumber( -0.2f, 0.2f ), randomNumber( -0.2f, 0.2f ) ) );
+
+    Vector2 direction( randomNumber( -100.f, 100.f ), randomNumber( -100.f, 100.f ) );
+    direction.Normalize();
+    mBallWobble.push_back( direction * 0.1f );
+
+    mBallRadius.push_back( randomNumber( 0.05f, 0.07f ) );
+  }
+
+  mBallTexture = Texture::New( TextureType::TEXTURE_2D, Pixel::RGBA8888, INSTANCED_BALL_COUNT, 4u );
+  UploadInstancedMetaballs();
+
+  // Each texel is the parameter of one ball, so it must not be filtered with its neighbours
+  Sampler sampler = Sampler::New();
+  sampler.SetFilterMode( FilterMode::NEAREST, FilterMode::NEAREST );
+
+  TextureSet textureSet = TextureSet::New();
+  textureSet.SetTexture( 0u, mBallTexture );
+  textureSet.SetSampler( 0u, sampler );
+
+  // One opaque quad covering the screen, rather than one additive quad per ball
+  Renderer renderer = Renderer::New( CreateGeometry(), shader );
+  renderer.SetTextures( textureSet );
+
+  mInstancedActor = Actor::New();
+  mInstancedActor.SetName( "Metaballs" );
+  mInstancedActor.SetParentOrigin( ParentOrigin::CENTER );
+  mInstancedActor.SetSize( 400, 400 );
+  mInstancedActor.AddRenderer( renderer );
+
+  // Launching and returning take as long in all as with METABALL_NUMBER balls
+  const float intervalScale = static_cast< float >( METABALL_NUMBER ) / INSTANCED_BALL_COUNT;
+  mCenterIndex = mInstancedActor.RegisterProperty( "uCenter", Vector2::ZERO );
+  mTimeIndex = mInstancedActor.RegisterProperty( "uTime", 0.0f );
+  mReleaseTimeIndex = mInstancedActor.RegisterProperty( "uReleaseTime", -1.0f );
+  mInstancedActor.RegisterProperty( "uLaunchInterval", DISPERSION_INTERVAL * intervalScale );
+  mInstancedActor.RegisterProperty( "uReturnInterval", RETURN_INTERVAL * intervalScale );
+  mInstancedActor.RegisterProperty( "uRange", BALL_PARAMETER_RANGE );
+
+  mMetaballRoot = Actor::New();
+  mMetaballRoot.SetParentOrigin( ParentOrigin::CENTER );
+  mMetaballRoot.Add( mInstancedActor );
+
+  mClockAnimation = Animation::New( CLOCK_DURATION );
+  mClockAnimation.AnimateTo( Property( mInstancedActor, mTimeIndex ), CLOCK_DURATION, AlphaFunction::LINEAR );
+  mClockAnimation.SetLooping( true );
+  mClockAnimation.Play();
+  mClockStart = DemoHelper::GetMilliseconds();
+
+  const float duration = METABALL_NUMBER * DISPERSION_INTERVAL + DISPERSION_DURATION +
+                         RETURN_DURATION + ( INSTANCED_BALL_COUNT - 1u ) * RETURN_INTERVAL * intervalScale;
+  mInstancedEndTimer = Timer::New( static_cast< unsigned int >( duration * 1000.0f ) );
+  mInstancedEndTimer.TickSignal().Connect( this, &MetaballExplosionController::OnInstancedEndTimer );
+}
+
+void MetaballExplosionController::UploadInstancedMetaballs()
+{
+  // Rows of 16-bit pairs: dispersion target, gravity, wobble, then the radius
+  const unsigned int width = INSTANCED_BALL_COUNT;
+  const unsigned int bufferSize = width * 4u * 4u;
+  unsigned char* pixels = new unsigned char[ bufferSize ];
+  for( unsigned int i = 0; i < width; ++i )
+  {
+    const Vector2 values[4] =
+    {
+      Vector2( randomNumber( -1.5f, 1.5f ), randomNumber( -1.5f, 1.5f ) ),
+      mBallGravity[i],
+      mBallWobble[i],
+      Vector2( mBallRadius[i], 0.0f )
+    };
+
+    for( unsigned int row = 0; row < 4u; ++row )
+    {
+      unsigned char* texel = pixels + ( row * width + i ) * 4u;
+      for( unsigned int component = 0; component < 2u; ++component )
+      {
+        const float normalized = ( values[row][component] / BALL_PARAMETER_RANGE + 1.0f ) * 0.5f;
+        const unsigned int value = std::min( std::max( normalized, 0.0f ), 1.0f ) * 65535.0f + 0.5f;
+        texel[component * 2u] = value >> 8u;
+        texel[component * 2u + 1u] = value & 0xFFu;
+      }
+    }
+  }
+
+  mBallTexture.Upload( PixelData::New( pixels, bufferSize, width, 4u, Pixel::RGBA8888, PixelData::DELETE_ARRAY ) );
+}
+
+bool MetaballExplosionController::OnInstancedEndTimer()
+{
+  mCompositionActor.SetProperty( mPositionIndex, Vector2(0,0) );
+  return false;
+}
+
 void MetaballExplosionController::CreateMetaballImage()
 {
   //We create an FBO and a render task to create to render the metaballs with a fragment shader
   Stage stage = Stage::GetCurrent();
-  mMetaballFBO = FrameBufferImage::New(mScreenSize.x, mScreenSize.y, Pixel::RGBA8888, RenderBuffer::COLOR_DEPTH);
-
-
   stage.Add(mMetaballRoot);
 
   //Creation of the render task used to render the metaballs
   RenderTaskList taskList = Stage::GetCurrent().GetRenderTaskList();
-  RenderTask task = taskList.CreateTask();
-  task.SetRefreshRate( RenderTask::REFRESH_ALWAYS );
-  task.SetSourceActor( mMetaballRoot );
-  task.SetExclusive(true);
-  task.SetClearColor( Color::BLACK );
-  task.SetClearEnabled( true );
-  task.SetTargetFrameBuffer( mMetaballFBO );
+  mMetaballTask = taskList.CreateTask();
+  mMetaballTask.SetRefreshRate( RenderTask::REFRESH_ALWAYS );
+  mMetaballTask.SetSourceActor( mMetaballRoot );
+  mMetaballTask.SetExclusive(true);
+  mMetaballTask.SetClearColor( Color::BLACK );
+  mMetaballTask.SetClearEnabled( true );
+
+  SetFieldScale( mFieldScaler.GetScale() );
+}
+
+void MetaballExplosionController::SetFieldScale( float scale )
+{
+  if( scale < 1.0f )
+  {
+    // The field is smooth and blurred afterwards, so linear sampling in the composition is enough to upsample it.
+    // The balls are additive quads, so no depth buffer is needed either.
+    mMetaballFBO = FrameBufferImage::New( std::max( floorf( mScreenSize.x * scale + 0.5f ), 1.0f ),
+                                          std::max( floorf( mScreenSize.y * scale + 0.5f ), 1.0f ),
+                                          Pixel::RGBA8888, RenderBuffer::COLOR );
+  }
+  else
+  {
+    mMetaballFBO = FrameBufferImage::New(mScreenSize.x, mScreenSize.y, Pixel::RGBA8888, RenderBuffer::COLOR_DEPTH);
+  }
+
+  // The camera still covers the whole screen, so the viewport scales the balls down to the frame buffer
+  mMetaballTask.SetTargetFrameBuffer( mMetaballFBO );
+  mMetaballTask.SetViewportPosition( Vector2::ZERO );
+  mMetaballTask.SetViewportSize( Vector2( mMetaballFBO.GetWidth(), mMetaballFBO.GetHeight() ) );
+
+  // Every ball is a quad covering the whole frame buffer, unless a single quad draws them all
+  mFieldScaler.SetField( mMetaballFBO.GetWidth(), mMetaballFBO.GetHeight(), INSTANCED_METABALLS ? 1u : METABALL_NUMBER );
+
+  if( mBlurView )
+  {
+    mBlurView.Deactivate();
+    mBlurView.SetUserImageAndOutputRenderTarget( mMetaballFBO, mBlurredFBO );
+    mBlurView.Activate();
+  }
 }
 
 void MetaballExplosionController::AddRefractionImage()
 {
   //Create Gaussian blur for the rendered image
-  FrameBufferImage fbo;
-  fbo = FrameBufferImage::New( mScreenSize.x, mScreenSize.y, Pixel::RGBA8888, RenderBuffer::COLOR_DEPTH);
+  mBlurredFBO = FrameBufferImage::New( mScreenSize.x, mScreenSize.y, Pixel::RGBA8888, RenderBuffer::COLOR_DEPTH);
 
-  GaussianBlurView gbv = GaussianBlurView::New(5, 2.0f, Pixel::RGBA8888, 0.5f, 0.5f, true);
-  gbv.SetBackgroundColor(Color::TRANSPARENT);
-  gbv.SetUserImageAndOutputRenderTarget( mMetaballFBO, fbo );
-  gbv.SetSize(mScreenSize.x, mScreenSize.y);
-  Stage::GetCurrent().Add(gbv);
-  gbv.Activate();
+  mBlurView = GaussianBlurView::New(5, 2.0f, Pixel::RGBA8888, 0.5f, 0.5f, true);
+  mBlurView.SetBackgroundColor(Color::TRANSPARENT);
+  mBlurView.SetUserImageAndOutputRenderTarget( mMetaballFBO, mBlurredFBO );
+  mBlurView.SetSize(mScreenSize.x, mScreenSize.y);
+  Stage::GetCurrent().Add(mBlurView);
+  mBlurView.Activate();
 
   //Create new shader
   Shader shader = Shader::New( METABALL_VERTEX_SHADER, REFRACTION_FRAG_SHADER );
@@ -553,7 +813,7 @@ void MetaballExplosionController::AddRefractionImage()
   //Create new texture set
   TextureSet textureSet = TextureSet::New();
   TextureSetImage( textureSet, 0u, mBackImage );
-  TextureSetImage( textureSet, 1u, fbo );
+  TextureSetImage( textureSet, 1u, mBlurredFBO );
 
   //Create geometry
   Geometry metaballGeom = CreateGeometryComposition();
@@ -615,6 +875,15 @@ void MetaballExplosionController::CreateAnimations()
 
 void MetaballExplosionController::ResetMetaballs(bool resetAnims)
 {
+  if( mInstancedActor )
+  {
+    mInstancedActor.SetProperty( mReleaseTimeIndex, -1.0f );
+    mInstancedActor.SetProperty( mCenterIndex, Vector2::ZERO );
+    mInstancedEndTimer.Stop();
+    mCompositionActor.SetProperty( mPositionIndex, Vector2(0,0) );
+    return;
+  }
+
   for( int i = 0; i < METABALL_NUMBER; i++ )
   {
     if (mDispersionAnimation[i])
@@ -674,10 +943,17 @@ bool MetaballExplosionController::OnTimerDispersionTick()
 void MetaballExplosionController::SetPositionToMetaballs(Vector2 & metaballCenter)
 {
   //We set the position for the metaballs based on click position
-  for( int i = 0; i < METABALL_NUMBER; i++ )
+  if( mInstancedActor )
   {
-    mMetaballs[i].position = metaballCenter;
-    mMetaballs[i].actor.SetProperty(mMetaballs[i].positionIndex, mMetaballs[i].position);
+    mInstancedActor.SetProperty( mCenterIndex, metaballCenter );
+  }
+  else
+  {
+    for( int i = 0; i < METABALL_NUMBER; i++ )
+    {
+      mMetaballs[i].position = metaballCenter;
+      mMetaballs[i].actor.SetProperty(mMetaballs[i].positionIndex, mMetaballs[i].position);
+    }
   }
 
   mCompositionActor.SetProperty( mPositionIndex, metaballCenter );
@@ -710,7 +986,17 @@ bool MetaballExplosionController::OnTouch( Actor actor, const TouchData& touch )
     case PointState::LEAVE:
     case PointState::INTERRUPTED:
     {
-      mTimerDispersion.Start();
+      if( mInstancedActor )
+      {
+        // The shader launches the balls from the release time on the clock
+        UploadInstancedMetaballs();
+        mInstancedActor.SetProperty( mReleaseTimeIndex, static_cast< float >( fmod( ( DemoHelper::GetMilliseconds() - mClockStart ) / 1000.0, CLOCK_DURATION ) ) );
+        mInstancedEndTimer.Start();
+      }
+      else
+      {
+        mTimerDispersion.Start();
+      }
       break;
     }
     default:
@@ -737,6 +1023,121 @@ void MetaballExplosionController::OnKeyEvent(const KeyEvent& event)
 //
 //-----------------------------------------------------------------------------------------------
 
+/**
+ * Creates balls with the radii of the demo, placed at random over a field of the given size.
+ */
+std::vector< DemoHelper::Metaball > CreateRandomMetaballs( unsigned int count, const Vector2& size )
+{
+  const float aspect = size.y / size.x;
+  std::vector< DemoHelper::Metaball > balls;
+  for( unsigned int i = 0; i < count; ++i )
+  {
+    balls.push_back( DemoHelper::Metaball( Vector2( randomNumber( -1.0f, 1.0f ), randomNumber( -1.0f, 2.0f * aspect - 1.0f ) ),
+                                           randomNumber( 0.05f, 0.07f ) ) );
+  }
+  return balls;
+}
+
+/**
+ * Returns whether the field matches its reference, to within one 8-bit step.
+ */
+bool MatchesReference( const DemoHelper::MetaballField& field, const std::vector< DemoHelper::Metaball >& balls )
+{
+  const unsigned int bufferSize = field.GetWidth() * field.GetHeight();
+  std::vector< unsigned char > result( bufferSize );
+  std::vector< unsigned char > reference( bufferSize );
+  field.Compute( balls, &result[0] );
+  field.ComputeReference( balls, &reference[0] );
+
+  for( unsigned int i = 0; i < bufferSize; ++i )
+  {
+    if( abs( result[i] - reference[i] ) > 1 )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Checks the CPU metaball field against its reference, including fields whose width is not a multiple
+ * of the SIMD width, and prints the cost of evaluating the field for increasing numbers of balls.
+ * On the GPU every ball is a quad covering the whole frame buffer, so each ball adds a full screen of fill.
+ * @return false if the field does not match the reference
+ */
+bool RunFieldBenchmark()
+{
+#if defined( DEMO_METABALL_FIELD_SSE )
+  std::cout << "Metaball field: SSE2" << std::endl;
+#elif defined( DEMO_METABALL_FIELD_NEON )
+  std::cout << "Metaball field: NEON" << std::endl;
+#else
+  std::cout << "Metaball field: scalar only" << std::endl;
+#endif
+
+  bool passed = true;
+  srand( 1 );
+
+  // Small odd sizes check the pixels left over after the SIMD loop and the split between threads
+  const Vector2 CHECK_SIZES[] = { Vector2( 1.0f, 1.0f ), Vector2( 7.0f, 3.0f ), Vector2( 37.0f, 23.0f ), Vector2( 123.0f, 211.0f ) };
+  for( unsigned int i = 0; i < sizeof( CHECK_SIZES ) / sizeof( CHECK_SIZES[0] ); ++i )
+  {
+    DemoHelper::MetaballField field( CHECK_SIZES[i].x, CHECK_SIZES[i].y );
+    for( unsigned int count = 0; count <= METABALL_NUMBER; ++count )
+    {
+      if( !MatchesReference( field, CreateRandomMetaballs( count, CHECK_SIZES[i] ) ) )
+      {
+        std::cout << "  " << CHECK_SIZES[i].x << "x" << CHECK_SIZES[i].y << ", " << count << " balls: field differs from the reference" << std::endl;
+        passed = false;
+      }
+    }
+  }
+
+  DemoHelper::MetaballField field( BENCHMARK_FIELD_SIZE.x, BENCHMARK_FIELD_SIZE.y );
+  DemoHelper::MetaballField singleThreadedField( BENCHMARK_FIELD_SIZE.x, BENCHMARK_FIELD_SIZE.y, 1u );
+  const unsigned int pixels = field.GetWidth() * field.GetHeight();
+  std::vector< unsigned char > buffer( pixels );
+
+  std::cout << "  " << field.GetWidth() << "x" << field.GetHeight() << " field, mean of " << BENCHMARK_ITERATIONS << " evaluations:" << std::endl;
+  for( unsigned int i = 0; i < NUM_BENCHMARK_BALL_COUNTS; ++i )
+  {
+    const unsigned int count = BENCHMARK_BALL_COUNTS[i];
+    const std::vector< DemoHelper::Metaball > balls = CreateRandomMetaballs( count, BENCHMARK_FIELD_SIZE );
+    if( !MatchesReference( field, balls ) )
+    {
+      std::cout << "  " << count << " balls: field differs from the reference" << std::endl;
+      passed = false;
+    }
+
+    double start = DemoHelper::GetMilliseconds();
+    for( unsigned int j = 0; j < BENCHMARK_ITERATIONS; ++j )
+    {
+      field.Compute( balls, &buffer[0] );
+    }
+    const double threadedTime = ( DemoHelper::GetMilliseconds() - start ) / BENCHMARK_ITERATIONS;
+
+    start = DemoHelper::GetMilliseconds();
+    for( unsigned int j = 0; j < BENCHMARK_ITERATIONS; ++j )
+    {
+      singleThreadedField.Compute( balls, &buffer[0] );
+    }
+    const double vectorizedTime = ( DemoHelper::GetMilliseconds() - start ) / BENCHMARK_ITERATIONS;
+
+    start = DemoHelper::GetMilliseconds();
+    for( unsigned int j = 0; j < BENCHMARK_ITERATIONS; ++j )
+    {
+      field.ComputeReference( balls, &buffer[0] );
+    }
+    const double referenceTime = ( DemoHelper::GetMilliseconds() - start ) / BENCHMARK_ITERATIONS;
+
+    std::cout << "  " << count << " balls (" << count * pixels / 1000000.0 << " Mpixels of GPU fill): ms threaded "
+              << threadedTime << ", single thread " << vectorizedTime << ", reference " << referenceTime
+              << "; ns per pixel and ball " << vectorizedTime * 1000000.0 / ( static_cast< double >( pixels ) * count ) << std::endl;
+  }
+
+  return passed;
+}
+
 void RunTest( Application& application )
 {
   MetaballExplosionController test( application );
@@ -748,6 +1149,36 @@ void RunTest( Application& application )
 //
 int DALI_EXPORT_API main( int argc, char **argv )
 {
+  if( argc > 1 && strcmp( argv[1], "--field-benchmark" ) == 0 )
+  {
+    return RunFieldBenchmark() ? 0 : 1;
+  }
+
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--field-scale" ) == 0 && i + 1 < argc )
+    {
+      FIELD_SCALE = std::min( std::max( static_cast< float >( atof( argv[++i] ) ), DemoHelper::MIN_FIELD_SCALE ), 1.0f );
+    }
+    else if( strcmp( argv[i], "--adaptive-field" ) == 0 )
+    {
+      ADAPTIVE_FIELD = true;
+    }
+    else if( strcmp( argv[i], "--instanced" ) == 0 )
+    {
+      INSTANCED_METABALLS = true;
+    }
+    else if( strcmp( argv[i], "--balls" ) == 0 && i + 1 < argc )
+    {
+      INSTANCED_BALL_COUNT = std::min( static_cast< unsigned int >( std::max( atoi( argv[++i] ), 1 ) ), MAX_INSTANCED_BALLS );
+    }
+  }
+
+  if( INSTANCED_BALL_COUNT == 0u )
+  {
+    INSTANCED_BALL_COUNT = METABALL_NUMBER;
+  }
+
   Application application = Application::New( &argc, &argv );
 
   RunTest( application );
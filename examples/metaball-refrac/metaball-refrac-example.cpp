@@ -20,9 +20,15 @@
 #include <dali/public-api/rendering/renderer.h>
 #include <dali-toolkit/dali-toolkit.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include "shared/utility.h"
+#include "shared/field-scaler.h"
+#include "shared/touch-coalescer.h"
 
 using namespace Dali;
 using namespace Dali::Toolkit;
@@ -34,6 +40,11 @@ const char * const TOOLBAR_IMAGE( DEMO_IMAGE_DIR "top-bar.png" );
 
 const float GRAVITY_X(0);
 const float GRAVITY_Y(-0.09);
+
+float FIELD_SCALE = 1.0f;       ///< Set by --field-scale to render the metaball field at a fraction of the screen resolution
+bool ADAPTIVE_FIELD = false;    ///< Set by --adaptive-field to scale the metaball field according to the measured frame time
+bool COALESCE_TOUCH = true;     ///< Cleared by --no-coalescing to restart the position animation on every motion event
+
 }
 
 #define METABALL_NUMBER 4
@@ -183,6 +194,13 @@ private:
 
   Actor             mMetaballRoot;
   MetaballInfo      mMetaballs[METABALL_NUMBER];
+  RenderTask        mMetaballTask;
+
+  DemoHelper::FieldScaler      mFieldScaler;          ///< Picks the resolution of mMetaballFBO as a fraction of the screen's
+
+  DemoHelper::TouchCoalescer   mTouchCoalescer;       ///< Moves the metaballs at most once per frame
+  double                       mDragStartTime;
+  unsigned int                 mDragAnimations;       ///< The position animations created since the touch went down
 
   Actor             mCompositionActor;
 
@@ -217,6 +235,7 @@ private:
 
   void              CreateMetaballActors();
   void              CreateMetaballImage();
+  void              SetFieldScale( float scale );
   void              AddRefractionImage();
   void              CreateAnimations();
 
@@ -229,6 +248,8 @@ private:
   void              ResetMetaballsState();
 
   void              SetPositionToMetaballs(Vector2 & metaballCenter);
+  void              MoveMetaballs( const Vector2& screen );
+  void              OnCoalescedMotion( const DemoHelper::TouchCoalescer::Points& points );
 };
 
 
@@ -239,10 +260,15 @@ private:
 //----------------
 
 MetaballRefracController::MetaballRefracController( Application& application )
-  : mApplication( application )
+  : mApplication( application ),
+    mFieldScaler( FIELD_SCALE, ADAPTIVE_FIELD ),
+    mTouchCoalescer( 1u ),
+    mDragStartTime( 0.0 ),
+    mDragAnimations( 0u )
 {
   // Connect to the Application's Init signal
   mApplication.InitSignal().Connect( this, &MetaballRefracController::Create );
+  mTouchCoalescer.MotionSignal().Connect( this, &MetaballRefracController::OnCoalescedMotion );
 }
 
 MetaballRefracController::~MetaballRefracController()
@@ -284,6 +310,9 @@ void MetaballRefracController::Create( Application& app )
 
   CreateAnimations();
 
+  mFieldScaler.ScaleChangedSignal().Connect( this, &MetaballRefracController::SetFieldScale );
+  mFieldScaler.Start( stage.GetRootLayer(), mScreenSize );
+
   // Connect the callback to the touch signal on the mesh actor
   stage.GetRootLayer().TouchSignal().Connect( this, &MetaballRefracController::OnTouch );
 }
@@ -503,19 +532,50 @@ void MetaballRefracController::CreateMetaballImage()
 {
   //We create an FBO and a render task to create to render the metaballs with a fragment shader
   Stage stage = Stage::GetCurrent();
-  mMetaballFBO = FrameBufferImage::New(mScreenSize.x, mScreenSize.y );
-
   stage.Add(mMetaballRoot);
 
   //Creation of the render task used to render the metaballs
   RenderTaskList taskList = Stage::GetCurrent().GetRenderTaskList();
-  RenderTask task = taskList.CreateTask();
-  task.SetRefreshRate( RenderTask::REFRESH_ALWAYS );
-  task.SetSourceActor( mMetaballRoot );
-  task.SetExclusive(true);
-  task.SetClearColor( Color::BLACK );
-  task.SetClearEnabled( true );
-  task.SetTargetFrameBuffer( mMetaballFBO );
+  mMetaballTask = taskList.CreateTask();
+  mMetaballTask.SetRefreshRate( RenderTask::REFRESH_ALWAYS );
+  mMetaballTask.SetSourceActor( mMetaballRoot );
+  mMetaballTask.SetExclusive(true);
+  mMetaballTask.SetClearColor( Color::BLACK );
+  mMetaballTask.SetClearEnabled( true );
+
+  SetFieldScale( mFieldScaler.GetScale() );
+}
+
+/**
+ * Render the metaballs at a fraction of the screen resolution; the composition upsamples them
+ */
+void MetaballRefracController::SetFieldScale( float scale )
+{
+  if( scale < 1.0f )
+  {
+    // The field is smooth and only thresholded by the refraction, so linear sampling in the composition
+    // is enough to upsample it. The balls are additive quads, so no depth buffer is needed either.
+    mMetaballFBO = FrameBufferImage::New( std::max( floorf( mScreenSize.x * scale + 0.5f ), 1.0f ),
+                                          std::max( floorf( mScreenSize.y * scale + 0.5f ), 1.0f ),
+                                          Pixel::RGBA8888, RenderBuffer::COLOR );
+  }
+  else
+  {
+    mMetaballFBO = FrameBufferImage::New(mScreenSize.x, mScreenSize.y );
+  }
+
+  // The camera still covers the whole screen, so the viewport scales the balls down to the frame buffer
+  mMetaballTask.SetTargetFrameBuffer( mMetaballFBO );
+  mMetaballTask.SetViewportPosition( Vector2::ZERO );
+  mMetaballTask.SetViewportSize( Vector2( mMetaballFBO.GetWidth(), mMetaballFBO.GetHeight() ) );
+
+  // Every ball is a quad covering the whole frame buffer
+  mFieldScaler.SetField( mMetaballFBO.GetWidth(), mMetaballFBO.GetHeight(), METABALL_NUMBER );
+
+  if( mTextureSetRefraction )
+  {
+    TextureSetImage( mTextureSetRefraction, 1u, mMetaballFBO );
+  }
 }
 
 /**
@@ -778,6 +838,9 @@ bool MetaballRefracController::OnTouch( Actor actor, const TouchData& touch )
       mRendererRefraction.SetTextures(mTextureSetRefraction);
       mRendererRefraction.SetShader( mShaderRefraction );
       mCurrentTouchPosition = touch.GetScreenPosition( 0 );
+      mTouchCoalescer.Reset( mCurrentTouchPosition );
+      mDragStartTime = DemoHelper::GetMilliseconds();
+      mDragAnimations = 0u;
 
       //we use the click position for the metaballs
       Vector2 metaballCenter = Vector2((mCurrentTouchPosition.x / mScreenSize.x) - 0.5, (aspectR * (mScreenSize.y - mCurrentTouchPosition.y) / mScreenSize.y) - 0.5) * 2.0;
@@ -786,33 +849,29 @@ bool MetaballRefracController::OnTouch( Actor actor, const TouchData& touch )
     }
     case PointState::MOTION:
     {
-      Vector2 screen = touch.GetScreenPosition( 0 );
-      Vector2 displacement = screen - mCurrentTouchPosition;
-      mCurrentTouchPosition = screen;
-
-      mMetaballPosVariationTo.x += (displacement.x / mScreenSize.x) * 2.2;
-      mMetaballPosVariationTo.y += (- displacement.y / mScreenSize.y) * 2.2;
-
-      if (mPositionVarAnimation[1])
+      // Touch panels can report motion faster than the display rate, so the samples are batched per frame
+      if( COALESCE_TOUCH )
       {
-        mPositionVarAnimation[1].FinishedSignal().Disconnect( this, &MetaballRefracController::LaunchGetBackToPositionAnimation );
-        mPositionVarAnimation[1].Stop();
+        mTouchCoalescer.AddSample( touch.GetScreenPosition( 0 ) );
+      }
+      else
+      {
+        MoveMetaballs( touch.GetScreenPosition( 0 ) );
       }
-      mPositionVarAnimation[1] = Animation::New(1.f);
-      mPositionVarAnimation[1].SetLooping( false );
-      mPositionVarAnimation[1].AnimateTo(Property( mMetaballs[1].actor, mMetaballs[1].positionVarIndex ), mMetaballPosVariationTo);
-      mPositionVarAnimation[1].FinishedSignal().Connect( this, &MetaballRefracController::LaunchGetBackToPositionAnimation );
-      mPositionVarAnimation[1].Play();
-
-      //we use the click position for the metaballs
-      Vector2 metaballCenter = Vector2((screen.x / mScreenSize.x) - 0.5, (aspectR * (mScreenSize.y - screen.y) / mScreenSize.y) - 0.5) * 2.0;
-      SetPositionToMetaballs(metaballCenter);
       break;
     }
     case PointState::UP:
     case PointState::LEAVE:
     case PointState::INTERRUPTED:
     {
+      mTouchCoalescer.Flush();
+      const float seconds = ( DemoHelper::GetMilliseconds() - mDragStartTime ) / 1000.0f;
+      if( mDragAnimations > 0u && seconds > 0.0f )
+      {
+        printf( "Drag of %.2f s: %u position animations, %.1f per second%s\n",
+                seconds, mDragAnimations, mDragAnimations / seconds, COALESCE_TOUCH ? "" : " without coalescing" );
+      }
+
       //Stop click animations
       StopClickAnimations();
 
@@ -832,6 +891,43 @@ bool MetaballRefracController::OnTouch( Actor actor, const TouchData& touch )
 }
 
 
+/**
+ * Function to move the metaballs with the finger; the accumulated displacement is animated from where they are
+ */
+void MetaballRefracController::MoveMetaballs( const Vector2& screen )
+{
+  float aspectR = mScreenSize.y / mScreenSize.x;
+  Vector2 displacement = screen - mCurrentTouchPosition;
+  mCurrentTouchPosition = screen;
+
+  mMetaballPosVariationTo.x += (displacement.x / mScreenSize.x) * 2.2;
+  mMetaballPosVariationTo.y += (- displacement.y / mScreenSize.y) * 2.2;
+
+  if (mPositionVarAnimation[1])
+  {
+    mPositionVarAnimation[1].FinishedSignal().Disconnect( this, &MetaballRefracController::LaunchGetBackToPositionAnimation );
+    mPositionVarAnimation[1].Stop();
+  }
+  mPositionVarAnimation[1] = Animation::New(1.f);
+  mPositionVarAnimation[1].SetLooping( false );
+  mPositionVarAnimation[1].AnimateTo(Property( mMetaballs[1].actor, mMetaballs[1].positionVarIndex ), mMetaballPosVariationTo);
+  mPositionVarAnimation[1].FinishedSignal().Connect( this, &MetaballRefracController::LaunchGetBackToPositionAnimation );
+  mPositionVarAnimation[1].Play();
+  mDragAnimations++;
+
+  //we use the click position for the metaballs
+  Vector2 metaballCenter = Vector2((screen.x / mScreenSize.x) - 0.5, (aspectR * (mScreenSize.y - screen.y) / mScreenSize.y) - 0.5) * 2.0;
+  SetPositionToMetaballs(metaballCenter);
+}
+
+/**
+ * Only the latest point matters, as the displacement of the whole batch is accumulated
+ */
+void MetaballRefracController::OnCoalescedMotion( const DemoHelper::TouchCoalescer::Points& points )
+{
+  MoveMetaballs( points.back() );
+}
+
 void MetaballRefracController::OnKeyEvent(const KeyEvent& event)
 {
   if(event.state == KeyEvent::Down)
@@ -859,6 +955,22 @@ void RunTest( Application& application )
 //
 int DALI_EXPORT_API main( int argc, char **argv )
 {
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--field-scale" ) == 0 && i + 1 < argc )
+    {
+      FIELD_SCALE = std::min( std::max( static_cast< float >( atof( argv[++i] ) ), DemoHelper::MIN_FIELD_SCALE ), 1.0f );
+    }
+    else if( strcmp( argv[i], "--adaptive-field" ) == 0 )
+    {
+      ADAPTIVE_FIELD = true;
+    }
+    else if( strcmp( argv[i], "--no-coalescing" ) == 0 )
+    {
+      COALESCE_TOUCH = false;
+    }
+  }
+
   Application application = Application::New( &argc, &argv );
 
   RunTest( application );
@@ -23,10 +23,16 @@
 #include <assert.h>
 #include <cstdlib>
 #include <string.h>
+#include <algorithm>
 #include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
 
 #include "shared/view.h"
 #include "shared/utility.h"
+#include "shared/worker-pool.h"
 
 using namespace Dali;
 using namespace Dali::Toolkit;
@@ -68,56 +74,423 @@ const char* PAGE_IMAGES_LANDSCAPE[] =
 };
 const unsigned int NUMBER_OF_LANDSCAPE_IMAGE( sizeof(PAGE_IMAGES_LANDSCAPE) / sizeof(PAGE_IMAGES_LANDSCAPE[0]) );
 
-Atlas LoadImages( const char*imagePath1, const char* imagePath2 )
+const unsigned int PAGE_CACHE_CAPACITY( 16u );     ///< The most decoded pages each factory keeps
+const unsigned int MIN_PREFETCH_PAGES( 2u );       ///< The pages decoded ahead when turning slowly
+const unsigned int MAX_PREFETCH_PAGES( 6u );       ///< The pages decoded ahead when turning quickly
+const float PREFETCH_LOOKAHEAD( 1.5f );            ///< The prefetched pages cover this many seconds of requests at the current rate
+const float REQUEST_RATE_SMOOTHING( 0.3f );        ///< The weight of the latest interval in the smoothed request rate
+const double MAX_GESTURE_LATENCY( 1000.0 );        ///< Longer, in milliseconds, and the gesture did not turn to the page measured
+
+typedef std::vector< PixelData > PageImages;
+
+/**
+ * Uploads the images of a page side by side.
+ */
+Atlas CreatePageImage( const PageImages& images )
 {
-  PixelData pixelData1 = DemoHelper::LoadPixelData( imagePath1, ImageDimensions(), FittingMode::DEFAULT, SamplingMode::DEFAULT );
-  PixelData pixelData2 = DemoHelper::LoadPixelData( imagePath2, ImageDimensions(), FittingMode::DEFAULT, SamplingMode::DEFAULT );
+  if( images.size() == 1u )
+  {
+    return DemoHelper::CreateImage( images[0] );
+  }
 
-  unsigned int width = pixelData1.GetWidth()+pixelData2.GetWidth();
-  unsigned int height = pixelData1.GetHeight() > pixelData2.GetHeight() ? pixelData1.GetHeight() : pixelData2.GetHeight();
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  for( PageImages::const_iterator iter = images.begin(); iter != images.end(); ++iter )
+  {
+    width += iter->GetWidth();
+    height = std::max( height, iter->GetHeight() );
+  }
 
   Atlas image  = Atlas::New( width, height );
-  image.Upload( pixelData1, 0u, 0u );
-  image.Upload( pixelData2, pixelData1.GetWidth(), 0u );
+  unsigned int x = 0u;
+  for( PageImages::const_iterator iter = images.begin(); iter != images.end(); ++iter )
+  {
+    image.Upload( *iter, x, 0u );
+    x += iter->GetWidth();
+  }
 
   return image;
 }
 
 }// end LOCAL STUFF
 
-class PortraitPageFactory : public PageFactory
+/**
+ * A page factory which keeps page images in an LRU cache, and prefetches the pages after the last one requested
+ * in the direction the book is being turned. The faster pages are requested, the further ahead it prefetches.
+ *
+ * The images of a prefetched page are decoded on a worker thread, shrunk to fit the page if they are larger,
+ * and composed into the page image as soon as they are ready, so a turn only finds the page in the cache.
+ * The cache outlives the view using it, so pages are reused when the orientation changes back.
+ */
+class CachedPageFactory : public PageFactory
 {
+public:
+
+  CachedPageFactory()
+  : mWorkerPool( NULL ),
+    mLastPageId( 0u ),
+    mTurningForward( true ),
+    mLastRequestTime( 0.0 ),
+    mRequestRate( 0.0f ),
+    mGestureTime( 0.0 ),
+    mAwaitedPageId( 0u ),
+    mAwaitingPage( false ),
+    mGestureStarted( false ),
+    mRequests( 0u ),
+    mHits( 0u ),
+    mTotalLatency( 0.0 ),
+    mMaxLatency( 0.0 ),
+    mGestures( 0u ),
+    mTotalGestureLatency( 0.0 ),
+    mMaxGestureLatency( 0.0 )
+  {
+  }
+
+  virtual ~CachedPageFactory()
+  {
+    delete mWorkerPool;
+  }
+
   /**
-   * Query the number of pages available from the factory.
-   * The maximum available page has an ID of GetNumberOfPages()-1.
+   * Sets the size each image of a page is shrunk to fit.
    */
-  virtual unsigned int GetNumberOfPages()
+  void SetImageSize( ImageDimensions imageSize )
   {
-    return 10*NUMBER_OF_PORTRAIT_IMAGE + 1;
+    mImageSize = imageSize;
   }
+
   /**
-   * Create an image to represent a page.
+   * Create an image to represent a page, from the cache if it has been prefetched.
    * @param[in] pageId The ID of the page to create.
    * @return An image, or an uninitialized pointer if the ID is out of range.
    */
   virtual Image NewPage( unsigned int pageId )
   {
-    Atlas page;
+    if( pageId >= GetNumberOfPages() )
+    {
+      return Image();
+    }
 
-    if( pageId == 0 )
+    const double start = DemoHelper::GetMilliseconds();
+
+    ++mRequests;
+    Image page;
+    std::map< unsigned int, CacheEntry >::iterator entry = mCache.find( pageId );
+    if( entry != mCache.end() )
     {
-      page = DemoHelper::LoadImage( BOOK_COVER_PORTRAIT );
+      ++mHits;
+      page = entry->second.page;
+      mLru.splice( mLru.begin(), mLru, entry->second.lruPosition );
     }
     else
     {
-      page = DemoHelper::LoadImage( PAGE_IMAGES_PORTRAIT[ (pageId-1) % NUMBER_OF_PORTRAIT_IMAGE ] );
+      std::vector< const char* > imagePaths;
+      GetPageImages( pageId, imagePaths );
+
+      PageImages images;
+      for( std::vector< const char* >::const_iterator iter = imagePaths.begin(); iter != imagePaths.end(); ++iter )
+      {
+        images.push_back( DemoHelper::LoadPixelData( *iter, mImageSize, FittingMode::SHRINK_TO_FIT, SamplingMode::BOX_THEN_LINEAR ) );
+      }
+      page = CreatePageImage( images );
+      AddToCache( pageId, page );
     }
 
+    UpdateRequestRate( pageId, start );
+    Prefetch( pageId, false );
+
+    const double end = DemoHelper::GetMilliseconds();
+    mTotalLatency += end - start;
+    mMaxLatency = std::max( mMaxLatency, end - start );
+
     return page;
   }
+
+  /**
+   * Queues the decode of a page and the pages after it in the current direction, e.g. when the view using this factory
+   * is about to be shown at that page.
+   */
+  void PrefetchFrom( unsigned int pageId )
+  {
+    Prefetch( pageId, true );
+  }
+
+  /**
+   * Marks the start of a page turn gesture, to measure how long it takes until the page it turns to is composed.
+   */
+  void OnGestureStarted()
+  {
+    mGestureStarted = true;
+    mGestureTime = DemoHelper::GetMilliseconds();
+    mAwaitingPage = false;
+  }
+
+  /**
+   * Called when a gesture starts turning a page, with the page the book is turned to. The gesture latency is
+   * measured now if that page is already composed, or else when it is.
+   */
+  void OnTurnStarted( unsigned int pageId )
+  {
+    if( mGestureTime <= 0.0 )
+    {
+      return;
+    }
+
+    if( mCache.find( pageId ) != mCache.end() )
+    {
+      RecordGestureLatency();
+    }
+    else
+    {
+      mAwaitedPageId = pageId;
+      mAwaitingPage = true;
+    }
+  }
+
+  /**
+   * Prints the hit rate of the cache and the time spent creating pages.
+   */
+  void PrintStatistics() const
+  {
+    std::cout << "  page cache: " << mHits << "/" << mRequests << " hits ("
+              << ( mRequests > 0u ? 100.0f * mHits / mRequests : 0.0f ) << "%), NewPage mean "
+              << ( mRequests > 0u ? mTotalLatency / mRequests : 0.0 ) << "ms, max " << mMaxLatency << "ms, prefetching "
+              << GetPrefetchCount() << " pages " << ( mTurningForward ? "forward" : "backward" ) << std::endl;
+    if( mGestures > 0u )
+    {
+      std::cout << "  gesture to turned-to page composed: mean " << mTotalGestureLatency / mGestures << "ms, max " << mMaxGestureLatency
+                << "ms over " << mGestures << " gestures" << std::endl;
+    }
+  }
+
+protected:
+
+  /**
+   * Retrieves the paths of the images which make up a page, from left to right.
+   */
+  virtual void GetPageImages( unsigned int pageId, std::vector< const char* >& imagePaths ) = 0;
+
+private:
+
+  /**
+   * The number of pages to decode ahead at the current request rate.
+   */
+  unsigned int GetPrefetchCount() const
+  {
+    const unsigned int count = MIN_PREFETCH_PAGES + static_cast< unsigned int >( mRequestRate * PREFETCH_LOOKAHEAD );
+    return std::min( count, MAX_PREFETCH_PAGES );
+  }
+
+  /**
+   * Records the time from the start of the current gesture until now.
+   */
+  void RecordGestureLatency()
+  {
+    const double latency = DemoHelper::GetMilliseconds() - mGestureTime;
+    if( latency < MAX_GESTURE_LATENCY )
+    {
+      ++mGestures;
+      mTotalGestureLatency += latency;
+      mMaxGestureLatency = std::max( mMaxGestureLatency, latency );
+    }
+    mGestureTime = 0.0;
+    mAwaitingPage = false;
+  }
+
+  /**
+   * Updates the direction and rate of requests.
+   */
+  void UpdateRequestRate( unsigned int pageId, double requestTime )
+  {
+    if( pageId != mLastPageId )
+    {
+      // The view's initial requests come in mixed order, so the direction only follows the user's gestures
+      const bool turningForward = mGestureStarted ? pageId > mLastPageId : mTurningForward;
+      if( turningForward != mTurningForward && mWorkerPool )
+      {
+        // The pages queued in the other direction will not be needed soon
+        mWorkerPool->CancelTasks();
+        mPendingPages.clear();
+      }
+      mTurningForward = turningForward;
+
+      if( mLastRequestTime > 0.0 )
+      {
+        const float rate = 1000.0f / std::max( requestTime - mLastRequestTime, 1.0 );
+        mRequestRate += ( rate - mRequestRate ) * REQUEST_RATE_SMOOTHING;
+      }
+      mLastRequestTime = requestTime;
+      mLastPageId = pageId;
+    }
+  }
+
+  /**
+   * Queues the decode of the pages ahead which are not cached yet, and of pageId itself if requested.
+   */
+  void Prefetch( unsigned int pageId, bool includePage )
+  {
+    // The worker pool is created with the first prefetch, once the adaptor is running
+    if( !mWorkerPool )
+    {
+      mWorkerPool = new DemoHelper::WorkerPool( 1u );
+    }
+
+    const unsigned int count = GetPrefetchCount();
+    const unsigned int numberOfPages = GetNumberOfPages();
+    for( unsigned int i = includePage ? 0u : 1u; i <= count; ++i )
+    {
+      if( mTurningForward ? pageId + i >= numberOfPages : i > pageId )
+      {
+        break;
+      }
+      const unsigned int prefetchId = mTurningForward ? pageId + i : pageId - i;
+
+      std::map< unsigned int, CacheEntry >::iterator entry = mCache.find( prefetchId );
+      if( entry != mCache.end() )
+      {
+        // Keep the pages which are about to be needed
+        mLru.splice( mLru.begin(), mLru, entry->second.lruPosition );
+      }
+      else if( mPendingPages.insert( prefetchId ).second )
+      {
+        std::vector< const char* > imagePaths;
+        GetPageImages( prefetchId, imagePaths );
+        mWorkerPool->AddTask( new DecodeTask( *this, prefetchId, imagePaths, mImageSize ) );
+      }
+    }
+  }
+
+  /**
+   * Called on the event thread with the decoded images of a prefetched page, which are composed into its image.
+   */
+  void OnPageDecoded( unsigned int pageId, const PageImages& images )
+  {
+    mPendingPages.erase( pageId );
+    if( mCache.find( pageId ) == mCache.end() )
+    {
+      AddToCache( pageId, CreatePageImage( images ) );
+    }
+  }
+
+  void AddToCache( unsigned int pageId, Image page )
+  {
+    mLru.push_front( pageId );
+    CacheEntry& entry = mCache[ pageId ];
+    entry.page = page;
+    entry.lruPosition = mLru.begin();
+
+    if( mAwaitingPage && pageId == mAwaitedPageId )
+    {
+      RecordGestureLatency();
+    }
+
+    if( mCache.size() > PAGE_CACHE_CAPACITY )
+    {
+      mCache.erase( mLru.back() );
+      mLru.pop_back();
+    }
+  }
+
+  /**
+   * Decodes the images of a page on a worker thread.
+   */
+  class DecodeTask : public DemoHelper::WorkerTask
+  {
+  public:
+
+    DecodeTask( CachedPageFactory& factory, unsigned int pageId, const std::vector< const char* >& imagePaths, ImageDimensions imageSize )
+    : mFactory( factory ),
+      mPageId( pageId )
+    {
+      for( std::vector< const char* >::const_iterator iter = imagePaths.begin(); iter != imagePaths.end(); ++iter )
+      {
+        mLoaders.push_back( BitmapLoader::New( *iter, imageSize, FittingMode::SHRINK_TO_FIT, SamplingMode::BOX_THEN_LINEAR ) );
+      }
+    }
+
+    virtual void Process()
+    {
+      for( std::vector< BitmapLoader >::iterator iter = mLoaders.begin(); iter != mLoaders.end(); ++iter )
+      {
+        iter->Load();
+      }
+    }
+
+    virtual void Complete()
+    {
+      PageImages images;
+      for( std::vector< BitmapLoader >::iterator iter = mLoaders.begin(); iter != mLoaders.end(); ++iter )
+      {
+        images.push_back( iter->GetPixelData() );
+      }
+      mFactory.OnPageDecoded( mPageId, images );
+    }
+
+  private:
+
+    CachedPageFactory&          mFactory;
+    std::vector< BitmapLoader > mLoaders;
+    unsigned int                mPageId;
+  };
+
+  struct CacheEntry
+  {
+    Image page;
+    std::list< unsigned int >::iterator lruPosition;
+  };
+
+private:
+
+  DemoHelper::WorkerPool*               mWorkerPool;
+  ImageDimensions                       mImageSize;      ///< The size each image of a page is shrunk to fit, unlimited by default
+  std::map< unsigned int, CacheEntry >  mCache;
+  std::list< unsigned int >             mLru;            ///< The cached page IDs, most recently used first
+  std::set< unsigned int >              mPendingPages;   ///< The pages being decoded
+  unsigned int                          mLastPageId;
+  bool                                  mTurningForward;
+  double                                mLastRequestTime;
+  float                                 mRequestRate;    ///< Smoothed page requests per second
+  double                                mGestureTime;    ///< When the current gesture started, if its latency has not been recorded yet
+  unsigned int                          mAwaitedPageId;  ///< The page the current gesture turned to, while it is being composed
+  bool                                  mAwaitingPage;
+  bool                                  mGestureStarted; ///< Whether the user has turned a page yet
+
+  unsigned int                          mRequests;
+  unsigned int                          mHits;
+  double                                mTotalLatency;   ///< The time spent in NewPage, in milliseconds
+  double                                mMaxLatency;
+  unsigned int                          mGestures;
+  double                                mTotalGestureLatency;
+  double                                mMaxGestureLatency;
 };
 
-class LandscapePageFactory : public PageFactory
+class PortraitPageFactory : public CachedPageFactory
+{
+  /**
+   * Query the number of pages available from the factory.
+   * The maximum available page has an ID of GetNumberOfPages()-1.
+   */
+  virtual unsigned int GetNumberOfPages()
+  {
+    return 10*NUMBER_OF_PORTRAIT_IMAGE + 1;
+  }
+  /**
+   * Retrieves the image of a page.
+   */
+  virtual void GetPageImages( unsigned int pageId, std::vector< const char* >& imagePaths )
+  {
+    if( pageId == 0 )
+    {
+      imagePaths.push_back( BOOK_COVER_PORTRAIT );
+    }
+    else
+    {
+      imagePaths.push_back( PAGE_IMAGES_PORTRAIT[ (pageId-1) % NUMBER_OF_PORTRAIT_IMAGE ] );
+    }
+  }
+};
+
+class LandscapePageFactory : public CachedPageFactory
 {
 
   /**
@@ -129,25 +502,21 @@ class LandscapePageFactory : public PageFactory
     return 10*NUMBER_OF_LANDSCAPE_IMAGE / 2 + 1;
   }
   /**
-   * Create an image to represent a page.
-   * @param[in] pageId The ID of the page to create.
-   * @return An image, or an uninitialized pointer if the ID is out of range.
+   * Retrieves the two images of a double page.
    */
-  virtual Image NewPage( unsigned int pageId )
+  virtual void GetPageImages( unsigned int pageId, std::vector< const char* >& imagePaths )
   {
-
-    Atlas page;
     if( pageId == 0 )
     {
-      page = LoadImages( BOOK_COVER_LANDSCAPE, BOOK_COVER_BACK_LANDSCAPE );
+      imagePaths.push_back( BOOK_COVER_LANDSCAPE );
+      imagePaths.push_back( BOOK_COVER_BACK_LANDSCAPE );
     }
     else
     {
       unsigned int imageId = (pageId-1)*2;
-      page = LoadImages( PAGE_IMAGES_LANDSCAPE[ imageId % NUMBER_OF_LANDSCAPE_IMAGE ], PAGE_IMAGES_LANDSCAPE[ (imageId+1) % NUMBER_OF_LANDSCAPE_IMAGE ] );
+      imagePaths.push_back( PAGE_IMAGES_LANDSCAPE[ imageId % NUMBER_OF_LANDSCAPE_IMAGE ] );
+      imagePaths.push_back( PAGE_IMAGES_LANDSCAPE[ (imageId+1) % NUMBER_OF_LANDSCAPE_IMAGE ] );
     }
-
-    return page;
   }
 };
 
@@ -263,6 +632,10 @@ void PageTurnController::OnInit( Application& app )
   Vector2 bookSize( stageSize.x > stageSize.y ? stageSize.y : stageSize.x,
                     stageSize.x > stageSize.y ? stageSize.x : stageSize.y );
 
+  // Pages are shrunk to the size they are shown at; a double page is two images side by side
+  mPortraitPageFactory.SetImageSize( ImageDimensions( bookSize.x, bookSize.y ) );
+  mLandscapePageFactory.SetImageSize( ImageDimensions( bookSize.y * 0.5f, bookSize.x ) );
+
   mPageTurnPortraitView = PageTurnPortraitView::New( mPortraitPageFactory, bookSize );
   mPageTurnPortraitView.SetParentOrigin( ParentOrigin::CENTER );
   mPageTurnPortraitView.SetAnchorPoint( AnchorPoint::CENTER );
@@ -304,6 +677,7 @@ bool PageTurnController::OnButtonClicked(Toolkit::Button button)
     Stage::GetCurrent().Add( mPageTurnLandscapeView );
     int pageId = mPageTurnPortraitView.GetProperty( PageTurnView::Property::CURRENT_PAGE_ID ).Get<int>();
     int currentPage = ceil( static_cast<float>(pageId) / PAGE_NUMBER_CORRESPONDING_RATIO );
+    mLandscapePageFactory.PrefetchFrom( currentPage );
     mPageTurnLandscapeView.SetProperty(PageTurnView::Property::CURRENT_PAGE_ID, currentPage );
   }
   else
@@ -312,6 +686,7 @@ bool PageTurnController::OnButtonClicked(Toolkit::Button button)
     Stage::GetCurrent().Add( mPageTurnPortraitView );
     int pageId = mPageTurnLandscapeView.GetProperty( PageTurnView::Property::CURRENT_PAGE_ID ).Get<int>();
     int currentPage = floor(pageId * PAGE_NUMBER_CORRESPONDING_RATIO );
+    mPortraitPageFactory.PrefetchFrom( currentPage );
     mPageTurnPortraitView.SetProperty(PageTurnView::Property::CURRENT_PAGE_ID, currentPage );
   }
 
@@ -340,6 +715,17 @@ void PageTurnController::OnPageStartedTurn( PageTurnView pageTurnView, unsigned
            << " page " << pageIndex
            << ( isTurningForward ? " is starting to turn forward" : " is starting to turn backward" )
            << std::endl;
+
+  // Turning a page forward shows the one after it, turning it backward shows the page itself
+  const unsigned int turnedToPage = isTurningForward ? pageIndex + 1u : pageIndex;
+  if( pageTurnView == mPageTurnPortraitView )
+  {
+    mPortraitPageFactory.OnTurnStarted( turnedToPage );
+  }
+  else
+  {
+    mLandscapePageFactory.OnTurnStarted( turnedToPage );
+  }
 }
 
 void PageTurnController::OnPageFinishedTurn( PageTurnView pageTurnView, unsigned int pageIndex, bool isTurningForward )
@@ -348,11 +734,29 @@ void PageTurnController::OnPageFinishedTurn( PageTurnView pageTurnView, unsigned
            << " page " << pageIndex
            << ( isTurningForward ? " has finished turning forward" : " has finished turning backward" )
            << std::endl;
+
+  if( pageTurnView == mPageTurnPortraitView )
+  {
+    mPortraitPageFactory.PrintStatistics();
+  }
+  else
+  {
+    mLandscapePageFactory.PrintStatistics();
+  }
 }
 
 void PageTurnController::OnPageStartedPan( PageTurnView pageTurnView )
 {
   std::cout<< "Starting to pan" << std::endl;
+
+  if( pageTurnView == mPageTurnPortraitView )
+  {
+    mPortraitPageFactory.OnGestureStarted();
+  }
+  else
+  {
+    mLandscapePageFactory.OnGestureStarted();
+  }
 }
 
 void PageTurnController::OnPageFinishedPan( PageTurnView pageTurnView )
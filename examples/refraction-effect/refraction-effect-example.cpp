@@ -23,10 +23,16 @@
 #include <fstream>
 #include <sstream>
 #include <limits>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
 
 // INTERNAL INCLUDES
 #include "shared/view.h"
 #include "shared/utility.h"
+#include "shared/obj-loader.h"
+#include "shared/mesh-optimizer.h"
+#include "shared/mesh-kernels.h"
 
 using namespace Dali;
 
@@ -46,6 +52,26 @@ const char* MESH_FILES[] =
 };
 const unsigned int NUM_MESH_FILES( sizeof( MESH_FILES ) / sizeof( MESH_FILES[0] ) );
 
+/**
+ * The bundled OBJ models loaded by --benchmark
+ */
+const char* BENCHMARK_MESH_FILES[] =
+{
+ DEMO_MODEL_DIR "surface_pattern_v01.obj",
+ DEMO_MODEL_DIR "surface_pattern_v02.obj",
+ DEMO_MODEL_DIR "Dino.obj",
+ DEMO_MODEL_DIR "ToyRobot-Metal.obj",
+ DEMO_MODEL_DIR "Toyrobot-Plastic.obj"
+};
+const unsigned int NUM_BENCHMARK_MESH_FILES( sizeof( BENCHMARK_MESH_FILES ) / sizeof( BENCHMARK_MESH_FILES[0] ) );
+const unsigned int BENCHMARK_ITERATIONS( 20u );
+const Vector2 BENCHMARK_STAGE_SIZE( 720.0f, 1280.0f );
+
+/**
+ * Set by --indexed to draw the surface with an index buffer, sharing the vertices which are identical.
+ */
+bool INDEXED_GEOMETRY = false;
+
 const char* TEXTURE_IMAGES[]=
 {
   DEMO_IMAGE_DIR "background-1.jpg",
@@ -91,6 +117,557 @@ struct Vertex
   {}
 };
 
+/**
+ * Reads an OBJ file line by line with streams. This was how the meshes were loaded before
+ * ParseObj(); it is kept to compare the two with --benchmark.
+ */
+void ReadObjFileWithStreams( const std::string& objFileName,
+    Vector<float>& boundingBox,
+    std::vector<Vector3>& vertexPositions,
+    Vector<unsigned int>& faceIndices)
+{
+  std::ifstream ifs( objFileName.c_str(), std::ios::in );
+
+  boundingBox.Resize( 6 );
+  boundingBox[0]=boundingBox[2]=boundingBox[4] = std::numeric_limits<float>::max();
+  boundingBox[1]=boundingBox[3]=boundingBox[5] = -std::numeric_limits<float>::max();
+
+  std::string line;
+  while( std::getline( ifs, line ) )
+  {
+    if( line[0] == 'v' && std::isspace(line[1]))  // vertex
+    {
+      std::istringstream iss(line.substr(2), std::istringstream::in);
+      unsigned int i = 0;
+      Vector3 vertex;
+      while( iss >> vertex[i++] && i < 3);
+      if( vertex.x < boundingBox[0] )  boundingBox[0] = vertex.x;
+      if( vertex.x > boundingBox[1] )  boundingBox[1] = vertex.x;
+      if( vertex.y < boundingBox[2] )  boundingBox[2] = vertex.y;
+      if( vertex.y > boundingBox[3] )  boundingBox[3] = vertex.y;
+      if( vertex.z < boundingBox[4] )  boundingBox[4] = vertex.z;
+      if( vertex.z > boundingBox[5] )  boundingBox[5] = vertex.z;
+      vertexPositions.push_back( vertex );
+    }
+    else if( line[0] == 'f' ) //face
+    {
+      unsigned int numOfInt = 3;
+      while( true )
+      {
+        std::size_t found  = line.find('/');
+        if( found == std::string::npos )
+        {
+          break;
+        }
+        line[found] = ' ';
+        numOfInt++;
+      }
+
+      std::istringstream iss(line.substr(2), std::istringstream::in);
+      unsigned int indices[ numOfInt ];
+      unsigned int i=0;
+      while( iss >> indices[i++] && i < numOfInt);
+      unsigned int step = (i+1) / 3;
+      faceIndices.PushBack( indices[0]-1 );
+      faceIndices.PushBack( indices[step]-1 );
+      faceIndices.PushBack( indices[2*step]-1 );
+    }
+  }
+
+  ifs.close();
+}
+
+/**
+ * Aligns the mesh, scales it to fit the stage size, and calculates the texture coordinate for each vertex
+ */
+void ShapeResizeAndTexureCoordinateCalculation( const Vector3& boundingBoxMin,
+    const Vector3& boundingBoxMax,
+    const Vector2& stageSize,
+    DemoHelper::Vector3Streams& vertexPositions,
+    DemoHelper::Vector2Streams& textureCoordinates)
+{
+  Vector3 bBoxSize( boundingBoxMax - boundingBoxMin );
+
+  Vector3 scale( stageSize.x / bBoxSize.x, stageSize.y / bBoxSize.y, 1.f );
+  scale.z = (scale.x + scale.y)/2.f;
+
+  DemoHelper::CalculatePlanarTextureCoordinates( vertexPositions, boundingBoxMin.GetVectorXY(), bBoxSize.GetVectorXY(), textureCoordinates );
+  DemoHelper::TransformPositions( vertexPositions, -( boundingBoxMin + bBoxSize * 0.5f ), scale );
+}
+
+/**
+ * Re-organizes the mesh, the vertices are duplicated, each vertex only belongs to one triangle.
+ * Without sharing vertex between triangle, so we can manipulate the texture offset on each triangle conveniently.
+ */
+void CreateSurfaceVertices( const DemoHelper::Vector3Streams& vertexPositions,
+    const std::vector<unsigned int>& faceIndices,
+    const DemoHelper::Vector3Streams& faceNormals,
+    const DemoHelper::Vector2Streams& textureCoordinates,
+    std::vector<Vertex>& vertices )
+{
+  std::size_t size = faceIndices.size();
+  vertices.reserve( size );
+
+  for( std::size_t i=0; i<size; i=i+3 )
+  {
+    Vector3 normal = faceNormals[ i / 3 ];
+
+    // make sure all the faces are front-facing
+    if( normal.z > 0 )
+    {
+      vertices.push_back( Vertex( vertexPositions[ faceIndices[i] ], normal, textureCoordinates[ faceIndices[i] ] ) );
+      vertices.push_back( Vertex( vertexPositions[ faceIndices[i+1] ], normal, textureCoordinates[ faceIndices[i+1] ] ) );
+      vertices.push_back( Vertex( vertexPositions[ faceIndices[i+2] ], normal, textureCoordinates[ faceIndices[i+2] ] ) );
+    }
+    else
+    {
+      normal *= -1.f;
+      vertices.push_back( Vertex( vertexPositions[ faceIndices[i] ], normal, textureCoordinates[ faceIndices[i] ] ) );
+      vertices.push_back( Vertex( vertexPositions[ faceIndices[i+2] ], normal, textureCoordinates[ faceIndices[i+2] ] ) );
+      vertices.push_back( Vertex( vertexPositions[ faceIndices[i+1] ], normal, textureCoordinates[ faceIndices[i+1] ] ) );
+    }
+  }
+}
+
+/**
+ * Retrieves the path of a cache of the surface built from an OBJ file.
+ */
+std::string GetSurfaceCachePath( const std::string& objFileName, const char* suffix = ".cache" )
+{
+  std::string::size_type slash = objFileName.rfind( '/' );
+  return DemoHelper::GetCacheDirectory() + "refraction-effect-" + objFileName.substr( slash == std::string::npos ? 0 : slash + 1 ) + suffix;
+}
+
+/**
+ * Retrieves the key of the caches of the surface, the hash of the OBJ file and the stage size it is scaled to.
+ */
+uint64_t GetSurfaceCacheKey( const DemoHelper::MappedFile& file, const Vector2& stageSize )
+{
+  return DemoHelper::HashData( reinterpret_cast<const char*>( &stageSize ), sizeof( stageSize ),
+                               DemoHelper::HashData( file.GetData(), file.GetSize() ) );
+}
+
+/**
+ * Loads the vertices of the surface from an OBJ file. The vertices are cached, keyed by the hash
+ * of the file and the stage size they were scaled to, so they are only built once.
+ * @return false if the file cannot be read or parsed
+ */
+bool LoadSurfaceVertices( const std::string& objFileName, const Vector2& stageSize, std::vector<Vertex>& vertices )
+{
+  DemoHelper::MappedFile file;
+  if( !file.Open( objFileName ) )
+  {
+    return false;
+  }
+
+  const uint64_t key = GetSurfaceCacheKey( file, stageSize );
+  const std::string cachePath = GetSurfaceCachePath( objFileName );
+  if( DemoHelper::ReadBinaryCache( cachePath, key, vertices ) )
+  {
+    return true;
+  }
+
+  // read the vertice and faces from the .obj file, and calculate the bounding box
+  DemoHelper::Vector3Streams vertexPositions;
+  std::vector<unsigned int> faceIndices;
+  if( !DemoHelper::ParseObj( file.GetData(), file.GetSize(), vertexPositions, faceIndices ) )
+  {
+    return false;
+  }
+  Vector3 boundingBoxMin, boundingBoxMax;
+  DemoHelper::CalculateBounds( vertexPositions, boundingBoxMin, boundingBoxMax );
+
+  DemoHelper::Vector2Streams textureCoordinates;
+  ShapeResizeAndTexureCoordinateCalculation( boundingBoxMin, boundingBoxMax, stageSize, vertexPositions, textureCoordinates );
+
+  DemoHelper::Vector3Streams faceNormals;
+  DemoHelper::CalculateFaceNormals( vertexPositions, faceIndices, faceNormals );
+  CreateSurfaceVertices( vertexPositions, faceIndices, faceNormals, textureCoordinates, vertices );
+
+  DemoHelper::WriteBinaryCache( cachePath, key, vertices );
+  return true;
+}
+
+/**
+ * Builds indexed vertices from the three vertices per triangle of the surface. The surface is flat
+ * shaded, so only the corners of coplanar triangles can be shared. The triangles are then reordered
+ * to reuse the vertices in the post-transform cache.
+ * @return false if there are too many vertices for 16 bit indices, or indexing would not make the geometry smaller
+ */
+bool CreateIndexedSurface( const std::vector<Vertex>& expandedVertices, std::vector<Vertex>& vertices, std::vector<unsigned short>& indices )
+{
+  DemoHelper::DeduplicateVertices( expandedVertices, vertices, indices );
+  if( vertices.size() > std::numeric_limits<unsigned short>::max() + 1u ||
+      vertices.size() * sizeof( Vertex ) + indices.size() * sizeof( unsigned short ) >= expandedVertices.size() * sizeof( Vertex ) )
+  {
+    vertices.clear();
+    indices.clear();
+    return false;
+  }
+
+  DemoHelper::OptimizeTriangleOrder( indices, vertices.size() );
+  return true;
+}
+
+/**
+ * Loads the surface as indexed vertices, which are cached like LoadSurfaceVertices().
+ * @return false if the file cannot be read or parsed, or the surface cannot be indexed
+ */
+bool LoadIndexedSurface( const std::string& objFileName, const Vector2& stageSize, std::vector<Vertex>& vertices, std::vector<unsigned short>& indices )
+{
+  uint64_t key = 0u;
+  {
+    DemoHelper::MappedFile file;
+    if( !file.Open( objFileName ) )
+    {
+      return false;
+    }
+    key = GetSurfaceCacheKey( file, stageSize );
+  }
+
+  const std::string vertexCachePath = GetSurfaceCachePath( objFileName, ".indexed.cache" );
+  const std::string indexCachePath = GetSurfaceCachePath( objFileName, ".indices.cache" );
+  if( DemoHelper::ReadBinaryCache( vertexCachePath, key, vertices ) &&
+      DemoHelper::ReadBinaryCache( indexCachePath, key, indices ) )
+  {
+    return true;
+  }
+
+  std::vector<Vertex> expandedVertices;
+  if( !LoadSurfaceVertices( objFileName, stageSize, expandedVertices ) ||
+      !CreateIndexedSurface( expandedVertices, vertices, indices ) )
+  {
+    return false;
+  }
+
+  DemoHelper::WriteBinaryCache( vertexCachePath, key, vertices );
+  DemoHelper::WriteBinaryCache( indexCachePath, key, indices );
+  return true;
+}
+
+/**
+ * Prints the time taken to load each bundled OBJ model by the stream reader, ParseObj() and from the cache,
+ * and the size of the geometry with and without an index buffer.
+ */
+void RunLoadBenchmark()
+{
+  for( unsigned int fileIndex = 0; fileIndex < NUM_BENCHMARK_MESH_FILES; ++fileIndex )
+  {
+    const std::string objFileName( BENCHMARK_MESH_FILES[fileIndex] );
+    double streamTime = 0.0, parseTime = 0.0, cacheTime = 0.0;
+    size_t streamFaces = 0u, parsedFaces = 0u, cachedVertices = 0u;
+
+    // Build the cache first
+    std::vector<Vertex> vertices;
+    LoadSurfaceVertices( objFileName, BENCHMARK_STAGE_SIZE, vertices );
+
+    for( unsigned int i = 0; i < BENCHMARK_ITERATIONS; ++i )
+    {
+      double start = DemoHelper::GetMilliseconds();
+      {
+        Vector<float> boundingBox;
+        std::vector<Vector3> vertexPositions;
+        Vector<unsigned int> faceIndices;
+        ReadObjFileWithStreams( objFileName, boundingBox, vertexPositions, faceIndices );
+        streamFaces = faceIndices.Size() / 3u;
+      }
+      double end = DemoHelper::GetMilliseconds();
+      streamTime += end - start;
+
+      start = end;
+      {
+        DemoHelper::MappedFile file;
+        DemoHelper::Vector3Streams vertexPositions;
+        std::vector<unsigned int> faceIndices;
+        if( file.Open( objFileName ) )
+        {
+          DemoHelper::ParseObj( file.GetData(), file.GetSize(), vertexPositions, faceIndices );
+        }
+        parsedFaces = faceIndices.size() / 3u;
+      }
+      end = DemoHelper::GetMilliseconds();
+      parseTime += end - start;
+
+      start = end;
+      {
+        std::vector<Vertex> cached;
+        LoadSurfaceVertices( objFileName, BENCHMARK_STAGE_SIZE, cached );
+        cachedVertices = cached.size();
+      }
+      cacheTime += DemoHelper::GetMilliseconds() - start;
+    }
+
+    std::cout << objFileName << ": " << parsedFaces << " faces (" << streamFaces << " with streams, "
+              << cachedVertices / 3u << " cached); mean ms: streams " << streamTime / BENCHMARK_ITERATIONS
+              << ", mmap parser " << parseTime / BENCHMARK_ITERATIONS
+              << ", cached vertices " << cacheTime / BENCHMARK_ITERATIONS << std::endl;
+
+    // Compare the geometry drawn with and without an index buffer
+    std::vector<Vertex> indexedVertices;
+    std::vector<unsigned short> indices;
+    double start = DemoHelper::GetMilliseconds();
+    DemoHelper::DeduplicateVertices( vertices, indexedVertices, indices );
+    const float fileOrderAcmr = DemoHelper::CalculateAverageCacheMissRatio( indices, indexedVertices.size() );
+    const bool fitsIndices = indexedVertices.size() <= std::numeric_limits<unsigned short>::max() + 1u;
+    if( fitsIndices )
+    {
+      DemoHelper::OptimizeTriangleOrder( indices, indexedVertices.size() );
+    }
+    const double indexTime = DemoHelper::GetMilliseconds() - start;
+
+    const size_t bytes = vertices.size() * sizeof( Vertex );
+    const size_t indexedBytes = indexedVertices.size() * sizeof( Vertex ) + indices.size() * sizeof( unsigned short );
+    std::cout << "  non-indexed: " << vertices.size() << " vertices, " << bytes << " bytes" << std::endl;
+    std::cout << "  indexed: " << indexedVertices.size() << " vertices, " << indexedBytes << " bytes";
+    if( fitsIndices )
+    {
+      std::cout << "; ACMR " << fileOrderAcmr << " in file order, "
+                << DemoHelper::CalculateAverageCacheMissRatio( indices, indexedVertices.size() ) << " reordered"
+                << "; built in " << indexTime << " ms" << ( indexedBytes < bytes ? "" : "; not smaller, --indexed draws it non-indexed" ) << std::endl;
+    }
+    else
+    {
+      std::cout << "; too many vertices for 16 bit indices" << std::endl;
+    }
+  }
+}
+
+/**
+ * Runs a mesh kernel. If measured, it is run BENCHMARK_ITERATIONS times and the throughput in millions of elements per second is returned.
+ */
+template< typename Kernel >
+double RunKernel( Kernel& kernel, size_t elementCount, bool measure )
+{
+  if( !measure )
+  {
+    kernel();
+    return 0.0;
+  }
+
+  const double start = DemoHelper::GetMilliseconds();
+  for( unsigned int i = 0; i < BENCHMARK_ITERATIONS; ++i )
+  {
+    kernel();
+  }
+  return elementCount * BENCHMARK_ITERATIONS / ( ( DemoHelper::GetMilliseconds() - start ) * 1000.0 );
+}
+
+/**
+ * Returns whether two arrays are equal within a tolerance, relative to the magnitude of their values.
+ */
+bool NearlyEqual( const std::vector<float>& lhs, const std::vector<float>& rhs )
+{
+  if( lhs.size() != rhs.size() )
+  {
+    return false;
+  }
+  for( size_t i = 0; i < lhs.size(); ++i )
+  {
+    if( fabsf( lhs[i] - rhs[i] ) > 1e-5f * std::max( 1.0f, fabsf( rhs[i] ) ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * The mesh kernels as functors, so that RunKernel() can run both the vectorized and scalar versions.
+ */
+struct BoundsKernel
+{
+  BoundsKernel( const DemoHelper::Vector3Streams& positions, bool vectorized ) : positions( positions ), vectorized( vectorized ) {}
+  void operator()()
+  {
+    if( vectorized )
+    {
+      DemoHelper::CalculateBounds( positions, min, max );
+    }
+    else
+    {
+      float minimum[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+      float maximum[3] = { -minimum[0], -minimum[1], -minimum[2] };
+      DemoHelper::MeshKernelsDetail::CalculateBoundsScalar( &positions.x[0], &positions.y[0], &positions.z[0], 0u, positions.Size(), minimum, maximum );
+      min = Vector3( minimum[0], minimum[1], minimum[2] );
+      max = Vector3( maximum[0], maximum[1], maximum[2] );
+    }
+  }
+  const DemoHelper::Vector3Streams& positions;
+  bool vectorized;
+  Vector3 min, max;
+};
+
+struct TransformKernel
+{
+  TransformKernel( const DemoHelper::Vector3Streams& positions, bool vectorized ) : positions( positions ), vectorized( vectorized ) {}
+  void operator()()
+  {
+    // Each run starts from the original positions, so the copy is part of the time for both versions
+    result = positions;
+    const Vector3 offset( -0.5f, -0.5f, -0.5f ), scale( 720.0f, 1280.0f, 1000.0f );
+    if( vectorized )
+    {
+      DemoHelper::TransformPositions( result, offset, scale );
+    }
+    else
+    {
+      DemoHelper::MeshKernelsDetail::TransformScalar( &result.x[0], &result.y[0], &result.z[0], 0u, result.Size(), offset, scale );
+    }
+  }
+  const DemoHelper::Vector3Streams& positions;
+  bool vectorized;
+  DemoHelper::Vector3Streams result;
+};
+
+struct NormalizeKernel
+{
+  NormalizeKernel( const DemoHelper::Vector3Streams& vectors, bool vectorized ) : vectors( vectors ), vectorized( vectorized ) {}
+  void operator()()
+  {
+    result = vectors;
+    if( vectorized )
+    {
+      DemoHelper::NormalizeVectors( result );
+    }
+    else
+    {
+      DemoHelper::MeshKernelsDetail::NormalizeScalar( &result.x[0], &result.y[0], &result.z[0], 0u, result.Size() );
+    }
+  }
+  const DemoHelper::Vector3Streams& vectors;
+  bool vectorized;
+  DemoHelper::Vector3Streams result;
+};
+
+struct FaceNormalsKernel
+{
+  FaceNormalsKernel( const DemoHelper::Vector3Streams& positions, const std::vector<unsigned int>& faceIndices, bool vectorized )
+  : positions( positions ), faceIndices( faceIndices ), vectorized( vectorized ) {}
+  void operator()()
+  {
+    if( vectorized )
+    {
+      DemoHelper::CalculateFaceNormals( positions, faceIndices, normals );
+    }
+    else
+    {
+      normals.Resize( faceIndices.size() / 3u );
+      DemoHelper::MeshKernelsDetail::FaceNormalsScalar( &positions.x[0], &positions.y[0], &positions.z[0], &faceIndices[0], 0u, normals.Size(),
+                                                        &normals.x[0], &normals.y[0], &normals.z[0] );
+    }
+  }
+  const DemoHelper::Vector3Streams& positions;
+  const std::vector<unsigned int>& faceIndices;
+  bool vectorized;
+  DemoHelper::Vector3Streams normals;
+};
+
+struct TextureCoordinatesKernel
+{
+  TextureCoordinatesKernel( const DemoHelper::Vector3Streams& positions, bool vectorized ) : positions( positions ), vectorized( vectorized ) {}
+  void operator()()
+  {
+    const Vector2 origin( -1.0f, -1.0f ), size( 2.0f, 2.0f );
+    if( vectorized )
+    {
+      DemoHelper::CalculatePlanarTextureCoordinates( positions, origin, size, textureCoordinates );
+    }
+    else
+    {
+      textureCoordinates.Resize( positions.Size() );
+      DemoHelper::MeshKernelsDetail::PlanarTextureCoordinatesScalar( &positions.x[0], &positions.y[0], 0u, positions.Size(), origin,
+                                                                     Vector2( 1.0f / size.x, 1.0f / size.y ),
+                                                                     &textureCoordinates.x[0], &textureCoordinates.y[0] );
+    }
+  }
+  const DemoHelper::Vector3Streams& positions;
+  bool vectorized;
+  DemoHelper::Vector2Streams textureCoordinates;
+};
+
+/**
+ * Checks that the vectorized mesh kernels match the scalar ones, including the elements left over
+ * after the SIMD loops, and prints the throughput of both on a large random mesh.
+ * @return false if a kernel does not match
+ */
+bool RunKernelBenchmark()
+{
+#if defined( DEMO_MESH_KERNELS_SSE )
+  std::cout << "Mesh kernels: SSE" << std::endl;
+#elif defined( DEMO_MESH_KERNELS_NEON )
+  std::cout << "Mesh kernels: NEON" << std::endl;
+#else
+  std::cout << "Mesh kernels: scalar only" << std::endl;
+#endif
+
+  bool passed = true;
+
+  // The small sizes check the elements left over after the SIMD loops; only the last size is timed
+  const size_t SIZES[] = { 1u, 3u, 4u, 7u, 1021u, 1000000u };
+  const size_t NUM_SIZES = sizeof( SIZES ) / sizeof( SIZES[0] );
+  const char* KERNEL_NAMES[] = { "bounds", "transform", "normalize", "face normals", "planar uvs" };
+  const unsigned int NUM_KERNELS = sizeof( KERNEL_NAMES ) / sizeof( KERNEL_NAMES[0] );
+  srand( 1 );
+  for( size_t sizeIndex = 0; sizeIndex < NUM_SIZES; ++sizeIndex )
+  {
+    const size_t count = SIZES[sizeIndex];
+    const bool measure = sizeIndex + 1u == NUM_SIZES;
+    DemoHelper::Vector3Streams positions;
+    std::vector<unsigned int> faceIndices;
+    for( size_t i = 0; i < count; ++i )
+    {
+      positions.PushBack( rand() * 2.0f / RAND_MAX - 1.0f, rand() * 2.0f / RAND_MAX - 1.0f, rand() * 2.0f / RAND_MAX - 1.0f );
+      faceIndices.push_back( rand() % count );
+      faceIndices.push_back( rand() % count );
+      faceIndices.push_back( rand() % count );
+    }
+    // A degenerate face, which must get a zero normal
+    faceIndices[1] = faceIndices[2] = faceIndices[0];
+
+    BoundsKernel bounds( positions, true ), scalarBounds( positions, false );
+    TransformKernel transform( positions, true ), scalarTransform( positions, false );
+    NormalizeKernel normalize( positions, true ), scalarNormalize( positions, false );
+    FaceNormalsKernel faceNormals( positions, faceIndices, true ), scalarFaceNormals( positions, faceIndices, false );
+    TextureCoordinatesKernel textureCoordinates( positions, true ), scalarTextureCoordinates( positions, false );
+
+    const double rates[NUM_KERNELS][2] =
+    {
+      { RunKernel( bounds, count, measure ), RunKernel( scalarBounds, count, measure ) },
+      { RunKernel( transform, count, measure ), RunKernel( scalarTransform, count, measure ) },
+      { RunKernel( normalize, count, measure ), RunKernel( scalarNormalize, count, measure ) },
+      { RunKernel( faceNormals, count, measure ), RunKernel( scalarFaceNormals, count, measure ) },
+      { RunKernel( textureCoordinates, count, measure ), RunKernel( scalarTextureCoordinates, count, measure ) }
+    };
+    const bool matches[NUM_KERNELS] =
+    {
+      bounds.min == scalarBounds.min && bounds.max == scalarBounds.max,
+      NearlyEqual( transform.result.x, scalarTransform.result.x ) && NearlyEqual( transform.result.y, scalarTransform.result.y ) &&
+        NearlyEqual( transform.result.z, scalarTransform.result.z ),
+      NearlyEqual( normalize.result.x, scalarNormalize.result.x ) && NearlyEqual( normalize.result.y, scalarNormalize.result.y ) &&
+        NearlyEqual( normalize.result.z, scalarNormalize.result.z ),
+      NearlyEqual( faceNormals.normals.x, scalarFaceNormals.normals.x ) && NearlyEqual( faceNormals.normals.y, scalarFaceNormals.normals.y ) &&
+        NearlyEqual( faceNormals.normals.z, scalarFaceNormals.normals.z ) && faceNormals.normals[0] == Vector3::ZERO,
+      NearlyEqual( textureCoordinates.textureCoordinates.x, scalarTextureCoordinates.textureCoordinates.x ) &&
+        NearlyEqual( textureCoordinates.textureCoordinates.y, scalarTextureCoordinates.textureCoordinates.y )
+    };
+
+    for( unsigned int i = 0; i < NUM_KERNELS; ++i )
+    {
+      if( !matches[i] )
+      {
+        std::cout << "  " << KERNEL_NAMES[i] << ": vectorized and scalar results differ for " << count << " vertices" << std::endl;
+        passed = false;
+      }
+      else if( measure )
+      {
+        std::cout << "  " << KERNEL_NAMES[i] << ": " << count << " elements, M/s vectorized " << rates[i][0] << ", scalar " << rates[i][1] << std::endl;
+      }
+    }
+  }
+
+  return passed;
+}
+
 /************************************************************************************************
  *** The shader source is used when the MeshActor is not touched***
  ************************************************************************************************/
@@ -398,137 +975,46 @@ private:
 
   Geometry CreateGeometry(const std::string& objFileName)
   {
-    std::vector<Vector3> vertexPositions;
-    Vector<unsigned int> faceIndices;
-    Vector<float> boundingBox;
-    // read the vertice and faces from the .obj file, and record the bounding box
-    ReadObjFile( objFileName, boundingBox, vertexPositions, faceIndices );
-
-    std::vector<Vector2> textureCoordinates;
-    // align the mesh, scale it to fit the screen size, and calculate the texture coordinate for each vertex
-    ShapeResizeAndTexureCoordinateCalculation( boundingBox, vertexPositions, textureCoordinates );
-
-    // re-organize the mesh, the vertices are duplicated, each vertex only belongs to one triangle.
-    // Without sharing vertex between triangle, so we can manipulate the texture offset on each triangle conveniently.
+    const Vector2 stageSize = Stage::GetCurrent().GetSize();
     std::vector<Vertex> vertices;
-
-    std::size_t size = faceIndices.Size();
-    vertices.reserve( size );
-
-    for( std::size_t i=0; i<size; i=i+3 )
+    std::vector<unsigned short> indices;
+    bool loaded = INDEXED_GEOMETRY && LoadIndexedSurface( objFileName, stageSize, vertices, indices );
+    if( !loaded )
     {
-      Vector3 edge1 = vertexPositions[ faceIndices[i+2] ] - vertexPositions[ faceIndices[i] ];
-      Vector3 edge2 = vertexPositions[ faceIndices[i+1] ] - vertexPositions[ faceIndices[i] ];
-      Vector3 normal = edge1.Cross(edge2);
-      normal.Normalize();
-
-      // make sure all the faces are front-facing
-      if( normal.z > 0 )
-      {
-        vertices.push_back( Vertex( vertexPositions[ faceIndices[i] ], normal, textureCoordinates[ faceIndices[i] ] ) );
-        vertices.push_back( Vertex( vertexPositions[ faceIndices[i+1] ], normal, textureCoordinates[ faceIndices[i+1] ] ) );
-        vertices.push_back( Vertex( vertexPositions[ faceIndices[i+2] ], normal, textureCoordinates[ faceIndices[i+2] ] ) );
-      }
-      else
-      {
-        normal *= -1.f;
-        vertices.push_back( Vertex( vertexPositions[ faceIndices[i] ], normal, textureCoordinates[ faceIndices[i] ] ) );
-        vertices.push_back( Vertex( vertexPositions[ faceIndices[i+2] ], normal, textureCoordinates[ faceIndices[i+2] ] ) );
-        vertices.push_back( Vertex( vertexPositions[ faceIndices[i+1] ], normal, textureCoordinates[ faceIndices[i+1] ] ) );
-      }
+      vertices.clear();
+      indices.clear();
+      loaded = LoadSurfaceVertices( objFileName, stageSize, vertices );
+    }
+    if( !loaded )
+    {
+      std::cerr << "Failed to load mesh " << objFileName << std::endl;
     }
 
+    const double start = DemoHelper::GetMilliseconds();
+
     Property::Map vertexFormat;
     vertexFormat["aPosition"] = Property::VECTOR3;
     vertexFormat["aNormal"] = Property::VECTOR3;
     vertexFormat["aTexCoord"] = Property::VECTOR2;
     PropertyBuffer surfaceVertices = PropertyBuffer::New( vertexFormat );
-    surfaceVertices.SetData( &vertices[0], vertices.size() );
+    if( !vertices.empty() )
+    {
+      surfaceVertices.SetData( &vertices[0], vertices.size() );
+    }
 
     Geometry surface = Geometry::New();
     surface.AddVertexBuffer( surfaceVertices );
-
-    return surface;
-  }
-
-  void ReadObjFile( const std::string& objFileName,
-      Vector<float>& boundingBox,
-      std::vector<Vector3>& vertexPositions,
-      Vector<unsigned int>& faceIndices)
-  {
-    std::ifstream ifs( objFileName.c_str(), std::ios::in );
-
-    boundingBox.Resize( 6 );
-    boundingBox[0]=boundingBox[2]=boundingBox[4] = std::numeric_limits<float>::max();
-    boundingBox[1]=boundingBox[3]=boundingBox[5] = -std::numeric_limits<float>::max();
-
-    std::string line;
-    while( std::getline( ifs, line ) )
+    if( !indices.empty() )
     {
-      if( line[0] == 'v' && std::isspace(line[1]))  // vertex
-      {
-        std::istringstream iss(line.substr(2), std::istringstream::in);
-        unsigned int i = 0;
-        Vector3 vertex;
-        while( iss >> vertex[i++] && i < 3);
-        if( vertex.x < boundingBox[0] )  boundingBox[0] = vertex.x;
-        if( vertex.x > boundingBox[1] )  boundingBox[1] = vertex.x;
-        if( vertex.y < boundingBox[2] )  boundingBox[2] = vertex.y;
-        if( vertex.y > boundingBox[3] )  boundingBox[3] = vertex.y;
-        if( vertex.z < boundingBox[4] )  boundingBox[4] = vertex.z;
-        if( vertex.z > boundingBox[5] )  boundingBox[5] = vertex.z;
-        vertexPositions.push_back( vertex );
-      }
-      else if( line[0] == 'f' ) //face
-      {
-        unsigned int numOfInt = 3;
-        while( true )
-        {
-          std::size_t found  = line.find('/');
-          if( found == std::string::npos )
-          {
-            break;
-          }
-          line[found] = ' ';
-          numOfInt++;
-        }
-
-        std::istringstream iss(line.substr(2), std::istringstream::in);
-        unsigned int indices[ numOfInt ];
-        unsigned int i=0;
-        while( iss >> indices[i++] && i < numOfInt);
-        unsigned int step = (i+1) / 3;
-        faceIndices.PushBack( indices[0]-1 );
-        faceIndices.PushBack( indices[step]-1 );
-        faceIndices.PushBack( indices[2*step]-1 );
-      }
+      surface.SetIndexBuffer( &indices[0], indices.size() );
     }
 
-    ifs.close();
-  }
+    // Only the buffer creation is timed; the data is sent to the GPU when the next frame is rendered
+    std::cout << objFileName << ": " << ( indices.empty() ? "non-indexed, " : "indexed, " ) << vertices.size() << " vertices, "
+              << vertices.size() * sizeof( Vertex ) + indices.size() * sizeof( unsigned short ) << " bytes, buffers created in "
+              << DemoHelper::GetMilliseconds() - start << " ms" << std::endl;
 
-  void ShapeResizeAndTexureCoordinateCalculation( const Vector<float>& boundingBox,
-      std::vector<Vector3>& vertexPositions,
-      std::vector<Vector2>& textureCoordinates)
-  {
-    Vector3 bBoxSize( boundingBox[1] - boundingBox[0], boundingBox[3] - boundingBox[2], boundingBox[5] - boundingBox[4]);
-    Vector3 bBoxMinCorner( boundingBox[0], boundingBox[2], boundingBox[4] );
-
-    Vector2 stageSize = Stage::GetCurrent().GetSize();
-    Vector3 scale( stageSize.x / bBoxSize.x, stageSize.y / bBoxSize.y, 1.f );
-    scale.z = (scale.x + scale.y)/2.f;
-
-    textureCoordinates.reserve(vertexPositions.size());
-
-    for( std::vector<Vector3>::iterator iter = vertexPositions.begin(); iter != vertexPositions.end(); iter++ )
-    {
-      Vector3 newPosition(  (*iter) - bBoxMinCorner ) ;
-
-     textureCoordinates.push_back( Vector2( newPosition.x / bBoxSize.x, newPosition.y / bBoxSize.y ) );
-
-      newPosition -= bBoxSize * 0.5f;
-      (*iter) = newPosition * scale;
-    }
+    return surface;
   }
 
   /**
@@ -584,6 +1070,20 @@ RunTest(Application& app)
 
 int DALI_EXPORT_API main(int argc, char **argv)
 {
+  if( argc > 1 && strcmp( argv[1], "--benchmark" ) == 0 )
+  {
+    RunLoadBenchmark();
+    return RunKernelBenchmark() ? 0 : 1;
+  }
+
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--indexed" ) == 0 )
+    {
+      INDEXED_GEOMETRY = true;
+    }
+  }
+
   Application app = Application::New(&argc, &argv, DEMO_THEME_PATH);
 
   RunTest(app);
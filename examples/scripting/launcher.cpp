@@ -25,6 +25,7 @@
 
 // INTERNAL INCLUDES
 #include "shared/view.h"
+#include "shared/compiled-layout.h"
 
 
 using namespace Dali;
@@ -73,8 +74,20 @@ void Launcher::Create( Dali::Application& application )
   // change the background color to purple
   Stage::GetCurrent().SetBackgroundColor( Vector4(0.2,0.2,0.4,1.0) );
 
+  const std::string compiledExtension( DemoHelper::COMPILED_LAYOUT_EXTENSION );
+  const bool isCompiled = mJSONFileName.size() > compiledExtension.size() &&
+                          0 == mJSONFileName.compare( mJSONFileName.size() - compiledExtension.size(), compiledExtension.size(), compiledExtension );
+
+  // Try loading a layout precompiled by dali-builder --compile, built without parsing any JSON
+  if( isCompiled )
+  {
+    if( !DemoHelper::BuildCompiledLayoutFile( mJSONFileName, stage.GetRootLayer() ) )
+    {
+      DALI_LOG_WARNING( "Could not load compiled layout '%s'\n", mJSONFileName.c_str() );
+    }
+  }
   // Try loading a JSON file
-  if( !mJSONFileName.empty() )
+  else if( !mJSONFileName.empty() )
   {
     mBuilder = Toolkit::Builder::New();
 
@@ -14,12 +14,19 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 #include <dali/dali.h>
 #include <dali-toolkit/dali-toolkit.h>
 #include <dali-toolkit/devel-api/controls/super-blur-view/super-blur-view.h>
 #include <dali-toolkit/devel-api/controls/bloom-view/bloom-view.h>
 #include "shared/view.h"
 #include "shared/utility.h"
+#include "shared/progressive-image-loader.h"
+#include "shared/quality-governor.h"
 
 using namespace Dali;
 
@@ -44,6 +51,68 @@ const char* BACKGROUND_IMAGES[]=
 };
 const unsigned int NUM_BACKGROUND_IMAGES( sizeof( BACKGROUND_IMAGES ) / sizeof( BACKGROUND_IMAGES[0] ) );
 
+/**
+ * The parameters of the blur and bloom views at a quality tier.
+ */
+struct QualityTier
+{
+  const char* name;
+  unsigned int blurLevels;        ///< The number of levels of the super blur
+  unsigned int bloomSamples;      ///< The number of samples of the bloom's gaussian blur
+  float targetScale;              ///< The size of the blur render targets, relative to the High tier
+  Pixel::Format bloomFormat;      ///< The pixel format of the bloom's render targets
+  bool refreshOnChange;           ///< Whether the bloom is only extracted and blurred again when the image changes
+};
+
+// The highest tier is what the views do by default
+const QualityTier QUALITY_TIERS[] =
+{
+  { "High",   5u, 11u, 1.0f,  Pixel::RGBA8888, false },
+  { "Medium", 4u,  9u, 0.75f, Pixel::RGB888,   true },
+  { "Low",    3u,  7u, 0.5f,  Pixel::RGB565,   true },
+  { "Lowest", 2u,  5u, 0.35f, Pixel::RGB565,   true },
+};
+const unsigned int NUM_QUALITY_TIERS( sizeof( QUALITY_TIERS ) / sizeof( QUALITY_TIERS[0] ) );
+
+const float BLOOM_BLUR_BELL_CURVE_WIDTH( 3.5f );             ///< BloomView's default
+const float BLOOM_DOWNSAMPLE_SCALE( 0.5f );                  ///< BloomView's default, at the High tier
+const Pixel::Format SUPER_BLUR_PIXEL_FORMAT( Pixel::RGB888 ); ///< SuperBlurView does not let its render target format be chosen
+
+const unsigned int QUALITY_INTERVAL( 1000u );           ///< How often, in milliseconds, the tier is adapted to the frame time
+const unsigned int BENCHMARK_PHASE_DURATION( 3000u );   ///< How long, in milliseconds, each view is measured at each tier
+
+unsigned int QUALITY_TIER = 0u;    ///< Set by --quality <tier> to start at a lower tier
+bool ADAPTIVE_QUALITY = false;     ///< Set by --adaptive-quality to choose the tier according to the measured frame time
+bool TIER_BENCHMARK = false;       ///< Set by --tier-benchmark to measure both views at every tier, print the results and quit
+
+/**
+ * Estimates the memory of the render targets of a SuperBlurView of the given size; each level is blurred
+ * at half the size of the previous one, through two intermediate targets into its own.
+ */
+unsigned int GetSuperBlurTargetMemory( const Vector2& size, const QualityTier& tier )
+{
+  unsigned int memory = 0u;
+  for( unsigned int level = 1u; level <= tier.blurLevels; ++level )
+  {
+    const unsigned int width = static_cast< unsigned int >( size.width * tier.targetScale ) >> level;
+    const unsigned int height = static_cast< unsigned int >( size.height * tier.targetScale ) >> level;
+    memory += 3u * width * height * Pixel::GetBytesPerPixel( SUPER_BLUR_PIXEL_FORMAT );
+  }
+  return memory;
+}
+
+/**
+ * Estimates the memory of the render targets of a BloomView of the given size: the children and the output
+ * at full size, and the bright extract, the blur output and the two intermediate blur targets downsampled.
+ */
+unsigned int GetBloomTargetMemory( const Vector2& size, const QualityTier& tier )
+{
+  const float downsample = BLOOM_DOWNSAMPLE_SCALE * tier.targetScale;
+  const unsigned int fullSize = static_cast< unsigned int >( size.width ) * static_cast< unsigned int >( size.height );
+  const unsigned int downsampledSize = static_cast< unsigned int >( size.width * downsample ) * static_cast< unsigned int >( size.height * downsample );
+  return ( 2u * fullSize + 4u * downsampledSize ) * Pixel::GetBytesPerPixel( tier.bloomFormat );
+}
+
 }
 
 class BlurExample : public ConnectionTracker
@@ -51,8 +120,13 @@ class BlurExample : public ConnectionTracker
 public:
   BlurExample(Application &app)
   : mApp(app),
+    mImageLoader( NULL ),
     mImageIndex( 0 ),
-    mIsBlurring( false )
+    mImageLoadId( 0 ),
+    mIsBlurring( false ),
+    mQualityTier( QUALITY_TIER ),
+    mQualityGovernor( NUM_QUALITY_TIERS, QUALITY_TIER ),
+    mBenchmarkPhase( 0u )
   {
     // Connect to the Application's Init signal
     app.InitSignal().Connect(this, &BlurExample::Create);
@@ -60,13 +134,13 @@ public:
 
   ~BlurExample()
   {
+    delete mImageLoader;
   }
 private:
   // The Init signal is received once (only) during the Application lifetime
   void Create(Application& app)
   {
     Stage stage = Stage::GetCurrent();
-    Vector2 stageSize = stage.GetSize();
 
     stage.KeyEventSignal().Connect(this, &BlurExample::OnKeyEvent);
 
@@ -99,22 +173,57 @@ private:
         Toolkit::Alignment::HorizontalLeft,
         DemoHelper::DEFAULT_MODE_SWITCH_PADDING  );
 
-    mSuperBlurView = Toolkit::SuperBlurView::New( 5 );
-    mSuperBlurView.SetSize( stageSize );
+    mImageLoader = new DemoHelper::ProgressiveImageLoader();
+    mImageLoader->ImageLoadedSignal().Connect( this, &BlurExample::OnImageLoaded );
+    mCurrentImage = DemoHelper::CreateImage( mImageLoader->LoadStageFilling( BACKGROUND_IMAGES[mImageIndex], mImageLoadId ) );
+
+    mBloomActor = Toolkit::ImageView::New(mCurrentImage);
+    mBloomActor.SetParentOrigin( ParentOrigin::CENTER );
+
+    CreateBlurViews();
+    ShowSuperBlurView();
+    SetTitle( TITLE_SUPER_BLUR );
+
+    if( ADAPTIVE_QUALITY || TIER_BENCHMARK )
+    {
+      mFrameTimeMonitor.Start( content );
+    }
+
+    if( TIER_BENCHMARK )
+    {
+      mBenchmarkTimer = Timer::New( BENCHMARK_PHASE_DURATION );
+      mBenchmarkTimer.TickSignal().Connect( this, &BlurExample::OnBenchmarkTimer );
+      mBenchmarkTimer.Start();
+      StartBenchmarkPhase();
+    }
+    else if( ADAPTIVE_QUALITY )
+    {
+      mQualityTimer = Timer::New( QUALITY_INTERVAL );
+      mQualityTimer.TickSignal().Connect( this, &BlurExample::OnQualityTimer );
+      mQualityTimer.Start();
+    }
+  }
+
+  /**
+   * Creates the blur and bloom views with the parameters of the current quality tier; neither is shown.
+   */
+  void CreateBlurViews()
+  {
+    const QualityTier& tier = QUALITY_TIERS[mQualityTier];
+    const Vector2 stageSize = Stage::GetCurrent().GetSize();
+
+    // The blurred levels are rendered at the size of the view, so a smaller view scaled up to fill the stage blurs fewer pixels
+    mSuperBlurView = Toolkit::SuperBlurView::New( tier.blurLevels );
+    mSuperBlurView.SetSize( stageSize * tier.targetScale );
+    mSuperBlurView.SetScale( 1.0f / tier.targetScale );
     mSuperBlurView.SetParentOrigin( ParentOrigin::CENTER );
     mSuperBlurView.SetAnchorPoint( AnchorPoint::CENTER );
     mSuperBlurView.BlurFinishedSignal().Connect(this, &BlurExample::OnBlurFinished);
-    mCurrentImage = DemoHelper::LoadStageFillingImage( BACKGROUND_IMAGES[mImageIndex] );
-    mSuperBlurView.SetImage( mCurrentImage );
-    mBackground.Add( mSuperBlurView );
-    mIsBlurring = true;
-    SetTitle( TITLE_SUPER_BLUR );
 
-    mBloomView = Toolkit::BloomView::New();
+    const float downsample = BLOOM_DOWNSAMPLE_SCALE * tier.targetScale;
+    mBloomView = Toolkit::BloomView::New( tier.bloomSamples, BLOOM_BLUR_BELL_CURVE_WIDTH, tier.bloomFormat, downsample, downsample );
     mBloomView.SetParentOrigin(ParentOrigin::CENTER);
     mBloomView.SetSize(stageSize);
-    mBloomActor = Toolkit::ImageView::New(mCurrentImage);
-    mBloomActor.SetParentOrigin( ParentOrigin::CENTER );
     mBloomView.Add( mBloomActor );
 
     // Connect the callback to the touch signal on the background
@@ -122,6 +231,185 @@ private:
     mBloomView.TouchSignal().Connect( this, &BlurExample::OnTouch );
   }
 
+  void ShowSuperBlurView()
+  {
+    mBackground.Add( mSuperBlurView );
+    mSuperBlurView.SetBlurStrength( 0.f );
+    mSuperBlurView.SetImage( mCurrentImage );
+    mIsBlurring = true;
+  }
+
+  void ShowBloomView()
+  {
+    mBloomActor.SetImage( mCurrentImage );
+    mBloomView.SetProperty( mBloomView.GetBloomIntensityPropertyIndex(), 0.f );
+    mBackground.Add( mBloomView );
+
+    // Activate() appends the bloom's render tasks to the list, the last one compositing the bloom with the children
+    RenderTaskList taskList = Stage::GetCurrent().GetRenderTaskList();
+    const unsigned int firstTask = taskList.GetTaskCount();
+    mBloomView.Activate();
+    for( unsigned int i = firstTask; i + 1u < taskList.GetTaskCount(); ++i )
+    {
+      mBloomTasks.push_back( taskList.GetTask( i ) );
+    }
+    RefreshBloom();
+  }
+
+  void HideBloomView()
+  {
+    mBackground.Remove( mBloomView );
+    mBloomView.Deactivate();
+    mBloomTasks.clear();
+  }
+
+  /**
+   * With refreshOnChange, renders the children, extracts and blurs the bloom once rather than every frame;
+   * only the composition, which applies the animated intensity, keeps running.
+   */
+  void RefreshBloom()
+  {
+    if( QUALITY_TIERS[mQualityTier].refreshOnChange )
+    {
+      for( std::vector< RenderTask >::iterator iter = mBloomTasks.begin(); iter != mBloomTasks.end(); ++iter )
+      {
+        iter->SetRefreshRate( RenderTask::REFRESH_ONCE );
+      }
+    }
+  }
+
+  /**
+   * Recreates the blur and bloom views at another quality tier, showing whichever was shown before.
+   */
+  void SetQualityTier( unsigned int tier )
+  {
+    if( tier == mQualityTier )
+    {
+      return;
+    }
+
+    if( mAnimation )
+    {
+      mAnimation.Clear();
+    }
+
+    const bool showingBloom = mBloomView.OnStage();
+    if( showingBloom )
+    {
+      HideBloomView();
+    }
+    else
+    {
+      mBackground.Remove( mSuperBlurView );
+    }
+
+    mQualityTier = tier;
+    CreateBlurViews();
+
+    if( showingBloom )
+    {
+      // The new blur view has no image to finish blurring until it is shown
+      mIsBlurring = false;
+      ShowBloomView();
+    }
+    else
+    {
+      ShowSuperBlurView();
+    }
+  }
+
+  bool OnQualityTimer()
+  {
+    const DemoHelper::FrameTimeMonitor::Statistics statistics = mFrameTimeMonitor.TakeStatistics();
+    if( mQualityGovernor.Update( statistics ) )
+    {
+      printf( "%u frames, mean %.2f ms, %u slow: quality %s\n",
+              statistics.frames, statistics.mean, statistics.slowFrames, QUALITY_TIERS[mQualityGovernor.GetLevel()].name );
+      SetQualityTier( mQualityGovernor.GetLevel() );
+    }
+    return true;
+  }
+
+  /**
+   * Shows the view, at the tier, of the current benchmark phase and animates its effect back and forth.
+   */
+  void StartBenchmarkPhase()
+  {
+    const bool bloom = ( mBenchmarkPhase % 2u ) == 1u;
+    const unsigned int tier = mBenchmarkPhase / 2u;
+    if( bloom )
+    {
+      mBackground.Remove( mSuperBlurView );
+      ShowBloomView();
+      SetTitle( TITLE_BLOOM );
+    }
+    else
+    {
+      if( mBloomView.OnStage() )
+      {
+        HideBloomView();
+        mBackground.Add( mSuperBlurView );
+        SetTitle( TITLE_SUPER_BLUR );
+      }
+
+      // Either way the image is blurred again, so that the phase includes the cost of blurring it
+      if( tier != mQualityTier )
+      {
+        SetQualityTier( tier );
+      }
+      else
+      {
+        mSuperBlurView.SetImage( mCurrentImage );
+        mIsBlurring = true;
+      }
+    }
+
+    KeyFrames keyFrames = KeyFrames::New();
+    keyFrames.Add( 0.0f, 0.0f );
+    keyFrames.Add( 0.5f, bloom ? 3.0f : 1.0f );
+    keyFrames.Add( 1.0f, 0.0f );
+
+    if( mAnimation )
+    {
+      mAnimation.Clear();
+    }
+    mAnimation = Animation::New( 2.f );
+    if( bloom )
+    {
+      mAnimation.AnimateBetween( Property( mBloomView, mBloomView.GetBloomIntensityPropertyIndex() ), keyFrames );
+    }
+    else
+    {
+      mAnimation.AnimateBetween( Property( mSuperBlurView, mSuperBlurView.GetBlurStrengthPropertyIndex() ), keyFrames );
+    }
+    mAnimation.SetLooping( true );
+    mAnimation.Play();
+
+    // Discard the frames of the previous phase
+    mFrameTimeMonitor.TakeStatistics();
+  }
+
+  bool OnBenchmarkTimer()
+  {
+    const DemoHelper::FrameTimeMonitor::Statistics statistics = mFrameTimeMonitor.TakeStatistics();
+    const QualityTier& tier = QUALITY_TIERS[mQualityTier];
+    const bool bloom = mBloomView.OnStage();
+    const Vector2 stageSize = Stage::GetCurrent().GetSize();
+    const unsigned int memory = bloom ? GetBloomTargetMemory( stageSize, tier ) : GetSuperBlurTargetMemory( stageSize, tier );
+    printf( "%-6s %-10s %6.2f MB of render targets: %u frames, mean %.2f ms, max %.2f ms, %u slow\n",
+            tier.name, bloom ? TITLE_BLOOM : TITLE_SUPER_BLUR, memory / ( 1024.0f * 1024.0f ),
+            statistics.frames, statistics.mean, statistics.max, statistics.slowFrames );
+
+    if( ++mBenchmarkPhase == NUM_QUALITY_TIERS * 2u )
+    {
+      mApp.Quit();
+      return false;
+    }
+
+    StartBenchmarkPhase();
+    return true;
+  }
+
   // Callback function of the touch signal on the background
   bool OnTouch(Dali::Actor actor, const Dali::TouchData& event)
   {
@@ -203,7 +491,8 @@ private:
     }
 
     mImageIndex = (mImageIndex+1u)%NUM_BACKGROUND_IMAGES;
-    mCurrentImage = DemoHelper::LoadStageFillingImage( BACKGROUND_IMAGES[mImageIndex] );
+    mPendingImage.Reset();
+    mCurrentImage = DemoHelper::CreateImage( mImageLoader->LoadStageFilling( BACKGROUND_IMAGES[mImageIndex], mImageLoadId ) );
 
     if( mSuperBlurView.OnStage() )
     {
@@ -216,6 +505,7 @@ private:
     {
       mBloomView.SetProperty( mBloomView.GetBloomIntensityPropertyIndex(), 0.f );
       mBloomActor.SetImage( mCurrentImage );
+      RefreshBloom();
     }
 
     return true;
@@ -227,23 +517,13 @@ private:
     {
       SetTitle( TITLE_BLOOM );
       mBackground.Remove( mSuperBlurView );
-
-      mBloomActor.SetImage( mCurrentImage );
-      mBloomView.SetProperty( mBloomView.GetBloomIntensityPropertyIndex(), 0.f );
-      mBackground.Add( mBloomView );
-      mBloomView.Activate();
-
+      ShowBloomView();
     }
     else
     {
       SetTitle( TITLE_SUPER_BLUR );
-      mBackground.Remove( mBloomView );
-      mBloomView.Deactivate();
-
-      mBackground.Add( mSuperBlurView );
-      mSuperBlurView.SetBlurStrength( 0.f );
-      mSuperBlurView.SetImage( mCurrentImage );
-      mIsBlurring = true;
+      HideBloomView();
+      ShowSuperBlurView();
     }
 
     return true;
@@ -252,6 +532,45 @@ private:
   void OnBlurFinished( Toolkit::SuperBlurView blurView )
   {
     mIsBlurring = false;
+
+    // The full resolution image arrived while the thumbnail was being blurred
+    if( mPendingImage )
+    {
+      SetFullResolutionImage();
+    }
+  }
+
+  /**
+   * Replaces the thumbnail with the full resolution image once it has been decoded.
+   */
+  void OnImageLoaded( unsigned int loadId, PixelData pixelData )
+  {
+    // Ignore images which have been superseded by another background change
+    if( loadId == mImageLoadId && pixelData )
+    {
+      mPendingImage = DemoHelper::CreateImage( pixelData );
+      if( !mIsBlurring )
+      {
+        SetFullResolutionImage();
+      }
+    }
+  }
+
+  void SetFullResolutionImage()
+  {
+    mCurrentImage = mPendingImage;
+    mPendingImage.Reset();
+
+    if( mSuperBlurView.OnStage() )
+    {
+      mIsBlurring = true;
+      mSuperBlurView.SetImage( mCurrentImage );
+    }
+    else
+    {
+      mBloomActor.SetImage( mCurrentImage );
+      RefreshBloom();
+    }
   }
 
   /**
@@ -273,6 +592,7 @@ private:
 private:
 
   Application&               mApp;
+  DemoHelper::ProgressiveImageLoader* mImageLoader;
   Toolkit::ToolBar           mToolBar;
   Toolkit::TextLabel         mTitleActor;             ///< The Toolbar's Title.
   Toolkit::Control           mBackground;
@@ -281,8 +601,18 @@ private:
   Animation                  mAnimation;
   Toolkit::ImageView         mBloomActor;
   Image                      mCurrentImage;
+  Image                      mPendingImage;           ///< Full resolution image waiting for the blur of the thumbnail to finish.
   unsigned int               mImageIndex;
+  unsigned int               mImageLoadId;
   bool                       mIsBlurring;
+
+  unsigned int               mQualityTier;            ///< The index in QUALITY_TIERS the views were created at
+  DemoHelper::QualityGovernor mQualityGovernor;       ///< Picks the tier with --adaptive-quality
+  DemoHelper::FrameTimeMonitor mFrameTimeMonitor;
+  Timer                      mQualityTimer;
+  Timer                      mBenchmarkTimer;
+  unsigned int               mBenchmarkPhase;         ///< Two per tier, the super blur then the bloom
+  std::vector< RenderTask >  mBloomTasks;             ///< The bloom's render tasks, except its composition
 };
 
 /*****************************************************************************/
@@ -298,6 +628,23 @@ RunTest(Application& app)
 
 int DALI_EXPORT_API main(int argc, char **argv)
 {
+  for( int i = 1; i < argc; ++i )
+  {
+    if( strcmp( argv[i], "--quality" ) == 0 && i + 1 < argc )
+    {
+      const int tier = atoi( argv[++i] );
+      QUALITY_TIER = std::min( static_cast< unsigned int >( std::max( tier, 0 ) ), NUM_QUALITY_TIERS - 1u );
+    }
+    else if( strcmp( argv[i], "--adaptive-quality" ) == 0 )
+    {
+      ADAPTIVE_QUALITY = true;
+    }
+    else if( strcmp( argv[i], "--tier-benchmark" ) == 0 )
+    {
+      TIER_BENCHMARK = true;
+    }
+  }
+
   Application app = Application::New(&argc, &argv, DEMO_THEME_PATH);
 
   RunTest(app);
@@ -0,0 +1,805 @@
+#ifndef DALI_DEMO_COMPILED_LAYOUT_H
+#define DALI_DEMO_COMPILED_LAYOUT_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+//------------------------------------------------------------------------------
+//
+// A precompiled, memory mappable form of the Builder JSON layouts.
+//
+// CompileLayout() parses a layout once, substitutes the constants and writes the
+// tree as a flat array of fixed size nodes followed by a string table. Every
+// reference is an offset, so a CompiledLayout can use the file in place after
+// mmap() and BuildCompiledLayout() creates the actors straight from it through
+// the type registry, with no text parsing at startup.
+//
+// Only the stage section is supported. Layouts which need the Builder at run
+// time (templates, styles, animations, signals...) are refused by the compiler
+// and have to be loaded from JSON.
+//
+//------------------------------------------------------------------------------
+
+// EXTERNAL INCLUDES
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <dali/dali.h>
+#include <dali/integration-api/debug.h>
+#include <dali-toolkit/devel-api/builder/json-parser.h>
+#include <dali-toolkit/devel-api/builder/tree-node.h>
+
+namespace DemoHelper
+{
+
+/**
+ * Constants substituted at compile time, ie "DEMO_IMAGE_DIR" replaces "{DEMO_IMAGE_DIR}" in strings.
+ */
+typedef std::map< std::string, std::string > LayoutConstants;
+
+const char     COMPILED_LAYOUT_MAGIC[4] = { 'D', 'L', 'B', 'L' };
+const uint32_t COMPILED_LAYOUT_VERSION( 1u );
+const uint32_t COMPILED_LAYOUT_NO_NAME( 0xffffffffu );
+const char* const COMPILED_LAYOUT_EXTENSION( ".dlb" );
+
+struct CompiledLayoutHeader
+{
+  char     magic[4];
+  uint32_t version;
+  uint32_t nodeCount;
+  uint32_t stringsSize;
+};
+
+/**
+ * A node of the tree. The children of a node are stored next to each other, starting at firstChild.
+ */
+struct CompiledLayoutNode
+{
+  uint32_t name;        ///< Offset of the name in the string table, COMPILED_LAYOUT_NO_NAME for array elements
+  uint32_t type;        ///< A Dali::Toolkit::TreeNode::NodeType
+  uint32_t childCount;
+  uint32_t firstChild;
+  union
+  {
+    int32_t  integer;
+    float    number;
+    uint32_t string;    ///< Offset in the string table
+    uint32_t boolean;
+  } value;
+};
+
+/**
+ * @brief Read only access to a compiled layout, either mapped from a file or in memory.
+ */
+class CompiledLayout
+{
+public:
+
+  CompiledLayout()
+  : mData( NULL ),
+    mSize( 0u ),
+    mMapped( false )
+  {
+  }
+
+  ~CompiledLayout()
+  {
+    Close();
+  }
+
+  /**
+   * @brief Maps a compiled layout file.
+   * @return false if the file cannot be read or is not a compiled layout of this version
+   */
+  bool Open( const std::string& path )
+  {
+    Close();
+
+    int fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 )
+    {
+      return false;
+    }
+
+    struct stat buf;
+    void* data = MAP_FAILED;
+    if( 0 == fstat( fd, &buf ) && buf.st_size > 0 )
+    {
+      data = mmap( NULL, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    }
+    close( fd );
+
+    if( data == MAP_FAILED )
+    {
+      return false;
+    }
+
+    mData = static_cast< const char* >( data );
+    mSize = buf.st_size;
+    mMapped = true;
+
+    if( !IsValid() )
+    {
+      DALI_LOG_WARNING( "Not a compiled layout '%s'\n", path.c_str() );
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Uses a compiled layout which is already in memory. The data must outlive this object.
+   */
+  bool Attach( const char* data, size_t size )
+  {
+    Close();
+    mData = data;
+    mSize = size;
+    if( !IsValid() )
+    {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close()
+  {
+    if( mMapped )
+    {
+      munmap( const_cast< char* >( mData ), mSize );
+    }
+    mData = NULL;
+    mSize = 0u;
+    mMapped = false;
+  }
+
+  const CompiledLayoutNode* GetRoot() const
+  {
+    return mData ? GetNodes() : NULL;
+  }
+
+  const CompiledLayoutNode& GetChild( const CompiledLayoutNode& node, uint32_t index ) const
+  {
+    return GetNodes()[ node.firstChild + index ];
+  }
+
+  /**
+   * @brief Finds a direct child of an object by name.
+   */
+  const CompiledLayoutNode* Find( const CompiledLayoutNode& node, const char* name ) const
+  {
+    for( uint32_t i = 0u; i < node.childCount; ++i )
+    {
+      const CompiledLayoutNode& child = GetChild( node, i );
+      if( child.name != COMPILED_LAYOUT_NO_NAME && 0 == strcmp( GetString( child.name ), name ) )
+      {
+        return &child;
+      }
+    }
+    return NULL;
+  }
+
+  const char* GetName( const CompiledLayoutNode& node ) const
+  {
+    return node.name == COMPILED_LAYOUT_NO_NAME ? "" : GetString( node.name );
+  }
+
+  const char* GetString( uint32_t offset ) const
+  {
+    return GetStrings() + offset;
+  }
+
+private:
+
+  const CompiledLayoutHeader& GetHeader() const
+  {
+    return *reinterpret_cast< const CompiledLayoutHeader* >( mData );
+  }
+
+  const CompiledLayoutNode* GetNodes() const
+  {
+    return reinterpret_cast< const CompiledLayoutNode* >( mData + sizeof( CompiledLayoutHeader ) );
+  }
+
+  const char* GetStrings() const
+  {
+    return reinterpret_cast< const char* >( GetNodes() + GetHeader().nodeCount );
+  }
+
+  /**
+   * Checks the header and that every offset stays within the data.
+   */
+  bool IsValid() const
+  {
+    if( !mData || mSize < sizeof( CompiledLayoutHeader ) )
+    {
+      return false;
+    }
+
+    const CompiledLayoutHeader& header = GetHeader();
+    if( 0 != memcmp( header.magic, COMPILED_LAYOUT_MAGIC, sizeof( header.magic ) ) ||
+        header.version != COMPILED_LAYOUT_VERSION ||
+        header.nodeCount == 0u ||
+        header.stringsSize == 0u ||
+        mSize != sizeof( CompiledLayoutHeader ) + header.nodeCount * sizeof( CompiledLayoutNode ) + header.stringsSize ||
+        GetStrings()[ header.stringsSize - 1u ] != '\0' )
+    {
+      return false;
+    }
+
+    const CompiledLayoutNode* nodes = GetNodes();
+    for( uint32_t i = 0u; i < header.nodeCount; ++i )
+    {
+      const CompiledLayoutNode& node = nodes[i];
+      if( ( node.name != COMPILED_LAYOUT_NO_NAME && node.name >= header.stringsSize ) ||
+          ( node.childCount && ( node.firstChild <= i || node.firstChild + node.childCount > header.nodeCount ) ) ||
+          ( node.type == Dali::Toolkit::TreeNode::STRING && node.value.string >= header.stringsSize ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+
+  CompiledLayout( const CompiledLayout& );
+  CompiledLayout& operator=( const CompiledLayout& );
+
+  const char* mData;
+  size_t      mSize;
+  bool        mMapped;
+};
+
+namespace CompiledLayoutDetail
+{
+
+// The only top-level sections which can be compiled; any other section, including ones the Builder may add
+// later, is left to the Builder
+const char* const SUPPORTED_SECTIONS[] = { "stage", "constants" };
+
+// Actor keys which need the Builder at run time
+const char* const UNSUPPORTED_ACTOR_KEYS[] = { "signals", "styles", "properties", "animatableProperties", "constraints", "mappings" };
+
+bool IsOneOf( const char* name, const char* const* names, unsigned int count )
+{
+  for( unsigned int i = 0u; i < count; ++i )
+  {
+    if( 0 == strcmp( name, names[i] ) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Replaces every "{NAME}" of the constants in a string.
+ * @return false if a constant reference is left which cannot be resolved
+ */
+bool SubstituteConstants( std::string& value, const LayoutConstants& constants )
+{
+  for( LayoutConstants::const_iterator iter = constants.begin(); iter != constants.end(); ++iter )
+  {
+    const std::string token = "{" + iter->first + "}";
+    for( std::string::size_type pos = value.find( token ); pos != std::string::npos; pos = value.find( token, pos + iter->second.size() ) )
+    {
+      value.replace( pos, token.size(), iter->second );
+    }
+  }
+
+  std::string::size_type open = value.find( '{' );
+  return open == std::string::npos || value.find( '}', open ) == std::string::npos;
+}
+
+/**
+ * Builds the string table, sharing repeated strings such as property names.
+ */
+class StringTable
+{
+public:
+
+  uint32_t Add( const std::string& value )
+  {
+    std::map< std::string, uint32_t >::const_iterator found = mOffsets.find( value );
+    if( found != mOffsets.end() )
+    {
+      return found->second;
+    }
+
+    uint32_t offset = mData.size();
+    mData.insert( mData.end(), value.begin(), value.end() );
+    mData.push_back( '\0' );
+    mOffsets[ value ] = offset;
+    return offset;
+  }
+
+  const std::vector< char >& GetData() const
+  {
+    return mData;
+  }
+
+private:
+
+  std::map< std::string, uint32_t > mOffsets;
+  std::vector< char >                 mData;
+};
+
+bool CheckActor( const Dali::Toolkit::TreeNode& actor )
+{
+  for( Dali::Toolkit::TreeNode::ConstIterator iter = actor.CBegin(); iter != actor.CEnd(); ++iter )
+  {
+    const char* key = (*iter).first;
+    if( !key || IsOneOf( key, UNSUPPORTED_ACTOR_KEYS, sizeof( UNSUPPORTED_ACTOR_KEYS ) / sizeof( UNSUPPORTED_ACTOR_KEYS[0] ) ) )
+    {
+      return false;
+    }
+
+    if( 0 == strcmp( key, "actors" ) )
+    {
+      for( Dali::Toolkit::TreeNode::ConstIterator child = (*iter).second.CBegin(); child != (*iter).second.CEnd(); ++child )
+      {
+        if( !CheckActor( (*child).second ) )
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return actor.GetChild( "type" ) != NULL;
+}
+
+} // CompiledLayoutDetail
+
+/**
+ * @brief Compiles a parsed JSON layout.
+ *
+ * String constants from the layout's own "constants" section are substituted along with the given ones.
+ * @param[in] root The root of the layout
+ * @param[in] constants Additional constants, ie the demo directories
+ * @param[out] output The compiled layout
+ * @return false if the layout has any section other than "stage" and "constants", or uses features which need the Builder at run time
+ */
+bool CompileLayout( const Dali::Toolkit::TreeNode& root, const LayoutConstants& constants, std::vector< char >& output )
+{
+  using namespace CompiledLayoutDetail;
+  using Dali::Toolkit::TreeNode;
+
+  LayoutConstants allConstants( constants );
+  const TreeNode* stage = NULL;
+
+  for( TreeNode::ConstIterator iter = root.CBegin(); iter != root.CEnd(); ++iter )
+  {
+    const char* key = (*iter).first;
+    if( !key || !IsOneOf( key, SUPPORTED_SECTIONS, sizeof( SUPPORTED_SECTIONS ) / sizeof( SUPPORTED_SECTIONS[0] ) ) )
+    {
+      return false;
+    }
+
+    if( 0 == strcmp( key, "stage" ) )
+    {
+      stage = &(*iter).second;
+    }
+    else if( 0 == strcmp( key, "constants" ) )
+    {
+      for( TreeNode::ConstIterator constant = (*iter).second.CBegin(); constant != (*iter).second.CEnd(); ++constant )
+      {
+        if( (*constant).first && (*constant).second.GetType() == TreeNode::STRING )
+        {
+          allConstants[ (*constant).first ] = (*constant).second.GetString();
+        }
+      }
+    }
+  }
+
+  if( !stage || stage->GetType() != TreeNode::ARRAY )
+  {
+    return false;
+  }
+
+  for( TreeNode::ConstIterator iter = stage->CBegin(); iter != stage->CEnd(); ++iter )
+  {
+    if( !CheckActor( (*iter).second ) )
+    {
+      return false;
+    }
+  }
+
+  // Only the stage section is kept, breadth first so that siblings are contiguous
+  std::vector< CompiledLayoutNode > nodes;
+  StringTable strings;
+  std::deque< std::pair< const TreeNode*, uint32_t > > queue;
+
+  CompiledLayoutNode rootNode;
+  memset( &rootNode, 0, sizeof( rootNode ) );
+  rootNode.name = COMPILED_LAYOUT_NO_NAME;
+  rootNode.type = TreeNode::OBJECT;
+  rootNode.childCount = 1u;
+  rootNode.firstChild = 1u;
+  nodes.push_back( rootNode );
+
+  CompiledLayoutNode stageNode;
+  memset( &stageNode, 0, sizeof( stageNode ) );
+  stageNode.name = strings.Add( "stage" );
+  stageNode.type = TreeNode::ARRAY;
+  nodes.push_back( stageNode );
+  queue.push_back( std::make_pair( stage, 1u ) );
+
+  while( !queue.empty() )
+  {
+    const TreeNode& parent = *queue.front().first;
+    const uint32_t parentIndex = queue.front().second;
+    queue.pop_front();
+
+    nodes[ parentIndex ].firstChild = nodes.size();
+    nodes[ parentIndex ].childCount = parent.Size();
+
+    for( TreeNode::ConstIterator iter = parent.CBegin(); iter != parent.CEnd(); ++iter )
+    {
+      const TreeNode& child = (*iter).second;
+
+      CompiledLayoutNode node;
+      memset( &node, 0, sizeof( node ) );
+      node.name = (*iter).first ? strings.Add( (*iter).first ) : COMPILED_LAYOUT_NO_NAME;
+      node.type = child.GetType();
+
+      switch( child.GetType() )
+      {
+        case TreeNode::OBJECT:
+        case TreeNode::ARRAY:
+        {
+          queue.push_back( std::make_pair( &child, static_cast< uint32_t >( nodes.size() ) ) );
+          break;
+        }
+        case TreeNode::STRING:
+        {
+          std::string value( child.GetString() );
+          if( !SubstituteConstants( value, allConstants ) )
+          {
+            DALI_LOG_WARNING( "Unresolved constant in '%s'\n", value.c_str() );
+            return false;
+          }
+          node.value.string = strings.Add( value );
+          break;
+        }
+        case TreeNode::INTEGER:
+        {
+          node.value.integer = child.GetInteger();
+          break;
+        }
+        case TreeNode::FLOAT:
+        {
+          node.value.number = child.GetFloat();
+          break;
+        }
+        case TreeNode::BOOLEAN:
+        {
+          node.value.boolean = child.GetBoolean() ? 1u : 0u;
+          break;
+        }
+        case TreeNode::IS_NULL:
+        default:
+        {
+          break;
+        }
+      }
+
+      nodes.push_back( node );
+    }
+  }
+
+  CompiledLayoutHeader header;
+  memcpy( header.magic, COMPILED_LAYOUT_MAGIC, sizeof( header.magic ) );
+  header.version = COMPILED_LAYOUT_VERSION;
+  header.nodeCount = nodes.size();
+  header.stringsSize = strings.GetData().size();
+
+  output.resize( sizeof( header ) + nodes.size() * sizeof( CompiledLayoutNode ) + strings.GetData().size() );
+  char* data = &output[0];
+  memcpy( data, &header, sizeof( header ) );
+  data += sizeof( header );
+  memcpy( data, &nodes[0], nodes.size() * sizeof( CompiledLayoutNode ) );
+  data += nodes.size() * sizeof( CompiledLayoutNode );
+  memcpy( data, &strings.GetData()[0], strings.GetData().size() );
+
+  return true;
+}
+
+/**
+ * @brief Compiles a JSON layout.
+ * @return false if the layout cannot be parsed or uses features which need the Builder at run time
+ */
+bool CompileLayout( const std::string& json, const LayoutConstants& constants, std::vector< char >& output )
+{
+  Dali::Toolkit::JsonParser parser = Dali::Toolkit::JsonParser::New();
+  parser.Parse( json );
+  return !parser.ParseError() && parser.GetRoot() && CompileLayout( *parser.GetRoot(), constants, output );
+}
+
+/**
+ * @brief Compiles a JSON layout file to a compiled layout file.
+ */
+bool CompileLayoutFile( const std::string& jsonPath, const std::string& outputPath, const LayoutConstants& constants )
+{
+  std::ifstream input( jsonPath.c_str() );
+  std::string json( ( std::istreambuf_iterator< char >( input ) ), std::istreambuf_iterator< char >() );
+
+  std::vector< char > compiled;
+  if( json.empty() || !CompileLayout( json, constants, compiled ) )
+  {
+    return false;
+  }
+
+  std::ofstream output( outputPath.c_str(), std::ios::binary );
+  output.write( &compiled[0], compiled.size() );
+  return output.good();
+}
+
+/**
+ * @brief Retrieves the path of the compiled layout for a JSON layout, ie "clock.json" -> "clock.dlb".
+ */
+std::string GetCompiledLayoutPath( const std::string& jsonPath )
+{
+  std::string::size_type dot = jsonPath.rfind( '.' );
+  std::string::size_type slash = jsonPath.rfind( '/' );
+  if( dot == std::string::npos || ( slash != std::string::npos && dot < slash ) )
+  {
+    return jsonPath + COMPILED_LAYOUT_EXTENSION;
+  }
+  return jsonPath.substr( 0, dot ) + COMPILED_LAYOUT_EXTENSION;
+}
+
+/**
+ * @brief Whether a compiled layout exists for a JSON layout and is not older than it.
+ */
+bool HasUpToDateCompiledLayout( const std::string& jsonPath )
+{
+  struct stat json, compiled;
+  return 0 == stat( GetCompiledLayoutPath( jsonPath ).c_str(), &compiled ) &&
+         ( 0 != stat( jsonPath.c_str(), &json ) || compiled.st_mtime >= json.st_mtime );
+}
+
+namespace CompiledLayoutDetail
+{
+
+Dali::Property::Value GetValue( const CompiledLayout& layout, const CompiledLayoutNode& node, Dali::Property::Type type );
+
+/**
+ * Converts an array, using the property type where known and otherwise guessing vectors from arrays of 2 to 4 numbers, as the Builder does.
+ */
+Dali::Property::Value GetArrayValue( const CompiledLayout& layout, const CompiledLayoutNode& node, Dali::Property::Type type )
+{
+  using Dali::Toolkit::TreeNode;
+
+  float numbers[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+  bool allNumbers = node.childCount >= 2u && node.childCount <= 4u;
+  for( uint32_t i = 0u; allNumbers && i < node.childCount; ++i )
+  {
+    const CompiledLayoutNode& child = layout.GetChild( node, i );
+    if( child.type == TreeNode::FLOAT )
+    {
+      numbers[i] = child.value.number;
+    }
+    else if( child.type == TreeNode::INTEGER )
+    {
+      numbers[i] = child.value.integer;
+    }
+    else
+    {
+      allNumbers = false;
+    }
+  }
+
+  if( allNumbers )
+  {
+    if( type == Dali::Property::ROTATION && node.childCount == 3u )
+    {
+      return Dali::Property::Value( Dali::Quaternion( Dali::Radian( Dali::Degree( numbers[0] ) ),
+                                                      Dali::Radian( Dali::Degree( numbers[1] ) ),
+                                                      Dali::Radian( Dali::Degree( numbers[2] ) ) ) );
+    }
+    if( type == Dali::Property::RECTANGLE && node.childCount == 4u )
+    {
+      return Dali::Property::Value( Dali::Rect< int >( numbers[0], numbers[1], numbers[2], numbers[3] ) );
+    }
+    if( type == Dali::Property::VECTOR4 || ( type == Dali::Property::NONE && node.childCount == 4u ) )
+    {
+      return Dali::Property::Value( Dali::Vector4( numbers[0], numbers[1], numbers[2], numbers[3] ) );
+    }
+    if( type == Dali::Property::VECTOR3 || ( type == Dali::Property::NONE && node.childCount == 3u ) )
+    {
+      return Dali::Property::Value( Dali::Vector3( numbers[0], numbers[1], numbers[2] ) );
+    }
+    if( type == Dali::Property::VECTOR2 || ( type == Dali::Property::NONE && node.childCount == 2u ) )
+    {
+      return Dali::Property::Value( Dali::Vector2( numbers[0], numbers[1] ) );
+    }
+  }
+
+  Dali::Property::Array array;
+  for( uint32_t i = 0u; i < node.childCount; ++i )
+  {
+    array.PushBack( GetValue( layout, layout.GetChild( node, i ), Dali::Property::NONE ) );
+  }
+  return Dali::Property::Value( array );
+}
+
+Dali::Property::Value GetValue( const CompiledLayout& layout, const CompiledLayoutNode& node, Dali::Property::Type type )
+{
+  using Dali::Toolkit::TreeNode;
+
+  switch( node.type )
+  {
+    case TreeNode::OBJECT:
+    {
+      Dali::Property::Map map;
+      for( uint32_t i = 0u; i < node.childCount; ++i )
+      {
+        const CompiledLayoutNode& child = layout.GetChild( node, i );
+        map[ layout.GetName( child ) ] = GetValue( layout, child, Dali::Property::NONE );
+      }
+      return Dali::Property::Value( map );
+    }
+    case TreeNode::ARRAY:
+    {
+      return GetArrayValue( layout, node, type );
+    }
+    case TreeNode::STRING:
+    {
+      // Strings are also used for enumerations and named constants such as "CENTER"
+      return Dali::Property::Value( std::string( layout.GetString( node.value.string ) ) );
+    }
+    case TreeNode::INTEGER:
+    {
+      if( type == Dali::Property::FLOAT )
+      {
+        return Dali::Property::Value( static_cast< float >( node.value.integer ) );
+      }
+      return Dali::Property::Value( node.value.integer );
+    }
+    case TreeNode::FLOAT:
+    {
+      if( type == Dali::Property::INTEGER )
+      {
+        return Dali::Property::Value( static_cast< int >( node.value.number ) );
+      }
+      return Dali::Property::Value( node.value.number );
+    }
+    case TreeNode::BOOLEAN:
+    {
+      return Dali::Property::Value( node.value.boolean != 0u );
+    }
+    case TreeNode::IS_NULL:
+    default:
+    {
+      return Dali::Property::Value();
+    }
+  }
+}
+
+Dali::Actor CreateActor( const CompiledLayout& layout, const CompiledLayoutNode& node )
+{
+  const CompiledLayoutNode* typeNode = layout.Find( node, "type" );
+  if( !typeNode || typeNode->type != Dali::Toolkit::TreeNode::STRING )
+  {
+    return Dali::Actor();
+  }
+
+  const char* typeName = layout.GetString( typeNode->value.string );
+  Dali::TypeInfo typeInfo = Dali::TypeRegistry::Get().GetTypeInfo( typeName );
+  Dali::Actor actor = typeInfo ? Dali::Actor::DownCast( typeInfo.CreateInstance() ) : Dali::Actor();
+  if( !actor )
+  {
+    DALI_LOG_WARNING( "Cannot create actor of type '%s'\n", typeName );
+    return actor;
+  }
+
+  for( uint32_t i = 0u; i < node.childCount; ++i )
+  {
+    const CompiledLayoutNode& child = layout.GetChild( node, i );
+    const char* key = layout.GetName( child );
+
+    if( 0 == strcmp( key, "type" ) )
+    {
+      continue;
+    }
+
+    if( 0 == strcmp( key, "actors" ) )
+    {
+      for( uint32_t j = 0u; j < child.childCount; ++j )
+      {
+        Dali::Actor childActor = CreateActor( layout, layout.GetChild( child, j ) );
+        if( childActor )
+        {
+          actor.Add( childActor );
+        }
+      }
+      continue;
+    }
+
+    Dali::Property::Index index = actor.GetPropertyIndex( key );
+    if( index == Dali::Property::INVALID_INDEX )
+    {
+      DALI_LOG_WARNING( "Unknown property '%s' of '%s'\n", key, typeName );
+      continue;
+    }
+
+    actor.SetProperty( index, GetValue( layout, child, actor.GetPropertyType( index ) ) );
+  }
+
+  return actor;
+}
+
+} // CompiledLayoutDetail
+
+/**
+ * @brief Creates the actors of a compiled layout's stage section and adds them to a parent.
+ * @return false if the layout has no stage section
+ */
+bool BuildCompiledLayout( const CompiledLayout& layout, Dali::Actor parent )
+{
+  const CompiledLayoutNode* root = layout.GetRoot();
+  const CompiledLayoutNode* stage = root ? layout.Find( *root, "stage" ) : NULL;
+  if( !stage )
+  {
+    return false;
+  }
+
+  for( uint32_t i = 0u; i < stage->childCount; ++i )
+  {
+    Dali::Actor actor = CompiledLayoutDetail::CreateActor( layout, layout.GetChild( *stage, i ) );
+    if( actor )
+    {
+      parent.Add( actor );
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Creates the actors of a compiled layout file.
+ */
+bool BuildCompiledLayoutFile( const std::string& path, Dali::Actor parent )
+{
+  CompiledLayout layout;
+  return layout.Open( path ) && BuildCompiledLayout( layout, parent );
+}
+
+/**
+ * @brief Retrieves the constants the demo layouts use, as added to the Builder by the demos.
+ */
+LayoutConstants GetDemoLayoutConstants()
+{
+  LayoutConstants constants;
+  constants[ "DEMO_IMAGE_DIR" ]  = DEMO_IMAGE_DIR;
+  constants[ "DEMO_MODEL_DIR" ]  = DEMO_MODEL_DIR;
+  constants[ "DEMO_SCRIPT_DIR" ] = DEMO_SCRIPT_DIR;
+  return constants;
+}
+
+} // DemoHelper
+
+#endif // DALI_DEMO_COMPILED_LAYOUT_H
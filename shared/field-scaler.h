@@ -0,0 +1,161 @@
+#ifndef DALI_DEMO_FIELD_SCALER_H
+#define DALI_DEMO_FIELD_SCALER_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <cstdio>
+#include <algorithm>
+#include <dali/dali.h>
+
+// INTERNAL INCLUDES
+#include "shared/frame-time-monitor.h"
+#include "shared/quality-governor.h"
+
+namespace DemoHelper
+{
+
+// The resolutions, as fractions of the screen's, an adaptive field steps through
+const float FIELD_SCALES[] = { 1.0f, 0.75f, 0.5f, 0.35f, 0.25f };
+const unsigned int NUM_FIELD_SCALES( sizeof( FIELD_SCALES ) / sizeof( FIELD_SCALES[0] ) );
+const float MIN_FIELD_SCALE( 0.1f );
+const unsigned int FIELD_SCALER_INTERVAL( 1000u );   ///< How often, in milliseconds, the field scale is adapted and reported
+
+/**
+ * @brief Returns the index of the largest of FIELD_SCALES which is not above scale.
+ */
+inline unsigned int GetFieldScaleLevel( float scale )
+{
+  unsigned int level = 0u;
+  while( level + 1u < NUM_FIELD_SCALES && FIELD_SCALES[level] > scale )
+  {
+    ++level;
+  }
+  return level;
+}
+
+/**
+ * @brief Picks the resolution an offscreen field of full screen quads is rendered at, as a fraction of the
+ * screen's, and reports the fill it costs.
+ *
+ * A fixed scale is used as it is. An adaptive scale starts at the nearest of FIELD_SCALES and steps through
+ * them as a QualityGovernor decides from the frame times, emitting ScaleChangedSignal() for the owner to
+ * recreate its frame buffer.
+ */
+class FieldScaler : public Dali::ConnectionTracker
+{
+public:
+
+  typedef Dali::Signal< void ( float ) > ScaleChangedSignalType;
+
+  /**
+   * @param[in] scale The fixed scale, or the one an adaptive scale starts nearest to
+   * @param[in] adaptive Whether the scale follows the measured frame times
+   */
+  FieldScaler( float scale, bool adaptive )
+  : mGovernor( NUM_FIELD_SCALES, GetFieldScaleLevel( scale ) ),
+    mScale( adaptive ? FIELD_SCALES[ mGovernor.GetLevel() ] : scale ),
+    mAdaptive( adaptive ),
+    mFieldWidth( 0u ),
+    mFieldHeight( 0u ),
+    mQuadCount( 0u )
+  {
+  }
+
+  /**
+   * @brief Emitted with the new scale when an adaptive scale changes.
+   */
+  ScaleChangedSignalType& ScaleChangedSignal()
+  {
+    return mScaleChangedSignal;
+  }
+
+  float GetScale() const
+  {
+    return mScale;
+  }
+
+  /**
+   * @brief Starts measuring and reporting, if the field is scaled at all.
+   * @param[in] parent The actor the frame time monitor is added to
+   * @param[in] screenSize The size of the field at full resolution
+   */
+  void Start( Dali::Actor parent, const Dali::Vector2& screenSize )
+  {
+    mScreenSize = screenSize;
+    if( mScale < 1.0f || mAdaptive )
+    {
+      mFrameTimeMonitor.Start( parent );
+      mTimer = Dali::Timer::New( FIELD_SCALER_INTERVAL );
+      mTimer.TickSignal().Connect( this, &FieldScaler::OnTimer );
+      mTimer.Start();
+    }
+  }
+
+  /**
+   * @brief Sets what the field renders, for the report.
+   * @param[in] width The width of the frame buffer the field is rendered to
+   * @param[in] height Its height
+   * @param[in] quadCount The number of quads covering the whole frame buffer drawn per frame
+   */
+  void SetField( unsigned int width, unsigned int height, unsigned int quadCount )
+  {
+    mFieldWidth = width;
+    mFieldHeight = height;
+    mQuadCount = quadCount;
+  }
+
+private:
+
+  bool OnTimer()
+  {
+    const FrameTimeMonitor::Statistics statistics = mFrameTimeMonitor.TakeStatistics();
+
+    const float fieldPixels = static_cast< float >( mFieldWidth ) * mFieldHeight;
+    const float screenPixels = mScreenSize.x * mScreenSize.y;
+    printf( "Field %ux%u (scale %.2f%s): %.2f Mpixels of fill per frame, %.0f%% less than at full resolution; "
+            "%u frames, mean %.2f ms, max %.2f ms, %u slow\n",
+            mFieldWidth, mFieldHeight, mScale, mScale < 1.0f ? ", no depth" : "",
+            mQuadCount * fieldPixels / 1000000.0f, ( 1.0f - fieldPixels / screenPixels ) * 100.0f,
+            statistics.frames, statistics.mean, statistics.max, statistics.slowFrames );
+
+    if( mAdaptive && mGovernor.Update( statistics ) )
+    {
+      mScale = FIELD_SCALES[ mGovernor.GetLevel() ];
+      mScaleChangedSignal.Emit( mScale );
+    }
+    return true;
+  }
+
+private:
+
+  ScaleChangedSignalType mScaleChangedSignal;
+  QualityGovernor        mGovernor;
+  FrameTimeMonitor       mFrameTimeMonitor;
+  Dali::Timer            mTimer;
+  Dali::Vector2          mScreenSize;
+  float                  mScale;
+  bool                   mAdaptive;
+  unsigned int           mFieldWidth;
+  unsigned int           mFieldHeight;
+  unsigned int           mQuadCount;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_FIELD_SCALER_H
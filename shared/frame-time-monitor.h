@@ -0,0 +1,184 @@
+#ifndef DALI_DEMO_FRAME_TIME_MONITOR_H
+#define DALI_DEMO_FRAME_TIME_MONITOR_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <algorithm>
+#include <vector>
+#include <dali/dali.h>
+#include <dali/devel-api/threading/mutex.h>
+
+// INTERNAL INCLUDES
+#include "shared/utility.h"
+
+namespace DemoHelper
+{
+
+const float FRAME_TIME_IDLE_INTERVAL = 500.0f;                ///< Intervals longer than this, in milliseconds, are idle time
+const float FRAME_TIME_SLOW_FRAME = 1000.0f / 60.0f * 1.5f;   ///< Frames longer than this, in milliseconds, are counted as slow
+
+/**
+ * @brief Records the time between the frames the update thread produces.
+ *
+ * A constraint on a hidden actor is evaluated once per frame and timestamps each evaluation.
+ * When nothing changes, DALi stops producing frames; gaps longer than FRAME_TIME_IDLE_INTERVAL are treated
+ * as idle time rather than as slow frames.
+ */
+class FrameTimeMonitor
+{
+public:
+
+  /**
+   * @brief The frame intervals recorded since the last call to TakeStatistics().
+   */
+  struct Statistics
+  {
+    Statistics()
+    : frames( 0u ),
+      slowFrames( 0u ),
+      mean( 0.0f ),
+      max( 0.0f )
+    {
+    }
+
+    unsigned int frames;        ///< The number of frame intervals
+    unsigned int slowFrames;    ///< The number of intervals longer than FRAME_TIME_SLOW_FRAME
+    float mean;                 ///< The mean interval in milliseconds
+    float max;                  ///< The longest interval in milliseconds
+  };
+
+  FrameTimeMonitor()
+  : mRecorder( new Recorder )
+  {
+  }
+
+  ~FrameTimeMonitor()
+  {
+    Stop();
+  }
+
+  /**
+   * @brief Starts recording, with a hidden actor added to parent.
+   */
+  void Start( Dali::Actor parent )
+  {
+    Stop();
+
+    mActor = Dali::Actor::New();
+    mActor.SetName( "FrameTimeMonitor" );
+    Dali::Property::Index index = mActor.RegisterProperty( "frameCount", 0.0f );
+    parent.Add( mActor );
+
+    Dali::Constraint constraint = Dali::Constraint::New< float >( mActor, index, RecordFrame( mRecorder ) );
+    constraint.Apply();
+  }
+
+  /**
+   * @brief Stops recording.
+   */
+  void Stop()
+  {
+    if( mActor )
+    {
+      mActor.RemoveConstraints();
+      mActor.Unparent();
+      mActor.Reset();
+    }
+  }
+
+  /**
+   * @brief Retrieves the statistics of the frames recorded since the last call, and clears them.
+   */
+  Statistics TakeStatistics()
+  {
+    std::vector< float > intervals;
+    {
+      Dali::Mutex::ScopedLock lock( mRecorder->mMutex );
+      intervals.swap( mRecorder->mIntervals );
+    }
+
+    Statistics statistics;
+    float total = 0.0f;
+    for( std::vector< float >::const_iterator iter = intervals.begin(); iter != intervals.end(); ++iter )
+    {
+      total += *iter;
+      statistics.max = std::max( statistics.max, *iter );
+      statistics.slowFrames += ( *iter > FRAME_TIME_SLOW_FRAME ) ? 1u : 0u;
+    }
+    statistics.frames = intervals.size();
+    statistics.mean = intervals.empty() ? 0.0f : total / intervals.size();
+    return statistics;
+  }
+
+private:
+
+  /**
+   * The intervals, written on the update thread and taken on the event thread.
+   */
+  struct Recorder : public Dali::RefObject
+  {
+    Recorder()
+    : mLastFrame( 0.0 )
+    {
+    }
+
+    Dali::Mutex          mMutex;
+    std::vector< float > mIntervals;
+    double               mLastFrame;  ///< Only used on the update thread
+  };
+
+  typedef Dali::IntrusivePtr< Recorder > RecorderPtr;
+
+  /**
+   * Timestamps each frame on the update thread.
+   */
+  struct RecordFrame
+  {
+    RecordFrame( RecorderPtr recorder )
+    : mRecorder( recorder )
+    {
+    }
+
+    void operator()( float& current, const Dali::PropertyInputContainer& /* inputs */ )
+    {
+      const double time = GetMilliseconds();
+
+      const float interval = time - mRecorder->mLastFrame;
+      if( mRecorder->mLastFrame > 0.0 && interval < FRAME_TIME_IDLE_INTERVAL )
+      {
+        Dali::Mutex::ScopedLock lock( mRecorder->mMutex );
+        mRecorder->mIntervals.push_back( interval );
+      }
+      mRecorder->mLastFrame = time;
+
+      current += 1.0f;
+    }
+
+    RecorderPtr mRecorder;
+  };
+
+private:
+
+  RecorderPtr mRecorder;
+  Dali::Actor mActor;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_FRAME_TIME_MONITOR_H
@@ -0,0 +1,438 @@
+#ifndef DALI_DEMO_MESH_KERNELS_H
+#define DALI_DEMO_MESH_KERNELS_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <dali/dali.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define DEMO_MESH_KERNELS_SSE
+#elif defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#include <arm_neon.h>
+#define DEMO_MESH_KERNELS_NEON
+#endif
+
+namespace DemoHelper
+{
+
+/**
+ * @brief Three dimensional vectors stored as one array per coordinate, so that the
+ * mesh kernels below can process four vectors at a time.
+ */
+struct Vector3Streams
+{
+  void Resize( size_t size )
+  {
+    x.resize( size );
+    y.resize( size );
+    z.resize( size );
+  }
+
+  size_t Size() const
+  {
+    return x.size();
+  }
+
+  void PushBack( float px, float py, float pz )
+  {
+    x.push_back( px );
+    y.push_back( py );
+    z.push_back( pz );
+  }
+
+  Dali::Vector3 operator[]( size_t index ) const
+  {
+    return Dali::Vector3( x[index], y[index], z[index] );
+  }
+
+  std::vector< float > x;
+  std::vector< float > y;
+  std::vector< float > z;
+};
+
+/**
+ * @brief Two dimensional vectors stored as one array per coordinate.
+ */
+struct Vector2Streams
+{
+  void Resize( size_t size )
+  {
+    x.resize( size );
+    y.resize( size );
+  }
+
+  size_t Size() const
+  {
+    return x.size();
+  }
+
+  Dali::Vector2 operator[]( size_t index ) const
+  {
+    return Dali::Vector2( x[index], y[index] );
+  }
+
+  std::vector< float > x;
+  std::vector< float > y;
+};
+
+namespace MeshKernelsDetail
+{
+
+/**
+ * 1 / sqrt( lengthSquared ), or zero for a zero length vector so that it stays zero when normalized.
+ */
+inline float ReciprocalLengthOrZero( float lengthSquared )
+{
+  return lengthSquared > 0.0f ? 1.0f / sqrtf( lengthSquared ) : 0.0f;
+}
+
+/*
+ * The scalar kernels process [begin, end). They are used where there is no SIMD, and for the
+ * elements left over after the SIMD loops.
+ */
+
+inline void CalculateBoundsScalar( const float* x, const float* y, const float* z, size_t begin, size_t end, float* min, float* max )
+{
+  for( size_t i = begin; i < end; ++i )
+  {
+    min[0] = std::min( min[0], x[i] );
+    min[1] = std::min( min[1], y[i] );
+    min[2] = std::min( min[2], z[i] );
+    max[0] = std::max( max[0], x[i] );
+    max[1] = std::max( max[1], y[i] );
+    max[2] = std::max( max[2], z[i] );
+  }
+}
+
+inline void TransformScalar( float* x, float* y, float* z, size_t begin, size_t end, const Dali::Vector3& offset, const Dali::Vector3& scale )
+{
+  for( size_t i = begin; i < end; ++i )
+  {
+    x[i] = ( x[i] + offset.x ) * scale.x;
+    y[i] = ( y[i] + offset.y ) * scale.y;
+    z[i] = ( z[i] + offset.z ) * scale.z;
+  }
+}
+
+inline void NormalizeScalar( float* x, float* y, float* z, size_t begin, size_t end )
+{
+  for( size_t i = begin; i < end; ++i )
+  {
+    const float reciprocalLength = ReciprocalLengthOrZero( x[i] * x[i] + y[i] * y[i] + z[i] * z[i] );
+    x[i] *= reciprocalLength;
+    y[i] *= reciprocalLength;
+    z[i] *= reciprocalLength;
+  }
+}
+
+inline void FaceNormalsScalar( const float* x, const float* y, const float* z, const unsigned int* faceIndices,
+                               size_t begin, size_t end, float* nx, float* ny, float* nz )
+{
+  for( size_t i = begin; i < end; ++i )
+  {
+    const unsigned int* face = faceIndices + i * 3u;
+    const float e1x = x[ face[2] ] - x[ face[0] ], e1y = y[ face[2] ] - y[ face[0] ], e1z = z[ face[2] ] - z[ face[0] ];
+    const float e2x = x[ face[1] ] - x[ face[0] ], e2y = y[ face[1] ] - y[ face[0] ], e2z = z[ face[1] ] - z[ face[0] ];
+    nx[i] = e1y * e2z - e1z * e2y;
+    ny[i] = e1z * e2x - e1x * e2z;
+    nz[i] = e1x * e2y - e1y * e2x;
+  }
+  NormalizeScalar( nx, ny, nz, begin, end );
+}
+
+inline void PlanarTextureCoordinatesScalar( const float* x, const float* y, size_t begin, size_t end,
+                                            const Dali::Vector2& origin, const Dali::Vector2& reciprocalSize, float* u, float* v )
+{
+  for( size_t i = begin; i < end; ++i )
+  {
+    u[i] = ( x[i] - origin.x ) * reciprocalSize.x;
+    v[i] = ( y[i] - origin.y ) * reciprocalSize.y;
+  }
+}
+
+#if defined( DEMO_MESH_KERNELS_SSE ) || defined( DEMO_MESH_KERNELS_NEON )
+#define DEMO_MESH_KERNELS_SIMD
+
+const size_t SIMD_WIDTH = 4u;
+
+// The few operations the kernels need, so that each kernel is only written once for SSE and NEON
+
+#if defined( DEMO_MESH_KERNELS_SSE )
+
+typedef __m128 Float4;
+
+inline Float4 Load( const float* p )                      { return _mm_loadu_ps( p ); }
+inline void   Store( float* p, Float4 v )                 { _mm_storeu_ps( p, v ); }
+inline Float4 Splat( float f )                            { return _mm_set1_ps( f ); }
+inline Float4 Set( float a, float b, float c, float d )   { return _mm_setr_ps( a, b, c, d ); }
+inline Float4 Add( Float4 a, Float4 b )                   { return _mm_add_ps( a, b ); }
+inline Float4 Sub( Float4 a, Float4 b )                   { return _mm_sub_ps( a, b ); }
+inline Float4 Mul( Float4 a, Float4 b )                   { return _mm_mul_ps( a, b ); }
+inline Float4 Min( Float4 a, Float4 b )                   { return _mm_min_ps( a, b ); }
+inline Float4 Max( Float4 a, Float4 b )                   { return _mm_max_ps( a, b ); }
+
+inline Float4 ReciprocalLengthOrZero( Float4 lengthSquared )
+{
+  const Float4 nonZero = _mm_cmpgt_ps( lengthSquared, _mm_setzero_ps() );
+  return _mm_and_ps( nonZero, _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( lengthSquared ) ) );
+}
+
+#else // DEMO_MESH_KERNELS_NEON
+
+typedef float32x4_t Float4;
+
+inline Float4 Load( const float* p )                      { return vld1q_f32( p ); }
+inline void   Store( float* p, Float4 v )                 { vst1q_f32( p, v ); }
+inline Float4 Splat( float f )                            { return vdupq_n_f32( f ); }
+inline Float4 Add( Float4 a, Float4 b )                   { return vaddq_f32( a, b ); }
+inline Float4 Sub( Float4 a, Float4 b )                   { return vsubq_f32( a, b ); }
+inline Float4 Mul( Float4 a, Float4 b )                   { return vmulq_f32( a, b ); }
+inline Float4 Min( Float4 a, Float4 b )                   { return vminq_f32( a, b ); }
+inline Float4 Max( Float4 a, Float4 b )                   { return vmaxq_f32( a, b ); }
+
+inline Float4 Set( float a, float b, float c, float d )
+{
+  const float values[4] = { a, b, c, d };
+  return vld1q_f32( values );
+}
+
+inline Float4 ReciprocalLengthOrZero( Float4 lengthSquared )
+{
+  const uint32x4_t nonZero = vcgtq_f32( lengthSquared, vdupq_n_f32( 0.0f ) );
+#if defined( __aarch64__ )
+  const Float4 reciprocal = vdivq_f32( vdupq_n_f32( 1.0f ), vsqrtq_f32( lengthSquared ) );
+#else
+  // ARMv7 has no vector division or square root; refine the estimate with two Newton-Raphson steps
+  Float4 reciprocal = vrsqrteq_f32( lengthSquared );
+  reciprocal = vmulq_f32( reciprocal, vrsqrtsq_f32( vmulq_f32( lengthSquared, reciprocal ), reciprocal ) );
+  reciprocal = vmulq_f32( reciprocal, vrsqrtsq_f32( vmulq_f32( lengthSquared, reciprocal ), reciprocal ) );
+#endif
+  return vreinterpretq_f32_u32( vandq_u32( nonZero, vreinterpretq_u32_f32( reciprocal ) ) );
+}
+
+#endif
+
+#endif // DEMO_MESH_KERNELS_SSE || DEMO_MESH_KERNELS_NEON
+
+} // MeshKernelsDetail
+
+/**
+ * @brief Calculates the bounding box of a set of positions.
+ *
+ * The box is inverted, min above max, if there are no positions.
+ */
+inline void CalculateBounds( const Vector3Streams& positions, Dali::Vector3& boundingBoxMin, Dali::Vector3& boundingBoxMax )
+{
+  using namespace MeshKernelsDetail;
+
+  const size_t count = positions.Size();
+  float min[3] = { std::numeric_limits< float >::max(), std::numeric_limits< float >::max(), std::numeric_limits< float >::max() };
+  float max[3] = { -min[0], -min[1], -min[2] };
+  size_t i = 0u;
+
+#if defined( DEMO_MESH_KERNELS_SIMD )
+  if( count >= SIMD_WIDTH )
+  {
+    Float4 minX = Splat( min[0] ), minY = minX, minZ = minX;
+    Float4 maxX = Splat( max[0] ), maxY = maxX, maxZ = maxX;
+    for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH )
+    {
+      const Float4 x = Load( &positions.x[i] ), y = Load( &positions.y[i] ), z = Load( &positions.z[i] );
+      minX = Min( minX, x );
+      minY = Min( minY, y );
+      minZ = Min( minZ, z );
+      maxX = Max( maxX, x );
+      maxY = Max( maxY, y );
+      maxZ = Max( maxZ, z );
+    }
+
+    // Reduce the four lanes with the scalar kernel
+    float lanes[6][SIMD_WIDTH];
+    Store( lanes[0], minX );
+    Store( lanes[1], minY );
+    Store( lanes[2], minZ );
+    Store( lanes[3], maxX );
+    Store( lanes[4], maxY );
+    Store( lanes[5], maxZ );
+    CalculateBoundsScalar( lanes[0], lanes[1], lanes[2], 0u, SIMD_WIDTH, min, max );
+    CalculateBoundsScalar( lanes[3], lanes[4], lanes[5], 0u, SIMD_WIDTH, min, max );
+  }
+#endif
+
+  if( i < count )
+  {
+    CalculateBoundsScalar( &positions.x[0], &positions.y[0], &positions.z[0], i, count, min, max );
+  }
+
+  boundingBoxMin = Dali::Vector3( min[0], min[1], min[2] );
+  boundingBoxMax = Dali::Vector3( max[0], max[1], max[2] );
+}
+
+/**
+ * @brief Translates then scales every position: position = ( position + offset ) * scale.
+ */
+inline void TransformPositions( Vector3Streams& positions, const Dali::Vector3& offset, const Dali::Vector3& scale )
+{
+  using namespace MeshKernelsDetail;
+
+  const size_t count = positions.Size();
+  size_t i = 0u;
+
+#if defined( DEMO_MESH_KERNELS_SIMD )
+  const Float4 offsetX = Splat( offset.x ), offsetY = Splat( offset.y ), offsetZ = Splat( offset.z );
+  const Float4 scaleX = Splat( scale.x ), scaleY = Splat( scale.y ), scaleZ = Splat( scale.z );
+  for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH )
+  {
+    Store( &positions.x[i], Mul( Add( Load( &positions.x[i] ), offsetX ), scaleX ) );
+    Store( &positions.y[i], Mul( Add( Load( &positions.y[i] ), offsetY ), scaleY ) );
+    Store( &positions.z[i], Mul( Add( Load( &positions.z[i] ), offsetZ ), scaleZ ) );
+  }
+#endif
+
+  if( i < count )
+  {
+    TransformScalar( &positions.x[0], &positions.y[0], &positions.z[0], i, count, offset, scale );
+  }
+}
+
+/**
+ * @brief Normalizes every vector. Zero length vectors are left as they are.
+ */
+inline void NormalizeVectors( Vector3Streams& vectors )
+{
+  using namespace MeshKernelsDetail;
+
+  const size_t count = vectors.Size();
+  size_t i = 0u;
+
+#if defined( DEMO_MESH_KERNELS_SIMD )
+  for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH )
+  {
+    const Float4 x = Load( &vectors.x[i] ), y = Load( &vectors.y[i] ), z = Load( &vectors.z[i] );
+    const Float4 reciprocalLength = ReciprocalLengthOrZero( Add( Add( Mul( x, x ), Mul( y, y ) ), Mul( z, z ) ) );
+    Store( &vectors.x[i], Mul( x, reciprocalLength ) );
+    Store( &vectors.y[i], Mul( y, reciprocalLength ) );
+    Store( &vectors.z[i], Mul( z, reciprocalLength ) );
+  }
+#endif
+
+  if( i < count )
+  {
+    NormalizeScalar( &vectors.x[0], &vectors.y[0], &vectors.z[0], i, count );
+  }
+}
+
+/**
+ * @brief Calculates the unit normal of every triangle, ( p2 - p0 ) x ( p1 - p0 ).
+ *
+ * @param[in] positions The vertex positions
+ * @param[in] faceIndices Three indices into positions for each triangle
+ * @param[out] normals One normal per triangle; degenerate triangles have a zero normal
+ */
+inline void CalculateFaceNormals( const Vector3Streams& positions, const std::vector< unsigned int >& faceIndices, Vector3Streams& normals )
+{
+  using namespace MeshKernelsDetail;
+
+  const size_t count = faceIndices.size() / 3u;
+  normals.Resize( count );
+  if( count == 0u )
+  {
+    return;
+  }
+
+  const float* x = &positions.x[0];
+  const float* y = &positions.y[0];
+  const float* z = &positions.z[0];
+  size_t i = 0u;
+
+#if defined( DEMO_MESH_KERNELS_SIMD )
+  for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH )
+  {
+    // Gather the corners of four triangles
+    const unsigned int* f = &faceIndices[i * 3u];
+    const Float4 x0 = Set( x[f[0]], x[f[3]], x[f[6]], x[f[9]] );
+    const Float4 y0 = Set( y[f[0]], y[f[3]], y[f[6]], y[f[9]] );
+    const Float4 z0 = Set( z[f[0]], z[f[3]], z[f[6]], z[f[9]] );
+    const Float4 e1x = Sub( Set( x[f[2]], x[f[5]], x[f[8]], x[f[11]] ), x0 );
+    const Float4 e1y = Sub( Set( y[f[2]], y[f[5]], y[f[8]], y[f[11]] ), y0 );
+    const Float4 e1z = Sub( Set( z[f[2]], z[f[5]], z[f[8]], z[f[11]] ), z0 );
+    const Float4 e2x = Sub( Set( x[f[1]], x[f[4]], x[f[7]], x[f[10]] ), x0 );
+    const Float4 e2y = Sub( Set( y[f[1]], y[f[4]], y[f[7]], y[f[10]] ), y0 );
+    const Float4 e2z = Sub( Set( z[f[1]], z[f[4]], z[f[7]], z[f[10]] ), z0 );
+
+    const Float4 nx = Sub( Mul( e1y, e2z ), Mul( e1z, e2y ) );
+    const Float4 ny = Sub( Mul( e1z, e2x ), Mul( e1x, e2z ) );
+    const Float4 nz = Sub( Mul( e1x, e2y ), Mul( e1y, e2x ) );
+    const Float4 reciprocalLength = ReciprocalLengthOrZero( Add( Add( Mul( nx, nx ), Mul( ny, ny ) ), Mul( nz, nz ) ) );
+    Store( &normals.x[i], Mul( nx, reciprocalLength ) );
+    Store( &normals.y[i], Mul( ny, reciprocalLength ) );
+    Store( &normals.z[i], Mul( nz, reciprocalLength ) );
+  }
+#endif
+
+  if( i < count )
+  {
+    FaceNormalsScalar( x, y, z, &faceIndices[0], i, count, &normals.x[0], &normals.y[0], &normals.z[0] );
+  }
+}
+
+/**
+ * @brief Projects the positions onto the XY plane to generate texture coordinates.
+ *
+ * @param[in] positions The vertex positions
+ * @param[in] origin The position which maps to (0,0)
+ * @param[in] size The extent of the positions which maps to (1,1)
+ * @param[out] textureCoordinates One texture coordinate per position
+ */
+inline void CalculatePlanarTextureCoordinates( const Vector3Streams& positions, const Dali::Vector2& origin, const Dali::Vector2& size,
+                                               Vector2Streams& textureCoordinates )
+{
+  using namespace MeshKernelsDetail;
+
+  const size_t count = positions.Size();
+  textureCoordinates.Resize( count );
+  const Dali::Vector2 reciprocalSize( 1.0f / size.x, 1.0f / size.y );
+  size_t i = 0u;
+
+#if defined( DEMO_MESH_KERNELS_SIMD )
+  const Float4 originX = Splat( origin.x ), originY = Splat( origin.y );
+  const Float4 scaleX = Splat( reciprocalSize.x ), scaleY = Splat( reciprocalSize.y );
+  for( ; i + SIMD_WIDTH <= count; i += SIMD_WIDTH )
+  {
+    Store( &textureCoordinates.x[i], Mul( Sub( Load( &positions.x[i] ), originX ), scaleX ) );
+    Store( &textureCoordinates.y[i], Mul( Sub( Load( &positions.y[i] ), originY ), scaleY ) );
+  }
+#endif
+
+  if( i < count )
+  {
+    PlanarTextureCoordinatesScalar( &positions.x[0], &positions.y[0], i, count, origin, reciprocalSize,
+                                    &textureCoordinates.x[0], &textureCoordinates.y[0] );
+  }
+}
+
+} // DemoHelper
+
+#endif // DALI_DEMO_MESH_KERNELS_H
@@ -0,0 +1,305 @@
+#ifndef DALI_DEMO_MESH_OPTIMIZER_H
+#define DALI_DEMO_MESH_OPTIMIZER_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace DemoHelper
+{
+
+namespace MeshOptimizerDetail
+{
+
+/**
+ * Orders vertex indices by the bytes of the vertices they refer to.
+ */
+template< typename T >
+struct VertexBytesLess
+{
+  VertexBytesLess( const std::vector< T >& vertices )
+  : mVertices( vertices )
+  {
+  }
+
+  bool operator()( unsigned int lhs, unsigned int rhs ) const
+  {
+    int comparison = memcmp( &mVertices[lhs], &mVertices[rhs], sizeof( T ) );
+    return comparison < 0 || ( comparison == 0 && lhs < rhs );
+  }
+
+  const std::vector< T >& mVertices;
+};
+
+const unsigned int CACHE_SIZE = 32u;                ///< The size of the modelled post-transform cache
+const float        CACHE_DECAY_POWER = 1.5f;
+const float        LAST_TRIANGLE_SCORE = 0.75f;     ///< The vertices of the last triangle are in the cache but reusing them straight away gains little
+const float        VALENCE_BOOST_SCALE = 2.0f;
+const float        VALENCE_BOOST_POWER = -0.5f;
+
+/**
+ * The score of a vertex from its position in the modelled cache and the number of triangles still to be emitted which use it.
+ */
+inline float GetVertexScore( int cachePosition, unsigned int remainingTriangles )
+{
+  if( remainingTriangles == 0u )
+  {
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if( cachePosition >= 0 )
+  {
+    if( cachePosition < 3 )
+    {
+      score = LAST_TRIANGLE_SCORE;
+    }
+    else
+    {
+      const float scale = 1.0f / ( CACHE_SIZE - 3 );
+      score = powf( 1.0f - ( cachePosition - 3 ) * scale, CACHE_DECAY_POWER );
+    }
+  }
+
+  // Favour vertices with few triangles left, so that they are finished and drop out of the mesh
+  return score + VALENCE_BOOST_SCALE * powf( static_cast< float >( remainingTriangles ), VALENCE_BOOST_POWER );
+}
+
+} // MeshOptimizerDetail
+
+/**
+ * @brief Merges identical vertices and builds the index buffer which draws the same triangles.
+ *
+ * Vertices are compared byte for byte, so this is only lossless for plain structures without padding.
+ * @param[in] expandedVertices Three vertices per triangle
+ * @param[out] vertices The unique vertices, in order of first use
+ * @param[out] indices Three indices into vertices per triangle, in the order of expandedVertices
+ */
+template< typename T, typename Index >
+void DeduplicateVertices( const std::vector< T >& expandedVertices, std::vector< T >& vertices, std::vector< Index >& indices )
+{
+  const unsigned int count = expandedVertices.size();
+  std::vector< unsigned int > sorted( count );
+  for( unsigned int i = 0u; i < count; ++i )
+  {
+    sorted[i] = i;
+  }
+  std::sort( sorted.begin(), sorted.end(), MeshOptimizerDetail::VertexBytesLess< T >( expandedVertices ) );
+
+  // Map every vertex to the first of its duplicates
+  std::vector< unsigned int > firstDuplicate( count );
+  for( unsigned int i = 0u; i < count; ++i )
+  {
+    const bool duplicate = i > 0u && memcmp( &expandedVertices[ sorted[i] ], &expandedVertices[ sorted[i - 1u] ], sizeof( T ) ) == 0;
+    firstDuplicate[ sorted[i] ] = duplicate ? firstDuplicate[ sorted[i - 1u] ] : sorted[i];
+  }
+
+  const unsigned int NO_INDEX = std::numeric_limits< unsigned int >::max();
+  std::vector< unsigned int > newIndex( count, NO_INDEX );
+  vertices.clear();
+  indices.clear();
+  indices.reserve( count );
+  for( unsigned int i = 0u; i < count; ++i )
+  {
+    unsigned int& index = newIndex[ firstDuplicate[i] ];
+    if( index == NO_INDEX )
+    {
+      index = vertices.size();
+      vertices.push_back( expandedVertices[i] );
+    }
+    indices.push_back( static_cast< Index >( index ) );
+  }
+}
+
+/**
+ * @brief Reorders triangles so that the vertices they share are still in the GPU's post-transform cache.
+ *
+ * This is Tom Forsyth's linear-speed vertex cache optimisation: the triangle emitted next is the one whose
+ * vertices score highest, vertices scoring by their position in a modelled LRU cache and by how few
+ * triangles still use them.
+ * @param[in,out] indices Three indices per triangle
+ * @param[in] vertexCount The number of vertices the indices refer to
+ */
+template< typename Index >
+void OptimizeTriangleOrder( std::vector< Index >& indices, unsigned int vertexCount )
+{
+  using namespace MeshOptimizerDetail;
+
+  const unsigned int triangleCount = indices.size() / 3u;
+  if( triangleCount == 0u )
+  {
+    return;
+  }
+
+  // The triangles of each vertex
+  std::vector< unsigned int > triangleOffsets( vertexCount + 1u, 0u );
+  for( unsigned int i = 0u; i < triangleCount * 3u; ++i )
+  {
+    ++triangleOffsets[ indices[i] + 1u ];
+  }
+  for( unsigned int i = 0u; i < vertexCount; ++i )
+  {
+    triangleOffsets[i + 1u] += triangleOffsets[i];
+  }
+  std::vector< unsigned int > vertexTriangles( triangleCount * 3u );
+  std::vector< unsigned int > remainingTriangles( vertexCount, 0u );
+  for( unsigned int i = 0u; i < triangleCount * 3u; ++i )
+  {
+    const unsigned int vertex = indices[i];
+    vertexTriangles[ triangleOffsets[vertex] + remainingTriangles[vertex]++ ] = i / 3u;
+  }
+
+  std::vector< int > cachePosition( vertexCount, -1 );
+  std::vector< float > vertexScore( vertexCount );
+  for( unsigned int i = 0u; i < vertexCount; ++i )
+  {
+    vertexScore[i] = GetVertexScore( -1, remainingTriangles[i] );
+  }
+
+  std::vector< float > triangleScore( triangleCount );
+  std::vector< bool > emitted( triangleCount, false );
+  for( unsigned int i = 0u; i < triangleCount; ++i )
+  {
+    triangleScore[i] = vertexScore[ indices[i * 3u] ] + vertexScore[ indices[i * 3u + 1u] ] + vertexScore[ indices[i * 3u + 2u] ];
+  }
+
+  std::vector< Index > ordered;
+  ordered.reserve( triangleCount * 3u );
+  std::vector< unsigned int > cache;
+  std::vector< unsigned int > newCache;
+  cache.reserve( CACHE_SIZE + 3u );
+  newCache.reserve( CACHE_SIZE + 3u );
+
+  unsigned int bestTriangle = std::max_element( triangleScore.begin(), triangleScore.end() ) - triangleScore.begin();
+  unsigned int nextUnemitted = 0u;
+
+  for( unsigned int emittedCount = 0u; emittedCount < triangleCount; ++emittedCount )
+  {
+    // Emit the best triangle and move its vertices to the front of the cache
+    const Index* triangle = &indices[ bestTriangle * 3u ];
+    ordered.insert( ordered.end(), triangle, triangle + 3 );
+    emitted[bestTriangle] = true;
+
+    newCache.assign( triangle, triangle + 3 );
+    for( unsigned int i = 0u; i < 3u; ++i )
+    {
+      // Remove the triangle from its vertices' lists of remaining triangles
+      const unsigned int vertex = triangle[i];
+      unsigned int* begin = &vertexTriangles[ triangleOffsets[vertex] ];
+      unsigned int* end = begin + remainingTriangles[vertex];
+      *std::find( begin, end, bestTriangle ) = *( end - 1 );
+      --remainingTriangles[vertex];
+    }
+    for( unsigned int i = 0u; i < cache.size(); ++i )
+    {
+      if( cache[i] != newCache[0] && cache[i] != newCache[1] && cache[i] != newCache[2] )
+      {
+        newCache.push_back( cache[i] );
+      }
+    }
+    cache.swap( newCache );
+
+    // Rescore the vertices in the cache, including those which have just dropped out, and their triangles
+    for( unsigned int i = 0u; i < cache.size(); ++i )
+    {
+      const unsigned int vertex = cache[i];
+      cachePosition[vertex] = i < CACHE_SIZE ? static_cast< int >( i ) : -1;
+      const float score = GetVertexScore( cachePosition[vertex], remainingTriangles[vertex] );
+      const float change = score - vertexScore[vertex];
+      vertexScore[vertex] = score;
+      for( unsigned int j = 0u; j < remainingTriangles[vertex]; ++j )
+      {
+        triangleScore[ vertexTriangles[ triangleOffsets[vertex] + j ] ] += change;
+      }
+    }
+    if( cache.size() > CACHE_SIZE )
+    {
+      cache.resize( CACHE_SIZE );
+    }
+
+    // The next triangle is the best one using a vertex in the cache, which is where scores have changed
+    float bestScore = -1.0f;
+    bestTriangle = triangleCount;
+    for( unsigned int i = 0u; i < cache.size(); ++i )
+    {
+      const unsigned int vertex = cache[i];
+      for( unsigned int j = 0u; j < remainingTriangles[vertex]; ++j )
+      {
+        const unsigned int candidate = vertexTriangles[ triangleOffsets[vertex] + j ];
+        if( triangleScore[candidate] > bestScore )
+        {
+          bestScore = triangleScore[candidate];
+          bestTriangle = candidate;
+        }
+      }
+    }
+
+    // Otherwise start again from any triangle which has not been emitted
+    if( bestTriangle == triangleCount )
+    {
+      while( nextUnemitted < triangleCount && emitted[nextUnemitted] )
+      {
+        ++nextUnemitted;
+      }
+      bestTriangle = nextUnemitted;
+      if( bestTriangle == triangleCount )
+      {
+        break;
+      }
+    }
+  }
+
+  indices.swap( ordered );
+}
+
+/**
+ * @brief Retrieves the average number of vertices transformed per triangle (ACMR) with a FIFO post-transform cache.
+ *
+ * 3 means no vertex is reused, about 0.5 is the best possible for a regular grid.
+ */
+template< typename Index >
+float CalculateAverageCacheMissRatio( const std::vector< Index >& indices, unsigned int vertexCount, unsigned int cacheSize = 16u )
+{
+  if( indices.size() < 3u )
+  {
+    return 0.0f;
+  }
+
+  // A vertex is in the cache if it was loaded within the last cacheSize misses
+  std::vector< unsigned int > loadedAt( vertexCount, 0u );
+  unsigned int misses = 0u;
+  for( unsigned int i = 0u; i < indices.size(); ++i )
+  {
+    const unsigned int vertex = indices[i];
+    if( loadedAt[vertex] == 0u || misses + 1u - loadedAt[vertex] > cacheSize )
+    {
+      ++misses;
+      loadedAt[vertex] = misses;
+    }
+  }
+  return static_cast< float >( misses ) / ( indices.size() / 3u );
+}
+
+} // DemoHelper
+
+#endif // DALI_DEMO_MESH_OPTIMIZER_H
@@ -0,0 +1,334 @@
+#ifndef DALI_DEMO_METABALL_FIELD_H
+#define DALI_DEMO_METABALL_FIELD_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include <dali/dali.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define DEMO_METABALL_FIELD_SSE
+#elif defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#include <arm_neon.h>
+#define DEMO_METABALL_FIELD_NEON
+#endif
+
+namespace DemoHelper
+{
+
+const float METABALL_FIELD_MIN_DISTANCE_SQUARED = 1e-12f;  ///< Avoids dividing by zero at the centre of a ball
+
+/**
+ * @brief A metaball in the coordinates of the metaball shaders, where the field spans [-1,1] horizontally.
+ */
+struct Metaball
+{
+  Metaball()
+  : radius( 0.0f )
+  {
+  }
+
+  Metaball( const Dali::Vector2& position, float radius )
+  : position( position ),
+    radius( radius )
+  {
+  }
+
+  Dali::Vector2 position;   ///< uPositionMetaball + uGravityVector + uPositionVar
+  float radius;             ///< uRadius + uRadiusVar
+};
+
+/**
+ * @brief Evaluates the metaball field on the CPU, as the metaball shaders accumulate it in their frame buffer.
+ *
+ * Each pixel is the sum over the balls of radius / distance, clamped to [0,1] and stored as an 8-bit
+ * luminance. Pixels are square: with a width of w, adjacent pixels are 2/w apart in both directions, and
+ * row 0 is where vTexCoord.y is 0. Four pixels are evaluated at a time with SSE2 or NEON where available,
+ * and the rows are split between threads.
+ */
+class MetaballField
+{
+public:
+
+  /**
+   * @param[in] width The width of the field in pixels
+   * @param[in] height The height of the field in pixels
+   * @param[in] numberOfThreads The number of threads to split the rows between, zero means one per online CPU
+   */
+  MetaballField( unsigned int width, unsigned int height, unsigned int numberOfThreads = 0u )
+  : mWidth( width ),
+    mHeight( height ),
+    mNumberOfThreads( numberOfThreads )
+  {
+    if( mNumberOfThreads == 0u )
+    {
+      long count = sysconf( _SC_NPROCESSORS_ONLN );
+      mNumberOfThreads = count > 0 ? static_cast< unsigned int >( count ) : 1u;
+    }
+    mNumberOfThreads = std::max( 1u, std::min( mNumberOfThreads, mHeight ) );
+  }
+
+  unsigned int GetWidth() const
+  {
+    return mWidth;
+  }
+
+  unsigned int GetHeight() const
+  {
+    return mHeight;
+  }
+
+  /**
+   * @brief Evaluates the field into buffer, which must hold width * height bytes.
+   */
+  void Compute( const std::vector< Metaball >& balls, unsigned char* buffer ) const
+  {
+    std::vector< Band > bands( mNumberOfThreads );
+    std::vector< pthread_t > threads;
+    for( unsigned int i = 0u; i < mNumberOfThreads; ++i )
+    {
+      bands[i].field = this;
+      bands[i].balls = &balls;
+      bands[i].buffer = buffer;
+      bands[i].firstRow = mHeight * i / mNumberOfThreads;
+      bands[i].lastRow = mHeight * ( i + 1u ) / mNumberOfThreads;
+
+      // The first band is computed on the calling thread
+      pthread_t thread;
+      if( i > 0u && pthread_create( &thread, NULL, &MetaballField::RunBand, &bands[i] ) == 0 )
+      {
+        threads.push_back( thread );
+        bands[i].threaded = true;
+      }
+    }
+
+    for( unsigned int i = 0u; i < mNumberOfThreads; ++i )
+    {
+      if( !bands[i].threaded )
+      {
+        ComputeRows( balls, buffer, bands[i].firstRow, bands[i].lastRow );
+      }
+    }
+
+    for( std::vector< pthread_t >::iterator iter = threads.begin(); iter != threads.end(); ++iter )
+    {
+      pthread_join( *iter, NULL );
+    }
+  }
+
+  /**
+   * @brief Evaluates the field one pixel and one ball at a time on the calling thread, as the fragment shader does.
+   *
+   * This is the reference Compute() is validated against.
+   */
+  void ComputeReference( const std::vector< Metaball >& balls, unsigned char* buffer ) const
+  {
+    for( unsigned int row = 0u; row < mHeight; ++row )
+    {
+      for( unsigned int column = 0u; column < mWidth; ++column )
+      {
+        const float x = GetCoordinate( column );
+        const float y = GetCoordinate( row );
+
+        float color = 0.0f;
+        for( std::vector< Metaball >::const_iterator iter = balls.begin(); iter != balls.end(); ++iter )
+        {
+          const float dx = x - iter->position.x;
+          const float dy = y - iter->position.y;
+          color += iter->radius / sqrtf( std::max( dx * dx + dy * dy, METABALL_FIELD_MIN_DISTANCE_SQUARED ) );
+        }
+        buffer[row * mWidth + column] = ToByte( color );
+      }
+    }
+  }
+
+  /**
+   * @brief Evaluates the field into an L8 PixelData, e.g. to create a texture from.
+   */
+  Dali::PixelData CreatePixelData( const std::vector< Metaball >& balls ) const
+  {
+    const unsigned int bufferSize = mWidth * mHeight;
+    unsigned char* buffer = new unsigned char[ bufferSize ];
+    Compute( balls, buffer );
+    return Dali::PixelData::New( buffer, bufferSize, mWidth, mHeight, Dali::Pixel::L8, Dali::PixelData::DELETE_ARRAY );
+  }
+
+private:
+
+  /**
+   * The rows a thread evaluates.
+   */
+  struct Band
+  {
+    Band()
+    : field( NULL ),
+      balls( NULL ),
+      buffer( NULL ),
+      firstRow( 0u ),
+      lastRow( 0u ),
+      threaded( false )
+    {
+    }
+
+    const MetaballField* field;
+    const std::vector< Metaball >* balls;
+    unsigned char* buffer;
+    unsigned int firstRow;
+    unsigned int lastRow;
+    bool threaded;
+  };
+
+  static void* RunBand( void* data )
+  {
+    const Band& band = *static_cast< Band* >( data );
+    band.field->ComputeRows( *band.balls, band.buffer, band.firstRow, band.lastRow );
+    return NULL;
+  }
+
+  float GetCoordinate( unsigned int pixel ) const
+  {
+    return ( pixel + 0.5f ) * 2.0f / mWidth - 1.0f;
+  }
+
+  static unsigned char ToByte( float color )
+  {
+    return static_cast< unsigned char >( std::min( color, 1.0f ) * 255.0f + 0.5f );
+  }
+
+  void ComputeRows( const std::vector< Metaball >& balls, unsigned char* buffer, unsigned int firstRow, unsigned int lastRow ) const
+  {
+    const unsigned int count = balls.size();
+    std::vector< float > ballX( count );
+    std::vector< float > radius( count );
+    std::vector< float > dySquared( count );
+    for( unsigned int i = 0u; i < count; ++i )
+    {
+      ballX[i] = balls[i].position.x;
+      radius[i] = balls[i].radius;
+    }
+
+    if( count == 0u )
+    {
+      std::fill( buffer + firstRow * mWidth, buffer + lastRow * mWidth, 0u );
+      return;
+    }
+
+    const float step = 2.0f / mWidth;
+    const unsigned int vectorWidth = mWidth & ~3u;
+
+    for( unsigned int row = firstRow; row < lastRow; ++row )
+    {
+      const float y = GetCoordinate( row );
+      for( unsigned int i = 0u; i < count; ++i )
+      {
+        const float dy = y - balls[i].position.y;
+        dySquared[i] = dy * dy;
+      }
+
+      unsigned char* pixel = buffer + row * mWidth;
+      unsigned int column = 0u;
+      for( ; column < vectorWidth; column += 4u )
+      {
+        float color[4];
+        ComputeFour( GetCoordinate( column ), step, count, &ballX[0], &dySquared[0], &radius[0], color );
+        for( unsigned int i = 0u; i < 4u; ++i )
+        {
+          pixel[column + i] = ToByte( color[i] );
+        }
+      }
+
+      for( ; column < mWidth; ++column )
+      {
+        const float x = GetCoordinate( column );
+        float color = 0.0f;
+        for( unsigned int i = 0u; i < count; ++i )
+        {
+          const float dx = x - ballX[i];
+          color += radius[i] / sqrtf( std::max( dx * dx + dySquared[i], METABALL_FIELD_MIN_DISTANCE_SQUARED ) );
+        }
+        pixel[column] = ToByte( color );
+      }
+    }
+  }
+
+  /**
+   * Sums the field of all the balls at four horizontally adjacent pixels, the first at x.
+   */
+  static void ComputeFour( float x, float step, unsigned int count, const float* ballX, const float* dySquared, const float* radius, float* color )
+  {
+#if defined( DEMO_METABALL_FIELD_SSE )
+    const __m128 pixelX = _mm_add_ps( _mm_set1_ps( x ), _mm_mul_ps( _mm_set_ps( 3.0f, 2.0f, 1.0f, 0.0f ), _mm_set1_ps( step ) ) );
+    const __m128 minimum = _mm_set1_ps( METABALL_FIELD_MIN_DISTANCE_SQUARED );
+    __m128 sum = _mm_setzero_ps();
+    for( unsigned int i = 0u; i < count; ++i )
+    {
+      const __m128 dx = _mm_sub_ps( pixelX, _mm_set1_ps( ballX[i] ) );
+      const __m128 distanceSquared = _mm_max_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_set1_ps( dySquared[i] ) ), minimum );
+      sum = _mm_add_ps( sum, _mm_div_ps( _mm_set1_ps( radius[i] ), _mm_sqrt_ps( distanceSquared ) ) );
+    }
+    _mm_storeu_ps( color, sum );
+#elif defined( DEMO_METABALL_FIELD_NEON )
+    const float offsets[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t pixelX = vmlaq_n_f32( vdupq_n_f32( x ), vld1q_f32( offsets ), step );
+    const float32x4_t minimum = vdupq_n_f32( METABALL_FIELD_MIN_DISTANCE_SQUARED );
+    float32x4_t sum = vdupq_n_f32( 0.0f );
+    for( unsigned int i = 0u; i < count; ++i )
+    {
+      const float32x4_t dx = vsubq_f32( pixelX, vdupq_n_f32( ballX[i] ) );
+      const float32x4_t distanceSquared = vmaxq_f32( vmlaq_f32( vdupq_n_f32( dySquared[i] ), dx, dx ), minimum );
+#if defined( __aarch64__ )
+      const float32x4_t inverse = vdivq_f32( vdupq_n_f32( 1.0f ), vsqrtq_f32( distanceSquared ) );
+#else
+      // ARMv7 has no vector division or square root; refine the estimate with two Newton-Raphson steps
+      float32x4_t inverse = vrsqrteq_f32( distanceSquared );
+      inverse = vmulq_f32( inverse, vrsqrtsq_f32( vmulq_f32( distanceSquared, inverse ), inverse ) );
+      inverse = vmulq_f32( inverse, vrsqrtsq_f32( vmulq_f32( distanceSquared, inverse ), inverse ) );
+#endif
+      sum = vmlaq_n_f32( sum, inverse, radius[i] );
+    }
+    vst1q_f32( color, sum );
+#else
+    for( unsigned int j = 0u; j < 4u; ++j )
+    {
+      const float pixelX = x + j * step;
+      color[j] = 0.0f;
+      for( unsigned int i = 0u; i < count; ++i )
+      {
+        const float dx = pixelX - ballX[i];
+        color[j] += radius[i] / sqrtf( std::max( dx * dx + dySquared[i], METABALL_FIELD_MIN_DISTANCE_SQUARED ) );
+      }
+    }
+#endif
+  }
+
+private:
+
+  unsigned int mWidth;
+  unsigned int mHeight;
+  unsigned int mNumberOfThreads;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_METABALL_FIELD_H
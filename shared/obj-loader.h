@@ -0,0 +1,458 @@
+#ifndef DALI_DEMO_OBJ_LOADER_H
+#define DALI_DEMO_OBJ_LOADER_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dali/dali.h>
+
+// INTERNAL INCLUDES
+#include "shared/mesh-kernels.h"
+
+namespace DemoHelper
+{
+
+/**
+ * @brief A file mapped into memory, read only.
+ */
+class MappedFile
+{
+public:
+
+  MappedFile()
+  : mData( NULL ),
+    mSize( 0u )
+  {
+  }
+
+  ~MappedFile()
+  {
+    Close();
+  }
+
+  /**
+   * @return false if the file cannot be read or is empty
+   */
+  bool Open( const std::string& path )
+  {
+    Close();
+
+    int fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 )
+    {
+      return false;
+    }
+
+    struct stat buf;
+    void* data = MAP_FAILED;
+    if( 0 == fstat( fd, &buf ) && buf.st_size > 0 )
+    {
+      data = mmap( NULL, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    }
+    close( fd );
+
+    if( data == MAP_FAILED )
+    {
+      return false;
+    }
+
+    // The file is read from start to end once
+    madvise( data, buf.st_size, MADV_SEQUENTIAL );
+
+    mData = static_cast< const char* >( data );
+    mSize = buf.st_size;
+    return true;
+  }
+
+  void Close()
+  {
+    if( mData )
+    {
+      munmap( const_cast< char* >( mData ), mSize );
+    }
+    mData = NULL;
+    mSize = 0u;
+  }
+
+  const char* GetData() const
+  {
+    return mData;
+  }
+
+  size_t GetSize() const
+  {
+    return mSize;
+  }
+
+private:
+
+  MappedFile( const MappedFile& );
+  MappedFile& operator=( const MappedFile& );
+
+  const char* mData;
+  size_t      mSize;
+};
+
+namespace ObjLoaderDetail
+{
+
+inline bool IsBlank( char c )
+{
+  return c == ' ' || c == '\t';
+}
+
+inline bool IsDigit( char c )
+{
+  return c >= '0' && c <= '9';
+}
+
+inline const char* SkipBlanks( const char* p, const char* end )
+{
+  while( p < end && IsBlank( *p ) )
+  {
+    ++p;
+  }
+  return p;
+}
+
+/**
+ * Parses a decimal number such as "-1.497040" or "2.5e-3". The digits are accumulated in a double,
+ * which is exact for the precision OBJ exporters write, and scaled by a power of ten once.
+ * @return The end of the number, or p if there is none
+ */
+inline const char* ParseFloat( const char* p, const char* end, float& value )
+{
+  static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  const int MAX_POWER = sizeof( POWERS_OF_TEN ) / sizeof( POWERS_OF_TEN[0] ) - 1;
+
+  const char* start = p;
+  bool negative = false;
+  if( p < end && ( *p == '-' || *p == '+' ) )
+  {
+    negative = *p == '-';
+    ++p;
+  }
+
+  double mantissa = 0.0;
+  int exponent = 0;
+  bool digits = false;
+  for( ; p < end && IsDigit( *p ); ++p )
+  {
+    mantissa = mantissa * 10.0 + ( *p - '0' );
+    digits = true;
+  }
+  if( p < end && *p == '.' )
+  {
+    for( ++p; p < end && IsDigit( *p ); ++p )
+    {
+      mantissa = mantissa * 10.0 + ( *p - '0' );
+      --exponent;
+      digits = true;
+    }
+  }
+  if( !digits )
+  {
+    return start;
+  }
+
+  if( p < end && ( *p == 'e' || *p == 'E' ) )
+  {
+    const char* exponentStart = p++;
+    bool negativeExponent = false;
+    if( p < end && ( *p == '-' || *p == '+' ) )
+    {
+      negativeExponent = *p == '-';
+      ++p;
+    }
+    if( p < end && IsDigit( *p ) )
+    {
+      int writtenExponent = 0;
+      for( ; p < end && IsDigit( *p ); ++p )
+      {
+        writtenExponent = std::min( writtenExponent * 10 + ( *p - '0' ), 1000 );
+      }
+      exponent += negativeExponent ? -writtenExponent : writtenExponent;
+    }
+    else
+    {
+      p = exponentStart;
+    }
+  }
+
+  // Dividing by an exact power of ten is more accurate than multiplying by its inexact inverse
+  while( exponent < -MAX_POWER )
+  {
+    mantissa /= POWERS_OF_TEN[MAX_POWER];
+    exponent += MAX_POWER;
+  }
+  while( exponent > MAX_POWER )
+  {
+    mantissa *= POWERS_OF_TEN[MAX_POWER];
+    exponent -= MAX_POWER;
+  }
+  mantissa = exponent < 0 ? mantissa / POWERS_OF_TEN[-exponent] : mantissa * POWERS_OF_TEN[exponent];
+
+  value = static_cast< float >( negative ? -mantissa : mantissa );
+  return p;
+}
+
+/**
+ * Parses a decimal integer.
+ * @return The end of the integer, or p if there is none
+ */
+inline const char* ParseInteger( const char* p, const char* end, long& value )
+{
+  const char* start = p;
+  bool negative = false;
+  if( p < end && *p == '-' )
+  {
+    negative = true;
+    ++p;
+  }
+
+  if( p == end || !IsDigit( *p ) )
+  {
+    return start;
+  }
+
+  value = 0;
+  for( ; p < end && IsDigit( *p ); ++p )
+  {
+    value = value * 10 + ( *p - '0' );
+  }
+  if( negative )
+  {
+    value = -value;
+  }
+  return p;
+}
+
+} // ObjLoaderDetail
+
+/**
+ * @brief Parses the vertex positions and triangles of an OBJ file in a single pass over its contents.
+ *
+ * Only "v" and "f" lines are read. Of each face, the position indices of the first three vertices are kept,
+ * whether the vertices are written as "v", "v/t", "v//n" or "v/t/n". Relative (negative) indices are resolved.
+ * No memory is allocated per line.
+ *
+ * @param[in] data The contents of the file
+ * @param[in] size The size of the contents
+ * @param[out] positions The vertex positions, one array per coordinate for the kernels in mesh-kernels.h
+ * @param[out] faceIndices Three indices into positions for each triangle
+ * @return false if a face refers to a vertex which does not exist
+ */
+inline bool ParseObj( const char* data, size_t size,
+                      Vector3Streams& positions,
+                      std::vector< unsigned int >& faceIndices )
+{
+  using namespace ObjLoaderDetail;
+
+  const char* p = data;
+  const char* end = data + size;
+  while( p < end )
+  {
+    const char* lineEnd = static_cast< const char* >( memchr( p, '\n', end - p ) );
+    if( !lineEnd )
+    {
+      lineEnd = end;
+    }
+
+    if( lineEnd - p > 1 && p[0] == 'v' && IsBlank( p[1] ) )
+    {
+      Dali::Vector3 position;
+      const char* q = p + 2;
+      for( unsigned int i = 0; i < 3u; ++i )
+      {
+        q = ParseFloat( SkipBlanks( q, lineEnd ), lineEnd, position[i] );
+      }
+
+      positions.PushBack( position.x, position.y, position.z );
+    }
+    else if( lineEnd - p > 1 && p[0] == 'f' && IsBlank( p[1] ) )
+    {
+      unsigned int triangle[3];
+      const char* q = p + 2;
+      for( unsigned int i = 0; i < 3u; ++i )
+      {
+        long index = 0;
+        const char* start = SkipBlanks( q, lineEnd );
+        const char* next = ParseInteger( start, lineEnd, index );
+        if( next == start || index == 0 )
+        {
+          return false;
+        }
+
+        index = index > 0 ? index - 1 : static_cast< long >( positions.Size() ) + index;
+        if( index < 0 || static_cast< size_t >( index ) >= positions.Size() )
+        {
+          return false;
+        }
+        triangle[i] = index;
+
+        // Skip the texture coordinate and normal indices
+        q = next;
+        while( q < lineEnd && !IsBlank( *q ) )
+        {
+          ++q;
+        }
+      }
+      faceIndices.insert( faceIndices.end(), triangle, triangle + 3 );
+    }
+
+    p = lineEnd + 1;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Hashes data with 64 bit FNV-1a, ie to tell whether a cache built from a file is still valid.
+ */
+inline uint64_t HashData( const char* data, size_t size, uint64_t hash = 14695981039346656037ull )
+{
+  for( const char* end = data + size; data < end; ++data )
+  {
+    hash = ( hash ^ static_cast< unsigned char >( *data ) ) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Retrieves the directory the demos can keep caches in, creating it if need be.
+ * @return The directory with a trailing slash
+ */
+inline std::string GetCacheDirectory()
+{
+  std::string directory;
+  if( const char* cacheHome = getenv( "XDG_CACHE_HOME" ) )
+  {
+    directory = cacheHome;
+  }
+  else if( const char* home = getenv( "HOME" ) )
+  {
+    directory = std::string( home ) + "/.cache";
+  }
+
+  if( !directory.empty() )
+  {
+    mkdir( directory.c_str(), 0700 );
+    directory += "/dali-demo";
+    if( 0 == mkdir( directory.c_str(), 0700 ) || errno == EEXIST )
+    {
+      return directory + "/";
+    }
+  }
+  return "/tmp/";
+}
+
+/**
+ * The header of a binary cache file written by WriteBinaryCache().
+ */
+struct BinaryCacheHeader
+{
+  char     magic[4];
+  uint32_t elementSize;
+  uint64_t key;
+  uint64_t elementCount;
+};
+
+const char BINARY_CACHE_MAGIC[4] = { 'D', 'D', 'B', 'C' };
+
+/**
+ * @brief Reads an array of plain structures from a cache file written by WriteBinaryCache().
+ * @param[in] path The cache file
+ * @param[in] key The key the cache must have been written with, ie the hash of its source
+ * @param[out] elements The elements read
+ * @return false if there is no cache or it was written with another key or element type
+ */
+template< typename T >
+bool ReadBinaryCache( const std::string& path, uint64_t key, std::vector< T >& elements )
+{
+  MappedFile file;
+  if( !file.Open( path ) || file.GetSize() < sizeof( BinaryCacheHeader ) )
+  {
+    return false;
+  }
+
+  BinaryCacheHeader header;
+  memcpy( &header, file.GetData(), sizeof( header ) );
+  if( memcmp( header.magic, BINARY_CACHE_MAGIC, sizeof( header.magic ) ) != 0 ||
+      header.elementSize != sizeof( T ) ||
+      header.key != key ||
+      header.elementCount != ( file.GetSize() - sizeof( header ) ) / sizeof( T ) )
+  {
+    return false;
+  }
+
+  elements.resize( header.elementCount );
+  if( header.elementCount )
+  {
+    memcpy( &elements[0], file.GetData() + sizeof( header ), header.elementCount * sizeof( T ) );
+  }
+  return true;
+}
+
+/**
+ * @brief Writes an array of plain structures to a cache file. The file is replaced atomically.
+ * @return false if the file cannot be written
+ */
+template< typename T >
+bool WriteBinaryCache( const std::string& path, uint64_t key, const std::vector< T >& elements )
+{
+  BinaryCacheHeader header;
+  memcpy( header.magic, BINARY_CACHE_MAGIC, sizeof( header.magic ) );
+  header.elementSize = sizeof( T );
+  header.key = key;
+  header.elementCount = elements.size();
+
+  const std::string temporaryPath = path + ".tmp";
+  FILE* file = fopen( temporaryPath.c_str(), "wb" );
+  if( !file )
+  {
+    return false;
+  }
+
+  bool written = fwrite( &header, sizeof( header ), 1, file ) == 1 &&
+                 ( elements.empty() || fwrite( &elements[0], sizeof( T ), elements.size(), file ) == elements.size() );
+  written = ( fclose( file ) == 0 ) && written;
+
+  if( !written || rename( temporaryPath.c_str(), path.c_str() ) != 0 )
+  {
+    unlink( temporaryPath.c_str() );
+    return false;
+  }
+  return true;
+}
+
+} // DemoHelper
+
+#endif // DALI_DEMO_OBJ_LOADER_H
@@ -0,0 +1,152 @@
+#ifndef DALI_DEMO_PROGRESSIVE_IMAGE_LOADER_H
+#define DALI_DEMO_PROGRESSIVE_IMAGE_LOADER_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <dali/dali.h>
+#include <dali/devel-api/adaptor-framework/bitmap-loader.h>
+#include "shared/utility.h"
+#include "shared/worker-pool.h"
+
+namespace DemoHelper
+{
+
+/**
+ * @brief Loads an image in two passes so that something meaningful is on screen straight away.
+ *
+ * Load() decodes a small thumbnail synchronously and returns it. The image is requested at
+ * a fraction of the final size, so the JPEG decoder uses DCT scaling and only decodes a
+ * fraction of the coefficients; the cost is bounded however large the source file is.
+ * The full resolution image is then decoded on a worker thread and delivered through
+ * ImageLoadedSignal() on the event thread, where it can replace the thumbnail.
+ */
+class ProgressiveImageLoader
+{
+public:
+
+  /**
+   * @brief Signal type for the full resolution image, passes the id returned by Load() and the decoded pixels.
+   */
+  typedef Dali::Signal< void ( unsigned int, Dali::PixelData ) > ImageLoadedSignalType;
+
+  /**
+   * The thumbnail is decoded at 1/THUMBNAIL_SCALE_DOWN of the requested size.
+   * Eight matches the largest JPEG DCT scaling factor.
+   */
+  static const unsigned int THUMBNAIL_SCALE_DOWN = 8u;
+
+  ProgressiveImageLoader()
+  : mWorkerPool( 1u ),
+    mLoadCounter( 0u )
+  {
+  }
+
+  /**
+   * @brief Decodes the thumbnail of an image and queues the decode of the image itself.
+   *
+   * @param[in] imagePath The path of the image file
+   * @param[in] size The size of the full resolution image
+   * @param[in] fittingMode The fitting mode of the full resolution image
+   * @param[in] samplingMode The sampling mode of the full resolution image
+   * @param[out] loadId The id which will be passed to ImageLoadedSignal() with the full resolution image
+   * @return The thumbnail
+   */
+  Dali::PixelData Load( const char* imagePath,
+                        Dali::ImageDimensions size,
+                        Dali::FittingMode::Type fittingMode,
+                        Dali::SamplingMode::Type samplingMode,
+                        unsigned int& loadId )
+  {
+    Dali::ImageDimensions thumbnailSize( std::max( size.GetWidth() / THUMBNAIL_SCALE_DOWN, 1u ),
+                                         std::max( size.GetHeight() / THUMBNAIL_SCALE_DOWN, 1u ) );
+    Dali::PixelData thumbnail = LoadPixelData( imagePath, thumbnailSize, fittingMode, Dali::SamplingMode::BOX );
+
+    loadId = ++mLoadCounter;
+    mWorkerPool.AddTask( new LoadTask( *this, loadId, Dali::BitmapLoader::New( imagePath, size, fittingMode, samplingMode ) ) );
+
+    return thumbnail;
+  }
+
+  /**
+   * @brief As Load(), scaling the image to fill the stage like LoadStageFillingImage().
+   */
+  Dali::PixelData LoadStageFilling( const char* imagePath, unsigned int& loadId )
+  {
+    Dali::Vector2 stageSize = Dali::Stage::GetCurrent().GetSize();
+    return Load( imagePath, Dali::ImageDimensions( stageSize.x, stageSize.y ), Dali::FittingMode::SCALE_TO_FILL, Dali::SamplingMode::BOX_THEN_LINEAR, loadId );
+  }
+
+  /**
+   * @brief Drops every full resolution image which has not been delivered yet.
+   */
+  void Cancel()
+  {
+    mWorkerPool.CancelTasks();
+  }
+
+  /**
+   * @brief Emitted on the event thread when a full resolution image has been decoded.
+   */
+  ImageLoadedSignalType& ImageLoadedSignal()
+  {
+    return mImageLoadedSignal;
+  }
+
+private:
+
+  /**
+   * Decodes the full resolution image on the worker thread.
+   */
+  class LoadTask : public WorkerTask
+  {
+  public:
+
+    LoadTask( ProgressiveImageLoader& loader, unsigned int loadId, Dali::BitmapLoader bitmapLoader )
+    : mLoader( loader ),
+      mBitmapLoader( bitmapLoader ),
+      mLoadId( loadId )
+    {
+    }
+
+    virtual void Process()
+    {
+      mBitmapLoader.Load();
+    }
+
+    virtual void Complete()
+    {
+      mLoader.mImageLoadedSignal.Emit( mLoadId, mBitmapLoader.GetPixelData() );
+    }
+
+  private:
+
+    ProgressiveImageLoader& mLoader;
+    Dali::BitmapLoader      mBitmapLoader;
+    unsigned int            mLoadId;
+  };
+
+private:
+
+  ImageLoadedSignalType mImageLoadedSignal;
+  WorkerPool            mWorkerPool;
+  unsigned int          mLoadCounter;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_PROGRESSIVE_IMAGE_LOADER_H
@@ -0,0 +1,112 @@
+#ifndef DALI_DEMO_QUALITY_GOVERNOR_H
+#define DALI_DEMO_QUALITY_GOVERNOR_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <algorithm>
+
+// INTERNAL INCLUDES
+#include "shared/frame-time-monitor.h"
+
+namespace DemoHelper
+{
+
+const float QUALITY_GOVERNOR_SLOW_RATIO = 0.1f;              ///< The fraction of slow frames above which the quality is lowered
+const unsigned int QUALITY_GOVERNOR_STABLE_INTERVALS = 3u;   ///< The intervals without slow frames before the quality is raised
+const unsigned int QUALITY_GOVERNOR_MAX_STABLE_INTERVALS = 48u;
+const unsigned int QUALITY_GOVERNOR_MIN_FRAMES = 10u;        ///< Intervals with fewer frames are ignored, e.g. when idle
+
+/**
+ * @brief Picks a quality level from the frame times measured by a FrameTimeMonitor.
+ *
+ * Level 0 is the highest quality. The level is lowered as soon as an interval has too many slow frames, and
+ * raised again after QUALITY_GOVERNOR_STABLE_INTERVALS intervals without any. When a level that was just
+ * raised to turns out to be too slow, the wait before the next raise doubles, so the level settles rather
+ * than oscillating.
+ */
+class QualityGovernor
+{
+public:
+
+  /**
+   * @param[in] levelCount The number of quality levels
+   * @param[in] initialLevel The level to start at
+   */
+  QualityGovernor( unsigned int levelCount, unsigned int initialLevel = 0u )
+  : mLevelCount( std::max( levelCount, 1u ) ),
+    mLevel( std::min( initialLevel, mLevelCount - 1u ) ),
+    mStableIntervals( 0u ),
+    mRequiredStableIntervals( QUALITY_GOVERNOR_STABLE_INTERVALS ),
+    mJustRaised( false )
+  {
+  }
+
+  unsigned int GetLevel() const
+  {
+    return mLevel;
+  }
+
+  /**
+   * @brief Updates the level with the statistics of the last interval.
+   * @return Whether the level has changed
+   */
+  bool Update( const FrameTimeMonitor::Statistics& statistics )
+  {
+    if( statistics.frames < QUALITY_GOVERNOR_MIN_FRAMES )
+    {
+      return false;
+    }
+
+    const unsigned int previousLevel = mLevel;
+    if( statistics.slowFrames > statistics.frames * QUALITY_GOVERNOR_SLOW_RATIO )
+    {
+      if( mJustRaised )
+      {
+        mRequiredStableIntervals = std::min( mRequiredStableIntervals * 2u, QUALITY_GOVERNOR_MAX_STABLE_INTERVALS );
+      }
+      mLevel = std::min( mLevel + 1u, mLevelCount - 1u );
+      mStableIntervals = 0u;
+      mJustRaised = false;
+    }
+    else if( statistics.slowFrames == 0u && mLevel > 0u && ++mStableIntervals >= mRequiredStableIntervals )
+    {
+      --mLevel;
+      mStableIntervals = 0u;
+      mJustRaised = true;
+    }
+    else
+    {
+      mJustRaised = false;
+    }
+
+    return mLevel != previousLevel;
+  }
+
+private:
+
+  unsigned int mLevelCount;
+  unsigned int mLevel;
+  unsigned int mStableIntervals;
+  unsigned int mRequiredStableIntervals;
+  bool         mJustRaised;      ///< Whether the last interval raised the level
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_QUALITY_GOVERNOR_H
@@ -0,0 +1,185 @@
+#ifndef DALI_DEMO_SLIDE_PREFETCHER_H
+#define DALI_DEMO_SLIDE_PREFETCHER_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <map>
+#include <dali/dali.h>
+#include <dali/devel-api/adaptor-framework/bitmap-loader.h>
+
+// INTERNAL INCLUDES
+#include "shared/worker-pool.h"
+
+namespace DemoHelper
+{
+
+/**
+ * @brief Keeps the slides either side of the one on show decoded and uploaded, so that a transition
+ * to the next or previous slide can start without decoding anything.
+ *
+ * SetCurrent() queues the decode of the neighbours of the slide on show on a worker thread; each is
+ * uploaded with the create function as soon as it has been decoded. Slides further away are dropped.
+ * Resource is the type the create function returns, e.g. Dali::Texture with CreateTexture().
+ */
+template< typename Resource >
+class SlidePrefetcher
+{
+public:
+
+  typedef Resource (*CreateFunction)( Dali::PixelData pixelData );
+
+  /**
+   * @param[in] imagePaths The image of each slide
+   * @param[in] count The number of slides
+   * @param[in] size The size the slides are decoded at
+   * @param[in] fittingMode The fitting mode the slides are decoded with
+   * @param[in] samplingMode The sampling mode the slides are decoded with
+   * @param[in] create Uploads a decoded slide
+   */
+  SlidePrefetcher( const char* const* imagePaths,
+                   unsigned int count,
+                   Dali::ImageDimensions size,
+                   Dali::FittingMode::Type fittingMode,
+                   Dali::SamplingMode::Type samplingMode,
+                   CreateFunction create )
+  : mWorkerPool( 1u ),
+    mImagePaths( imagePaths ),
+    mCount( count ),
+    mSize( size ),
+    mFittingMode( fittingMode ),
+    mSamplingMode( samplingMode ),
+    mCreate( create )
+  {
+  }
+
+  /**
+   * @brief Sets the slide on show; its neighbours are prefetched and the other slides are dropped.
+   */
+  void SetCurrent( unsigned int index )
+  {
+    const unsigned int next = ( index + 1u ) % mCount;
+    const unsigned int previous = ( index + mCount - 1u ) % mCount;
+
+    for( typename std::map< unsigned int, Resource >::iterator iter = mSlides.begin(); iter != mSlides.end(); )
+    {
+      if( iter->first != index && iter->first != next && iter->first != previous )
+      {
+        mSlides.erase( iter++ );
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+
+    for( std::map< unsigned int, WorkerTaskPtr >::iterator iter = mPendingSlides.begin(); iter != mPendingSlides.end(); )
+    {
+      if( iter->first != index && iter->first != next && iter->first != previous )
+      {
+        iter->second->Cancel();
+        mPendingSlides.erase( iter++ );
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+
+    Prefetch( next );
+    Prefetch( previous );
+  }
+
+  /**
+   * @brief Retrieves a slide if it has been prefetched.
+   * @return The slide, or an empty handle if it is not ready yet
+   */
+  Resource Get( unsigned int index ) const
+  {
+    typename std::map< unsigned int, Resource >::const_iterator iter = mSlides.find( index );
+    return iter != mSlides.end() ? iter->second : Resource();
+  }
+
+private:
+
+  void Prefetch( unsigned int index )
+  {
+    if( mSlides.find( index ) == mSlides.end() && mPendingSlides.find( index ) == mPendingSlides.end() )
+    {
+      WorkerTaskPtr task( new DecodeTask( *this, index, Dali::BitmapLoader::New( mImagePaths[index], mSize, mFittingMode, mSamplingMode ) ) );
+      mPendingSlides[index] = task;
+      mWorkerPool.AddTask( task );
+    }
+  }
+
+  void OnSlideDecoded( unsigned int index, Dali::PixelData pixelData )
+  {
+    mPendingSlides.erase( index );
+    if( pixelData )
+    {
+      mSlides[index] = mCreate( pixelData );
+    }
+  }
+
+  /**
+   * Decodes a slide on the worker thread.
+   */
+  class DecodeTask : public WorkerTask
+  {
+  public:
+
+    DecodeTask( SlidePrefetcher& prefetcher, unsigned int index, Dali::BitmapLoader bitmapLoader )
+    : mPrefetcher( prefetcher ),
+      mBitmapLoader( bitmapLoader ),
+      mIndex( index )
+    {
+    }
+
+    virtual void Process()
+    {
+      mBitmapLoader.Load();
+    }
+
+    virtual void Complete()
+    {
+      mPrefetcher.OnSlideDecoded( mIndex, mBitmapLoader.GetPixelData() );
+    }
+
+  private:
+
+    SlidePrefetcher&   mPrefetcher;
+    Dali::BitmapLoader mBitmapLoader;
+    unsigned int       mIndex;
+  };
+
+private:
+
+  std::map< unsigned int, Resource >      mSlides;          ///< The uploaded slides, at most the one on show and its neighbours
+  std::map< unsigned int, WorkerTaskPtr > mPendingSlides;   ///< The slides being decoded
+  WorkerPool                              mWorkerPool;
+  const char* const*                      mImagePaths;
+  unsigned int                            mCount;
+  Dali::ImageDimensions                   mSize;
+  Dali::FittingMode::Type                 mFittingMode;
+  Dali::SamplingMode::Type                mSamplingMode;
+  CreateFunction                          mCreate;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_SLIDE_PREFETCHER_H
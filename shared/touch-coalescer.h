@@ -0,0 +1,206 @@
+#ifndef DALI_DEMO_TOUCH_COALESCER_H
+#define DALI_DEMO_TOUCH_COALESCER_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <algorithm>
+#include <vector>
+#include <dali/dali.h>
+
+namespace DemoHelper
+{
+
+const unsigned int TOUCH_COALESCER_INTERVAL = 16u;     ///< The display frame interval, in milliseconds
+const unsigned int TOUCH_COALESCER_MAX_POINTS = 4u;    ///< The default number of points a batch is resampled to
+
+/**
+ * @brief Batches the motion samples of a touch, so that expensive work is done at most once per frame
+ * however fast the touch panel reports.
+ *
+ * The first sample after a quiet period is dispatched straight away, so a new drag has no added latency.
+ * Samples that arrive within the next frame interval are held and dispatched together when it ends. A batch
+ * with more than the maximum number of points is resampled to that many points, evenly spaced along the
+ * path, the last always being the latest sample.
+ */
+class TouchCoalescer : public Dali::ConnectionTracker
+{
+public:
+
+  typedef std::vector< Dali::Vector2 > Points;
+  typedef Dali::Signal< void ( const Points& ) > MotionSignalType;
+
+  /**
+   * @param[in] maxPoints The maximum number of points in a dispatched batch
+   * @param[in] interval The interval between dispatches, in milliseconds
+   */
+  TouchCoalescer( unsigned int maxPoints = TOUCH_COALESCER_MAX_POINTS, unsigned int interval = TOUCH_COALESCER_INTERVAL )
+  : mMaxPoints( std::max( maxPoints, 1u ) ),
+    mInterval( interval ),
+    mSampleCount( 0u ),
+    mDispatchCount( 0u )
+  {
+  }
+
+  /**
+   * @brief Emitted with the points of the path since the last dispatch, in order.
+   */
+  MotionSignalType& MotionSignal()
+  {
+    return mMotionSignal;
+  }
+
+  /**
+   * @brief Starts a new path at position, e.g. when the touch goes down; nothing is dispatched.
+   */
+  void Reset( const Dali::Vector2& position )
+  {
+    StopTimer();
+    mSamples.clear();
+    mLastPosition = position;
+  }
+
+  /**
+   * @brief Adds a motion sample.
+   */
+  void AddSample( const Dali::Vector2& position )
+  {
+    ++mSampleCount;
+    mSamples.push_back( position );
+    if( !mTimer )
+    {
+      // Created on first use, as the examples construct their members before the adaptor exists
+      mTimer = Dali::Timer::New( mInterval );
+      mTimer.TickSignal().Connect( this, &TouchCoalescer::OnTick );
+    }
+    if( !mTimer.IsRunning() )
+    {
+      Dispatch();
+      mTimer.Start();
+    }
+  }
+
+  /**
+   * @brief Dispatches any held samples straight away, e.g. before the touch goes up.
+   */
+  void Flush()
+  {
+    StopTimer();
+    Dispatch();
+  }
+
+  /**
+   * @brief The number of samples added so far.
+   */
+  unsigned int GetSampleCount() const
+  {
+    return mSampleCount;
+  }
+
+  /**
+   * @brief The number of batches dispatched so far.
+   */
+  unsigned int GetDispatchCount() const
+  {
+    return mDispatchCount;
+  }
+
+private:
+
+  void StopTimer()
+  {
+    if( mTimer )
+    {
+      mTimer.Stop();
+    }
+  }
+
+  bool OnTick()
+  {
+    // Keep ticking while the samples keep coming; the next one after a quiet frame is dispatched straight away
+    return Dispatch();
+  }
+
+  bool Dispatch()
+  {
+    if( mSamples.empty() )
+    {
+      return false;
+    }
+
+    Points points;
+    Resample( points );
+    mLastPosition = mSamples.back();
+    mSamples.clear();
+
+    ++mDispatchCount;
+    mMotionSignal.Emit( points );
+    return true;
+  }
+
+  /**
+   * Spaces mMaxPoints points evenly along the path from mLastPosition through the samples.
+   */
+  void Resample( Points& points ) const
+  {
+    if( mSamples.size() <= mMaxPoints )
+    {
+      points = mSamples;
+      return;
+    }
+
+    float length = ( mSamples[0] - mLastPosition ).Length();
+    for( unsigned int i = 1u; i < mSamples.size(); ++i )
+    {
+      length += ( mSamples[i] - mSamples[i - 1u] ).Length();
+    }
+
+    Dali::Vector2 start = mLastPosition;
+    float startDistance = 0.0f;
+    unsigned int sample = 0u;
+    for( unsigned int i = 1u; i < mMaxPoints; ++i )
+    {
+      const float distance = length * i / mMaxPoints;
+      float segment = ( mSamples[sample] - start ).Length();
+      while( startDistance + segment < distance && sample + 1u < mSamples.size() )
+      {
+        startDistance += segment;
+        start = mSamples[sample++];
+        segment = ( mSamples[sample] - start ).Length();
+      }
+      const float t = segment > 0.0f ? std::min( ( distance - startDistance ) / segment, 1.0f ) : 1.0f;
+      points.push_back( start + ( mSamples[sample] - start ) * t );
+    }
+    points.push_back( mSamples.back() );
+  }
+
+private:
+
+  MotionSignalType mMotionSignal;
+  Dali::Timer      mTimer;
+  Points           mSamples;          ///< The samples held since the last dispatch
+  Dali::Vector2    mLastPosition;     ///< The last point dispatched, where the held path starts
+  unsigned int     mMaxPoints;
+  unsigned int     mInterval;
+  unsigned int     mSampleCount;
+  unsigned int     mDispatchCount;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_TOUCH_COALESCER_H
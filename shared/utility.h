@@ -18,6 +18,7 @@
  *
  */
 
+#include <time.h>
 #include <dali/dali.h>
 #include <dali/devel-api/images/atlas.h>
 #include <dali/devel-api/adaptor-framework/bitmap-loader.h>
@@ -27,6 +28,16 @@
 namespace DemoHelper
 {
 
+/**
+ * @brief Returns the time on the monotonic clock, in milliseconds.
+ */
+double GetMilliseconds()
+{
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
 Dali::PixelData LoadPixelData( const char* imagePath,
                                Dali::ImageDimensions size,
                                Dali::FittingMode::Type fittingMode,
@@ -38,16 +49,38 @@ Dali::PixelData LoadPixelData( const char* imagePath,
 }
 
 
+/**
+ * @brief Uploads already decoded pixels to a new image.
+ */
+Dali::Atlas CreateImage( Dali::PixelData pixelData )
+{
+  Dali::Atlas image = Dali::Atlas::New( pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetPixelFormat() );
+  image.Upload( pixelData, 0u, 0u );
+
+  return image;
+}
+
+/**
+ * @brief Uploads already decoded pixels to a new texture.
+ */
+Dali::Texture CreateTexture( Dali::PixelData pixelData )
+{
+  Dali::Texture texture = Dali::Texture::New( Dali::TextureType::TEXTURE_2D,
+                                              pixelData.GetPixelFormat(),
+                                              pixelData.GetWidth(),
+                                              pixelData.GetHeight() );
+  texture.Upload( pixelData );
+
+  return texture;
+}
+
 Dali::Atlas LoadImage( const char* imagePath,
                        Dali::ImageDimensions size = Dali::ImageDimensions(),
                        Dali::FittingMode::Type fittingMode = Dali::FittingMode::DEFAULT,
                        Dali::SamplingMode::Type samplingMode = Dali::SamplingMode::DEFAULT )
 {
   Dali::PixelData pixelData = LoadPixelData(imagePath, size, fittingMode, samplingMode);
-  Dali::Atlas image  =Dali:: Atlas::New( pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetPixelFormat() );
-  image.Upload( pixelData, 0u, 0u );
-
-  return image;
+  return CreateImage( pixelData );
 }
 
 Dali::Texture LoadTexture( const char* imagePath,
@@ -56,13 +89,7 @@ Dali::Texture LoadTexture( const char* imagePath,
                            Dali::SamplingMode::Type samplingMode = Dali::SamplingMode::DEFAULT )
 {
   Dali::PixelData pixelData = LoadPixelData(imagePath, size, fittingMode, samplingMode);
-  Dali::Texture texture  = Dali::Texture::New( Dali::TextureType::TEXTURE_2D,
-                                               pixelData.GetPixelFormat(),
-                                               pixelData.GetWidth(),
-                                               pixelData.GetHeight() );
-  texture.Upload( pixelData );
-
-  return texture;
+  return CreateTexture( pixelData );
 }
 
 /**
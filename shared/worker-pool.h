@@ -0,0 +1,308 @@
+#ifndef DALI_DEMO_WORKER_POOL_H
+#define DALI_DEMO_WORKER_POOL_H
+
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// EXTERNAL INCLUDES
+#include <pthread.h>
+#include <unistd.h>
+#include <deque>
+#include <vector>
+#include <dali/dali.h>
+#include <dali/devel-api/adaptor-framework/event-thread-callback.h>
+#include <dali/devel-api/threading/conditional-wait.h>
+#include <dali/devel-api/threading/mutex.h>
+
+namespace DemoHelper
+{
+
+/**
+ * @brief A unit of work to be run by a WorkerPool.
+ *
+ * Process() is called on a worker thread, so it must not touch the stage or any
+ * handle which is also used by the event thread.
+ * Complete() is called afterwards on the event thread, where the result can be used.
+ */
+class WorkerTask : public Dali::RefObject
+{
+public:
+
+  WorkerTask()
+  : mCancelled( false )
+  {
+  }
+
+  /**
+   * @brief Does the work. Called on a worker thread.
+   */
+  virtual void Process() = 0;
+
+  /**
+   * @brief Hands the result over. Called on the event thread once Process() has returned.
+   */
+  virtual void Complete() = 0;
+
+  /**
+   * @brief Cancels the task. A cancelled task is neither processed (if it has not started yet) nor completed.
+   *
+   * May be called from any thread, e.g. by Process() to check whether it can stop early.
+   */
+  void Cancel()
+  {
+    Dali::Mutex::ScopedLock lock( mCancelledMutex );
+    mCancelled = true;
+  }
+
+  bool IsCancelled() const
+  {
+    Dali::Mutex::ScopedLock lock( mCancelledMutex );
+    return mCancelled;
+  }
+
+protected:
+
+  virtual ~WorkerTask()
+  {
+  }
+
+private:
+
+  mutable Dali::Mutex mCancelledMutex;
+  bool                mCancelled;       ///< Guarded by mCancelledMutex
+};
+
+typedef Dali::IntrusivePtr< WorkerTask > WorkerTaskPtr;
+
+/**
+ * @brief Runs WorkerTasks on a fixed number of threads and completes them on the event thread.
+ *
+ * Must be created after the application has been initialised, as the completion
+ * notification is delivered through the adaptor's main loop.
+ */
+class WorkerPool
+{
+public:
+
+  /**
+   * @brief Starts the worker threads.
+   * @param[in] numberOfThreads The number of worker threads, zero means one per online CPU.
+   */
+  WorkerPool( unsigned int numberOfThreads = 1u )
+  : mTrigger( new Dali::EventThreadCallback( Dali::MakeCallback( this, &WorkerPool::OnTasksCompleted ) ) ),
+    mStopping( false )
+  {
+    if( numberOfThreads == 0u )
+    {
+      numberOfThreads = GetCpuCount();
+    }
+
+    for( unsigned int i = 0u; i < numberOfThreads; ++i )
+    {
+      pthread_t thread;
+      if( pthread_create( &thread, NULL, &WorkerPool::Run, this ) == 0 )
+      {
+        mThreads.push_back( thread );
+      }
+    }
+  }
+
+  /**
+   * @brief Stops and joins the worker threads. Tasks which have not been completed yet are dropped.
+   */
+  ~WorkerPool()
+  {
+    {
+      Dali::ConditionalWait::ScopedLock lock( mConditionalWait );
+      mStopping = true;
+      mWaitingTasks.clear();
+      mConditionalWait.Notify( lock );
+    }
+
+    for( std::vector< pthread_t >::iterator iter = mThreads.begin(); iter != mThreads.end(); ++iter )
+    {
+      pthread_join( *iter, NULL );
+    }
+
+    delete mTrigger;
+  }
+
+  /**
+   * @brief Queues a task.
+   * @param[in] task The task to run
+   * @param[in] urgent If true, the task is run before any other waiting task
+   */
+  void AddTask( WorkerTaskPtr task, bool urgent = false )
+  {
+    Dali::ConditionalWait::ScopedLock lock( mConditionalWait );
+    if( urgent )
+    {
+      mWaitingTasks.push_front( task );
+    }
+    else
+    {
+      mWaitingTasks.push_back( task );
+    }
+    mConditionalWait.Notify( lock );
+  }
+
+  /**
+   * @brief Cancels every task which is waiting, running or awaiting completion.
+   */
+  void CancelTasks()
+  {
+    {
+      Dali::ConditionalWait::ScopedLock lock( mConditionalWait );
+      for( std::deque< WorkerTaskPtr >::iterator iter = mWaitingTasks.begin(); iter != mWaitingTasks.end(); ++iter )
+      {
+        (*iter)->Cancel();
+      }
+      mWaitingTasks.clear();
+    }
+
+    Dali::Mutex::ScopedLock lock( mMutex );
+    for( std::vector< WorkerTaskPtr >::iterator iter = mRunningTasks.begin(); iter != mRunningTasks.end(); ++iter )
+    {
+      (*iter)->Cancel();
+    }
+    for( std::vector< WorkerTaskPtr >::iterator iter = mCompletedTasks.begin(); iter != mCompletedTasks.end(); ++iter )
+    {
+      (*iter)->Cancel();
+    }
+  }
+
+  /**
+   * @brief Retrieves the number of tasks which have been added but not completed yet.
+   */
+  unsigned int GetPendingTaskCount()
+  {
+    unsigned int count( 0u );
+    {
+      Dali::ConditionalWait::ScopedLock lock( mConditionalWait );
+      count = mWaitingTasks.size();
+    }
+    Dali::Mutex::ScopedLock lock( mMutex );
+    return count + mRunningTasks.size() + mCompletedTasks.size();
+  }
+
+  unsigned int GetThreadCount() const
+  {
+    return mThreads.size();
+  }
+
+  /**
+   * @brief Retrieves the number of online CPUs, at least one.
+   */
+  static unsigned int GetCpuCount()
+  {
+    long count = sysconf( _SC_NPROCESSORS_ONLN );
+    return count > 0 ? static_cast< unsigned int >( count ) : 1u;
+  }
+
+private:
+
+  static void* Run( void* data )
+  {
+    static_cast< WorkerPool* >( data )->ProcessTasks();
+    return NULL;
+  }
+
+  /**
+   * Worker thread loop: waits for a task, processes it and notifies the event thread.
+   */
+  void ProcessTasks()
+  {
+    for( ;; )
+    {
+      WorkerTaskPtr task;
+      {
+        Dali::ConditionalWait::ScopedLock lock( mConditionalWait );
+        while( !mStopping && mWaitingTasks.empty() )
+        {
+          mConditionalWait.Wait( lock );
+        }
+        if( mStopping )
+        {
+          break;
+        }
+        task = mWaitingTasks.front();
+        mWaitingTasks.pop_front();
+
+        Dali::Mutex::ScopedLock runningLock( mMutex );
+        mRunningTasks.push_back( task );
+      }
+
+      if( !task->IsCancelled() )
+      {
+        task->Process();
+      }
+
+      {
+        Dali::Mutex::ScopedLock lock( mMutex );
+        for( std::vector< WorkerTaskPtr >::iterator iter = mRunningTasks.begin(); iter != mRunningTasks.end(); ++iter )
+        {
+          if( *iter == task )
+          {
+            mRunningTasks.erase( iter );
+            break;
+          }
+        }
+        mCompletedTasks.push_back( task );
+
+        // The event thread may complete and release the task as soon as the lock is released; the last reference,
+        // and with it any DALi handles the task holds, must not be dropped on this thread
+        task.Reset();
+      }
+      mTrigger->Trigger();
+    }
+  }
+
+  /**
+   * Called on the event thread when one or more tasks have been processed.
+   */
+  void OnTasksCompleted()
+  {
+    std::vector< WorkerTaskPtr > completedTasks;
+    {
+      Dali::Mutex::ScopedLock lock( mMutex );
+      completedTasks.swap( mCompletedTasks );
+    }
+
+    for( std::vector< WorkerTaskPtr >::iterator iter = completedTasks.begin(); iter != completedTasks.end(); ++iter )
+    {
+      if( !(*iter)->IsCancelled() )
+      {
+        (*iter)->Complete();
+      }
+    }
+  }
+
+private:
+
+  std::vector< pthread_t >        mThreads;
+  std::deque< WorkerTaskPtr >     mWaitingTasks;    ///< Guarded by mConditionalWait
+  std::vector< WorkerTaskPtr >    mRunningTasks;    ///< Guarded by mMutex
+  std::vector< WorkerTaskPtr >    mCompletedTasks;  ///< Guarded by mMutex
+  Dali::ConditionalWait           mConditionalWait;
+  Dali::Mutex                     mMutex;
+  Dali::EventThreadCallback*      mTrigger;
+  bool                            mStopping;
+};
+
+} // DemoHelper
+
+#endif // DALI_DEMO_WORKER_POOL_H